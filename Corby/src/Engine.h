@@ -6,6 +6,7 @@
 #include "Engine/Core/Application.h"
 #include "Engine/Core/Assert.h"
 #include "Engine/Core/Input.h"
+#include "Engine/Core/JobSystem.h"
 #include "Engine/Core/KeyCodes.h"
 #include "Engine/Core/Layer.h"
 #include "Engine/Core/Log.h"
@@ -29,8 +30,13 @@
 #include "Engine/Renderer/VertexArray.h"
 
 // Scene
+#include "Engine/Scene/ComponentReflection.h"
 #include "Engine/Scene/Components.h"
 #include "Engine/Scene/Entity.h"
+#include "Engine/Scene/EntityCommandBuffer.h"
+#include "Engine/Scene/Prefab.h"
 #include "Engine/Scene/Scene.h"
 #include "Engine/Scene/SceneCamera.h"
 #include "Engine/Scene/ScriptableEntity.h"
+#include "Engine/Scene/ScriptSystem.h"
+#include "Engine/Scene/UndoHistory.h"
@@ -2,8 +2,11 @@
 #include "Application.h"
 
 #include "Engine/Core/Input.h"
+#include "Engine/Core/JobSystem.h"
 #include "Engine/Core/Log.h"
 #include "Engine/Renderer/Renderer.h"
+#include "Engine/Renderer/RenderThread.h"
+#include "Engine/Scene/Prefab.h"
 
 #include <glfw/glfw3.h>
 
@@ -20,11 +23,12 @@ namespace Engine
 		ENG_CORE_ASSERT(!s_instance, "Application already exists!");
 		s_instance = this;
 
-		// Create window and bind event callback
+		// Create window and bind event callback, events are queued so a burst of mouse moves is dispatched once
 		m_window = Scope<Window>(Window::Create(WindowProps(name)));
-		m_window->SetEventCallback(ENG_BIND_EVENT_FN(Application::OnEvent));
+		m_window->SetEventCallback(ENG_BIND_EVENT_FN(Application::QueueEvent));
 
-		Renderer::Init();
+		JobSystem::Init();
+		Renderer::Init(m_window->GetContext());
 
 		// Create imGui layer and add it to the layerstack
 		m_imGuiLayer = new ImGuiLayer();
@@ -35,7 +39,9 @@ namespace Engine
 	{
 		ENG_PROFILE_FUNCTION();
 
+		Prefab::ClearCache();
 		Renderer::Shutdown();
+		JobSystem::Shutdown();
 	}
 
 
@@ -53,12 +59,17 @@ namespace Engine
 		dispatcher.Dispatch<WindowCloseEvent>(ENG_BIND_EVENT_FN(Application::OnWindowClose));
 		dispatcher.Dispatch<WindowResizeEvent>(ENG_BIND_EVENT_FN(Application::OnWindowResize));
 
-		for (auto it = m_layerStack.rbegin(); it != m_layerStack.rend(); ++it)
-		{
-			if (e.handled)
-				break;
-			(*it)->OnEvent(e);
-		}
+		DispatchToLayers(e);
+	}
+
+	void Application::DispatchToLayers(Event& e)
+	{
+		m_layerStack.DispatchEvent(e);
+	}
+
+	void Application::QueueEvent(Event& e)
+	{
+		m_eventQueue.Push(e);
 	}
 
 	void Application::PushLayer(Layer* layer)
@@ -88,6 +99,19 @@ namespace Engine
 		{
 			ENG_PROFILE_SCOPE("RunLoop");
 
+			JobSystem::BeginFrame();
+
+			// Events polled at the end of the last frame
+			{
+				ENG_PROFILE_SCOPE("Application::DispatchEvents");
+
+				m_eventQueue.Dispatch([this] (auto& e) { DispatchQueuedEvent(e); });
+			}
+
+			// Closing the window must not cost another frame
+			if (!m_running)
+				break;
+
 			float time = (float) glfwGetTime();
 			Timestep ts = time - m_lastFrameTime;
 			m_lastFrameTime = time;
@@ -128,6 +152,9 @@ namespace Engine
 			m_imGuiLayer->End();
 
 			m_window->OnUpdate();
+
+			// The render thread replays this frame while the next one is updated
+			RenderThread::EndFrame();
 		}
 	}
 
@@ -6,6 +6,7 @@
 #include "Engine/Core/Window.h"
 #include "Engine/Events/ApplicationEvent.h"
 #include "Engine/Events/Event.h"
+#include "Engine/Events/EventQueue.h"
 #include "Engine/ImGui/ImGuiLayer.h"
 
 int main(int argc, char** argv);
@@ -31,7 +32,9 @@ namespace Engine
 		virtual ~Application();
 
 		void Close();
+		// Runs the event through the layers right away, window events are queued and dispatched at the start of the frame
 		void OnEvent(Event& e);
+		void QueueEvent(Event& e);
 		void PushLayer(Layer* layer);
 		void PushOverlay(Layer* layer);
 
@@ -43,6 +46,20 @@ namespace Engine
 
 	private:
 		void Run();
+
+		// Queued events have their concrete type, the application handles its own without looking the type up
+		template<typename T>
+		void DispatchQueuedEvent(T& e)
+		{
+			if constexpr (std::is_same_v<T, WindowCloseEvent>)
+				e.handled |= OnWindowClose(e);
+			else if constexpr (std::is_same_v<T, WindowResizeEvent>)
+				e.handled |= OnWindowResize(e);
+
+			DispatchToLayers(e);
+		}
+
+		void DispatchToLayers(Event& e);
 		bool OnWindowClose(WindowCloseEvent& e);
 		bool OnWindowResize(WindowResizeEvent& e);
 
@@ -53,6 +70,7 @@ namespace Engine
 		bool m_running = true;
 		bool m_minimized = false;
 		LayerStack m_layerStack;
+		EventQueue m_eventQueue;
 		float m_lastFrameTime = 0.0f;
 
 		static Application* s_instance;
@@ -0,0 +1,48 @@
+#include "engpch.h"
+#include "InternedString.h"
+
+#include <mutex>
+
+namespace Engine
+{
+	// Nodes of an unordered_set don't move, so the pointers handed out stay valid when it grows
+	static std::unordered_set<std::string>& GetPool()
+	{
+		static std::unordered_set<std::string> s_pool;
+		return s_pool;
+	}
+
+	static std::mutex s_poolMutex;
+
+	static const std::string* Intern(const std::string& string)
+	{
+		std::lock_guard<std::mutex> lock(s_poolMutex);
+		return &*GetPool().insert(string).first;
+	}
+
+	InternedString::InternedString()
+	{
+		static const std::string* s_empty = Intern(std::string());
+		m_string = s_empty;
+	}
+
+	InternedString::InternedString(const std::string& string)
+		: m_string(Intern(string))
+	{}
+
+	InternedString::InternedString(const char* string)
+		: m_string(Intern(string))
+	{}
+
+	bool InternedString::Find(const std::string& string, InternedString& result)
+	{
+		std::lock_guard<std::mutex> lock(s_poolMutex);
+		auto& pool = GetPool();
+		auto it = pool.find(string);
+		if (it == pool.end())
+			return false;
+
+		result.m_string = &*it;
+		return true;
+	}
+}
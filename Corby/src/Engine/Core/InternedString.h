@@ -0,0 +1,45 @@
+#pragma once
+
+#include <string>
+#include <functional>
+
+namespace Engine
+{
+	// A string kept once in a global pool, equal strings share the same storage. Copies and comparisons only
+	// touch a pointer. Pooled strings live until the program exits, so this is meant for names and not for
+	// text that keeps changing.
+	class InternedString
+	{
+	public:
+		InternedString();
+		InternedString(const std::string& string);
+		InternedString(const char* string);
+
+		const std::string& Get() const { return *m_string; }
+		const char* c_str() const { return m_string->c_str(); }
+		bool empty() const { return m_string->empty(); }
+
+		operator const std::string& () const { return *m_string; }
+
+		bool operator==(const InternedString& other) const { return m_string == other.m_string; }
+		bool operator!=(const InternedString& other) const { return m_string != other.m_string; }
+
+		// Looks a string up without adding it to the pool, returns false if it was never interned
+		static bool Find(const std::string& string, InternedString& result);
+
+	private:
+		const std::string* m_string;
+	};
+}
+
+namespace std
+{
+	template<>
+	struct hash<Engine::InternedString>
+	{
+		std::size_t operator()(const Engine::InternedString& string) const
+		{
+			return hash<const std::string*>()(&string.Get());
+		}
+	};
+}
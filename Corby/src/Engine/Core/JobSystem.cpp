@@ -0,0 +1,407 @@
+#include "engpch.h"
+#include "JobSystem.h"
+
+#include <condition_variable>
+#include <deque>
+
+namespace Engine
+{
+	FrameAllocator::FrameAllocator(size_t capacity)
+		: m_buffer(new uint8_t[capacity]), m_capacity(capacity)
+	{}
+
+	FrameAllocator::~FrameAllocator()
+	{
+		delete[] m_buffer;
+	}
+
+	void* FrameAllocator::Allocate(size_t size, size_t alignment)
+	{
+		// Reserve enough for the worst case padding, so the bump never needs a compare and swap loop
+		size_t offset = m_offset.fetch_add(size + alignment - 1, std::memory_order_relaxed);
+		if (offset + size + alignment - 1 <= m_capacity)
+		{
+			uintptr_t address = (uintptr_t) (m_buffer + offset);
+			return (void*) ((address + alignment - 1) & ~(uintptr_t) (alignment - 1));
+		}
+
+		std::lock_guard<std::mutex> lock(m_overflowMutex);
+		auto& block = m_overflow.emplace_back(new uint8_t[size + alignment - 1]);
+		uintptr_t address = (uintptr_t) block.get();
+		return (void*) ((address + alignment - 1) & ~(uintptr_t) (alignment - 1));
+	}
+
+	void FrameAllocator::Reset()
+	{
+		std::lock_guard<std::mutex> lock(m_overflowMutex);
+		if (!m_overflow.empty())
+			ENG_CORE_TRACE("Frame allocator overflowed by {0} allocations", m_overflow.size());
+
+		m_offset.store(0, std::memory_order_relaxed);
+		m_overflow.clear();
+	}
+
+	struct Job
+	{
+		JobSystem::JobFunction Function;
+		JobCounter* Counter = nullptr;
+		const char* Name = "Job";
+		Job* Next = nullptr; // While parked on a dependency
+	};
+
+	struct WorkQueue
+	{
+		std::mutex Mutex;
+		std::deque<Job> Jobs;
+	};
+
+	struct JobSystemData
+	{
+		static constexpr size_t FrameAllocatorSize = 4 * 1024 * 1024;
+
+		std::vector<std::thread> Workers;
+		std::vector<Scope<WorkQueue>> Queues;
+		std::atomic<uint32_t> NextQueue = 0;
+		std::atomic<uint32_t> PendingJobs = 0; // Queued and not taken by a thread yet
+		std::atomic<uint32_t> UnfinishedJobs = 0; // Parked, queued or running
+		std::atomic<bool> Running = false;
+
+		std::mutex SleepMutex;
+		std::condition_variable WakeCondition;
+
+		std::mutex MainThreadMutex;
+		std::vector<Job> MainThreadJobs;
+		std::vector<Job> RunningMainThreadJobs;
+		bool InMainThreadJobs = false;
+		std::thread::id MainThreadID;
+
+		Scope<FrameAllocator> FrameMemory;
+	};
+
+	static JobSystemData s_data;
+
+	// Queue owned by the current thread, threads outside the pool have none
+	static thread_local int32_t s_queueIndex = -1;
+
+	void JobSystem::Init(uint32_t workerCount)
+	{
+		ENG_PROFILE_FUNCTION();
+
+		if (workerCount == 0)
+			workerCount = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+
+		s_data.MainThreadID = std::this_thread::get_id();
+		s_data.FrameMemory = CreateScope<FrameAllocator>(JobSystemData::FrameAllocatorSize);
+		s_data.Running = true;
+
+		for (uint32_t i = 0; i < workerCount; i++)
+			s_data.Queues.push_back(CreateScope<WorkQueue>());
+
+		for (uint32_t i = 0; i < workerCount; i++)
+		{
+			s_data.Workers.emplace_back([i] () {
+				s_queueIndex = (int32_t) i;
+
+				while (s_data.Running)
+				{
+					if (RunJob())
+						continue;
+
+					std::unique_lock<std::mutex> lock(s_data.SleepMutex);
+					s_data.WakeCondition.wait(lock, [] () { return s_data.PendingJobs > 0 || !s_data.Running; });
+				}
+				});
+		}
+
+		ENG_CORE_TRACE("Job system started with {0} workers", workerCount);
+	}
+
+	void JobSystem::Shutdown()
+	{
+		ENG_PROFILE_FUNCTION();
+
+		// Finish what is scheduled, so nobody waits forever on a counter of a job that never ran
+		while (s_data.UnfinishedJobs > 0)
+		{
+			if (!RunJob())
+				std::this_thread::yield();
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(s_data.SleepMutex);
+			s_data.Running = false;
+		}
+		s_data.WakeCondition.notify_all();
+
+		for (auto& worker : s_data.Workers)
+			worker.join();
+
+		s_data.Workers.clear();
+		s_data.Queues.clear();
+		s_data.MainThreadJobs.clear();
+		s_data.FrameMemory = nullptr;
+	}
+
+	void JobSystem::BeginFrame()
+	{
+		ENG_PROFILE_FUNCTION();
+
+		RunMainThreadJobs();
+		s_data.FrameMemory->Reset();
+	}
+
+	void JobSystem::Schedule(JobFunction job, JobCounter* counter, JobCounter* dependency, const char* name)
+	{
+		if (counter)
+			counter->m_count.fetch_add(1, std::memory_order_relaxed);
+
+		if (s_data.Queues.empty())
+		{
+			// No workers, the job runs inline
+			if (dependency)
+				Wait(*dependency);
+
+			{
+				ENG_PROFILE_SCOPE(name);
+				job();
+			}
+
+			FinishJob(counter);
+			return;
+		}
+
+		s_data.UnfinishedJobs++;
+
+		Job entry = { std::move(job), counter, name };
+		if (dependency)
+		{
+			// No thread looks at the job before the dependency is done, the job that finishes it queues this one
+			std::lock_guard<std::mutex> lock(dependency->m_waitingMutex);
+			if (!dependency->IsDone())
+			{
+				Job* parked = new Job(std::move(entry));
+				parked->Next = dependency->m_waiting;
+				dependency->m_waiting = parked;
+				return;
+			}
+		}
+
+		Enqueue(std::move(entry));
+	}
+
+	void JobSystem::Enqueue(Job&& job)
+	{
+		// Workers push to their own queue, everyone else spreads the jobs over all queues
+		uint32_t queueIndex = s_queueIndex >= 0 ? (uint32_t) s_queueIndex : s_data.NextQueue++ % (uint32_t) s_data.Queues.size();
+		WorkQueue& queue = *s_data.Queues[queueIndex];
+		{
+			std::lock_guard<std::mutex> lock(queue.Mutex);
+			queue.Jobs.push_back(std::move(job));
+		}
+
+		// Taking the sleep mutex orders the increment with a worker that is about to wait
+		{
+			std::lock_guard<std::mutex> lock(s_data.SleepMutex);
+			s_data.PendingJobs++;
+		}
+		s_data.WakeCondition.notify_one();
+	}
+
+	void JobSystem::FinishJob(JobCounter* counter)
+	{
+		if (!counter)
+			return;
+
+		// Only the decrement to zero has to release parked jobs, the others skip the lock
+		uint32_t count = counter->m_count.load(std::memory_order_relaxed);
+		while (count > 1)
+		{
+			if (counter->m_count.compare_exchange_weak(count, count - 1, std::memory_order_release, std::memory_order_relaxed))
+				return;
+		}
+
+		Job* waiting = nullptr;
+		{
+			std::lock_guard<std::mutex> lock(counter->m_waitingMutex);
+			if (counter->m_count.fetch_sub(1, std::memory_order_acq_rel) == 1)
+			{
+				waiting = counter->m_waiting;
+				counter->m_waiting = nullptr;
+			}
+		}
+
+		// The counter may be gone by now, only the parked jobs are touched
+		while (waiting)
+		{
+			Job* next = waiting->Next;
+			waiting->Next = nullptr;
+			Enqueue(std::move(*waiting));
+			delete waiting;
+			waiting = next;
+		}
+	}
+
+	void JobSystem::ScheduleOnMainThread(JobFunction job, JobCounter* counter)
+	{
+		if (counter)
+			counter->m_count.fetch_add(1, std::memory_order_relaxed);
+
+		std::lock_guard<std::mutex> lock(s_data.MainThreadMutex);
+		s_data.MainThreadJobs.push_back({ std::move(job), counter, "Main thread job" });
+	}
+
+	void JobSystem::RunMainThreadJobs()
+	{
+		ENG_CORE_ASSERT(IsMainThread(), "Main thread jobs can only run on the main thread!");
+
+		// A main thread job that waits must not run the list it is part of again
+		if (s_data.InMainThreadJobs)
+			return;
+
+		{
+			std::lock_guard<std::mutex> lock(s_data.MainThreadMutex);
+			if (s_data.MainThreadJobs.empty())
+				return;
+
+			// Jobs scheduled by these jobs run next time
+			std::swap(s_data.MainThreadJobs, s_data.RunningMainThreadJobs);
+		}
+
+		s_data.InMainThreadJobs = true;
+		for (auto& job : s_data.RunningMainThreadJobs)
+		{
+			{
+				ENG_PROFILE_SCOPE(job.Name);
+				job.Function();
+			}
+
+			FinishJob(job.Counter);
+		}
+		s_data.RunningMainThreadJobs.clear();
+		s_data.InMainThreadJobs = false;
+	}
+
+	void JobSystem::Wait(JobCounter& counter)
+	{
+		ENG_PROFILE_FUNCTION();
+
+		while (!counter.IsDone())
+		{
+			if (!RunJob())
+				std::this_thread::yield();
+		}
+	}
+
+	void JobSystem::WaitOnMainThread(JobCounter& counter)
+	{
+		ENG_CORE_ASSERT(IsMainThread(), "WaitOnMainThread can only be called on the main thread!");
+		ENG_PROFILE_FUNCTION();
+
+		while (!counter.IsDone())
+		{
+			RunMainThreadJobs();
+
+			if (!RunJob())
+				std::this_thread::yield();
+		}
+	}
+
+	void JobSystem::WaitWithoutRunning(JobCounter& counter)
+	{
+		ENG_PROFILE_FUNCTION();
+
+		while (!counter.IsDone())
+			std::this_thread::yield();
+	}
+
+	void JobSystem::ParallelFor(uint32_t count, uint32_t batchSize, const std::function<void(uint32_t begin, uint32_t end)>& function)
+	{
+		if (count == 0)
+			return;
+
+		ENG_PROFILE_FUNCTION();
+
+		batchSize = std::max(batchSize, 1u);
+
+		// The calling thread takes the first batch itself
+		JobCounter counter;
+		for (uint32_t begin = batchSize; begin < count; begin += batchSize)
+		{
+			uint32_t end = std::min(begin + batchSize, count);
+			Schedule([&function, begin, end] () { function(begin, end); }, &counter, nullptr, "ParallelFor batch");
+		}
+
+		function(0, std::min(batchSize, count));
+		Wait(counter);
+	}
+
+	void* JobSystem::AllocateFrame(size_t size, size_t alignment)
+	{
+		return s_data.FrameMemory->Allocate(size, alignment);
+	}
+
+	uint32_t JobSystem::GetWorkerCount()
+	{
+		return (uint32_t) s_data.Workers.size();
+	}
+
+	bool JobSystem::IsMainThread()
+	{
+		return std::this_thread::get_id() == s_data.MainThreadID;
+	}
+
+	uint32_t JobSystem::GetThreadIndex()
+	{
+		ENG_CORE_ASSERT(s_queueIndex >= 0 || IsMainThread(), "Thread is not part of the job system!");
+		return (uint32_t) (s_queueIndex + 1);
+	}
+
+	bool JobSystem::RunJob()
+	{
+		uint32_t queueCount = (uint32_t) s_data.Queues.size();
+		if (queueCount == 0)
+			return false;
+
+		// Newest job of the own queue first, it is most likely still in cache. Other queues are robbed
+		// from the front, where the oldest and usually biggest jobs are.
+		uint32_t start = s_queueIndex >= 0 ? (uint32_t) s_queueIndex : 0;
+
+		Job job;
+		bool found = false;
+		for (uint32_t i = 0; i < queueCount && !found; i++)
+		{
+			uint32_t queueIndex = (start + i) % queueCount;
+			WorkQueue& queue = *s_data.Queues[queueIndex];
+
+			std::lock_guard<std::mutex> lock(queue.Mutex);
+			if (queue.Jobs.empty())
+				continue;
+
+			if (i == 0 && s_queueIndex >= 0)
+			{
+				job = std::move(queue.Jobs.back());
+				queue.Jobs.pop_back();
+			} else
+			{
+				job = std::move(queue.Jobs.front());
+				queue.Jobs.pop_front();
+			}
+			found = true;
+		}
+
+		if (!found)
+			return false;
+
+		s_data.PendingJobs--;
+
+		{
+			ENG_PROFILE_SCOPE(job.Name);
+			job.Function();
+		}
+
+		FinishJob(job.Counter);
+		s_data.UnfinishedJobs--;
+
+		return true;
+	}
+}
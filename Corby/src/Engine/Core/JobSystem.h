@@ -0,0 +1,157 @@
+#pragma once
+
+#include "Engine/Core/Base.h"
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
+namespace Engine
+{
+	struct Job;
+
+	// Number of scheduled jobs that have not finished yet. Jobs can wait on a counter before they start,
+	// which is how dependencies between jobs are expressed. Those jobs are parked on the counter and only
+	// queued once it reaches zero.
+	class JobCounter
+	{
+	public:
+		JobCounter() = default;
+		JobCounter(const JobCounter&) = delete;
+		JobCounter& operator=(const JobCounter&) = delete;
+
+		// The job that brought the counter to zero may still be releasing the parked jobs while a waiter already
+		// sees it done, the lock waits for that
+		~JobCounter()
+		{
+			std::lock_guard<std::mutex> lock(m_waitingMutex);
+			ENG_CORE_ASSERT(!m_waiting, "Jobs still wait on a counter that is destroyed!");
+		}
+
+		bool IsDone() const { return m_count.load(std::memory_order_acquire) == 0; }
+
+	private:
+		std::atomic<uint32_t> m_count = 0;
+
+		// Also held while the count drops to zero
+		std::mutex m_waitingMutex;
+		Job* m_waiting = nullptr; // Linked through Job::Next
+
+		friend class JobSystem;
+	};
+
+	// Linear allocator for data that only lives for a frame, it is reset when the next frame starts.
+	// Allocations are lock free until the buffer is full, the rest comes from the heap.
+	class FrameAllocator
+	{
+	public:
+		FrameAllocator(size_t capacity);
+		~FrameAllocator();
+
+		void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+		void Reset();
+
+	private:
+		uint8_t* m_buffer;
+		size_t m_capacity;
+		std::atomic<size_t> m_offset = 0;
+
+		std::mutex m_overflowMutex;
+		std::vector<Scope<uint8_t[]>> m_overflow;
+	};
+
+	// Work stealing thread pool. Every worker has its own queue and takes work from the others when it runs dry,
+	// threads that wait on a counter run jobs in the meantime instead of blocking.
+	class JobSystem
+	{
+	public:
+		using JobFunction = std::function<void()>;
+
+		// A worker count of 0 uses one worker per hardware thread besides the main thread
+		static void Init(uint32_t workerCount = 0);
+		static void Shutdown();
+
+		// Called by the application at the start of every frame, runs the main thread jobs and resets the frame allocator
+		static void BeginFrame();
+
+		// The counter is incremented right away and decremented once the job has run. A job with a dependency
+		// does not start before the dependency is done. The name shows up in profiling sessions.
+		static void Schedule(JobFunction job, JobCounter* counter = nullptr, JobCounter* dependency = nullptr, const char* name = "Job");
+
+		// For work that has to happen on the main thread, such as recording render commands. They run
+		// in BeginFrame and in WaitOnMainThread, a main thread job that schedules or waits for others does not run
+		// them again, those follow the next time.
+		static void ScheduleOnMainThread(JobFunction job, JobCounter* counter = nullptr);
+		static void RunMainThreadJobs();
+
+		// Runs jobs of the pool while the counter is not done
+		static void Wait(JobCounter& counter);
+		// Also runs the main thread jobs, for counters of main thread jobs. Only call it where any of them may run.
+		static void WaitOnMainThread(JobCounter& counter);
+		// Runs nothing while waiting, for callers in the middle of work other jobs must not run within, such as
+		// registry signals
+		static void WaitWithoutRunning(JobCounter& counter);
+
+		// Splits [0, count) into batches and runs them in parallel, returns once all batches are done
+		static void ParallelFor(uint32_t count, uint32_t batchSize, const std::function<void(uint32_t begin, uint32_t end)>& function);
+
+		// Calls the function for every entity of an entt view or group in parallel. The function may write the
+		// components of the entity it gets, but must not add or remove components. Structural changes go through
+		// Scene::GetCommandBuffer instead.
+		template<typename View, typename Function>
+		static void ParallelForEach(const View& view, Function function, uint32_t batchSize = 256)
+		{
+			using EntityType = typename View::entity_type;
+
+			// Views can only be walked front to back, so the entities are gathered first
+			size_t capacity = GetSizeBound(view);
+			EntityType* entities = AllocateFrame<EntityType>(capacity);
+
+			uint32_t count = 0;
+			for (auto entity : view)
+				entities[count++] = entity;
+
+			ParallelFor(count, batchSize, [&] (uint32_t begin, uint32_t end) {
+				for (uint32_t i = begin; i < end; i++)
+					function(entities[i]);
+				});
+		}
+
+		static void* AllocateFrame(size_t size, size_t alignment = alignof(std::max_align_t));
+
+		template<typename T>
+		static T* AllocateFrame(size_t count)
+		{
+			return (T*) AllocateFrame(count * sizeof(T), alignof(T));
+		}
+
+		static uint32_t GetWorkerCount();
+		static bool IsMainThread();
+
+		// 0 on the main thread and 1 to GetWorkerCount() on the workers, for data kept per thread
+		static uint32_t GetThreadIndex();
+
+	private:
+		template<typename View, typename = void>
+		struct HasSizeHint : std::false_type {};
+
+		template<typename View>
+		struct HasSizeHint<View, std::void_t<decltype(std::declval<const View&>().size_hint())>> : std::true_type {};
+
+		// Views of several components only know an upper bound of their size
+		template<typename View>
+		static size_t GetSizeBound(const View& view)
+		{
+			if constexpr (HasSizeHint<View>::value)
+				return view.size_hint();
+			else
+				return view.size();
+		}
+
+		static bool RunJob();
+		static void Enqueue(Job&& job);
+		static void FinishJob(JobCounter* counter);
+	};
+}
@@ -3,6 +3,8 @@
 
 namespace Engine
 {
+	uint32_t Layer::s_eventHandlersVersion = 0;
+
 	Layer::Layer(const std::string& debugName)
 		: m_debugName(debugName)
 	{
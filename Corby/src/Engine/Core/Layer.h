@@ -4,11 +4,20 @@
 #include "Engine/Core/Timestep.h"
 #include "Engine/Events/Event.h"
 
+#include <functional>
+#include <vector>
+
 namespace Engine
 {
 	class Layer
 	{
 	public:
+		struct EventHandler
+		{
+			EventType Type;
+			std::function<bool(Event&)> Function;
+		};
+
 		Layer(const std::string& name = "Layer");
 		virtual ~Layer();
 
@@ -16,11 +25,29 @@ namespace Engine
 		virtual void OnDetach() {}
 		virtual void OnUpdate(Timestep ts) {}
 		virtual void OnImGuiRender() {}
-		virtual void OnEvent(Event& e) {}
+
+		// Layers only receive the event types they subscribed to, the layer stack keeps a table of handlers per
+		// type. Handlers return true to stop the event from reaching the layers below. Objects owned by the layer,
+		// such as camera controllers, subscribe through it as well.
+		template<typename T, typename F>
+		void Subscribe(F handler)
+		{
+			m_eventHandlers.push_back({ T::GetStaticType(), [handler] (Event& e) { return handler(static_cast<T&>(e)); } });
+			s_eventHandlersVersion++;
+		}
+
+		const std::vector<EventHandler>& GetEventHandlers() const { return m_eventHandlers; }
+		// Changes whenever any layer subscribes, so the tables built from the handlers can be kept up to date
+		static uint32_t GetEventHandlersVersion() { return s_eventHandlersVersion; }
 
 		const std::string& GetName() const { return m_debugName; }
 
 	protected:
 		std::string m_debugName;
+
+	private:
+		std::vector<EventHandler> m_eventHandlers;
+
+		static uint32_t s_eventHandlersVersion;
 	};
 }
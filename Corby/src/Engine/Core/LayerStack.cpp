@@ -16,6 +16,7 @@ namespace Engine
 	{
 		m_layers.emplace(m_layers.begin() + m_layerInsertIndex, layer);
 		m_layerInsertIndex++;
+		m_eventHandlersDirty = true;
 
 		layer->OnAttach();
 	}
@@ -23,6 +24,7 @@ namespace Engine
 	void LayerStack::PushOverlay(Layer* overlay)
 	{
 		m_layers.emplace_back(overlay);
+		m_eventHandlersDirty = true;
 
 		overlay->OnAttach();
 	}
@@ -36,6 +38,7 @@ namespace Engine
 			layer->OnDetach();
 			m_layers.erase(it);
 			m_layerInsertIndex--;
+			m_eventHandlersDirty = true;
 		}
 	}
 
@@ -47,6 +50,35 @@ namespace Engine
 		{
 			overlay->OnDetach();
 			m_layers.erase(it);
+			m_eventHandlersDirty = true;
 		}
 	}
+
+	void LayerStack::DispatchEvent(Event& e)
+	{
+		const auto& handlers = GetEventHandlers(e.GetEventType());
+		for (size_t i = 0; i < handlers.size() && !e.handled; i++)
+			e.handled |= handlers[i].Owner->GetEventHandlers()[handlers[i].Index].Function(e);
+	}
+
+	const std::vector<LayerStack::EventHandlerRef>& LayerStack::GetEventHandlers(EventType type)
+	{
+		if (m_eventHandlersDirty || m_eventHandlersVersion != Layer::GetEventHandlersVersion())
+		{
+			for (auto& handlers : m_eventHandlers)
+				handlers.clear();
+
+			for (auto it = m_layers.rbegin(); it != m_layers.rend(); ++it)
+			{
+				const auto& layerHandlers = (*it)->GetEventHandlers();
+				for (uint32_t i = 0; i < (uint32_t) layerHandlers.size(); i++)
+					m_eventHandlers[(size_t) layerHandlers[i].Type].push_back({ *it, i });
+			}
+
+			m_eventHandlersVersion = Layer::GetEventHandlersVersion();
+			m_eventHandlersDirty = false;
+		}
+
+		return m_eventHandlers[(size_t) type];
+	}
 }
@@ -3,6 +3,7 @@
 #include "Engine/Core/Base.h"
 #include "Engine/Core/Layer.h"
 
+#include <array>
 #include <vector>
 
 namespace Engine
@@ -28,8 +29,25 @@ namespace Engine
 		std::vector<Layer*>::const_reverse_iterator rbegin() const { return m_layers.rbegin(); }
 		std::vector<Layer*>::const_reverse_iterator rend() const { return m_layers.rend(); }
 
+		// Runs the handlers subscribed to the type of the event, topmost layer first, until one handles it
+		void DispatchEvent(Event& e);
+
+	private:
+		// Refers to the handler by index, so a layer subscribing during a dispatch doesn't invalidate it
+		struct EventHandlerRef
+		{
+			Layer* Owner;
+			uint32_t Index;
+		};
+
+		const std::vector<EventHandlerRef>& GetEventHandlers(EventType type);
+
 	private:
 		std::vector<Layer*> m_layers;
 		unsigned int m_layerInsertIndex = 0;
+
+		std::array<std::vector<EventHandlerRef>, EventTypeCount> m_eventHandlers;
+		uint32_t m_eventHandlersVersion = 0;
+		bool m_eventHandlersDirty = true;
 	};
 }
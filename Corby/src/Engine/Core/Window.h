@@ -2,6 +2,7 @@
 
 #include "Engine/Core/Base.h"
 #include "Engine/Events/Event.h"
+#include "Engine/Renderer/GraphicsContext.h"
 
 #include <sstream>
 
@@ -33,6 +34,7 @@ namespace Engine
 		virtual bool IsVSync() const = 0;
 
 		virtual void* GetNativeWindow() const = 0;
+		virtual GraphicsContext& GetContext() = 0;
 
 		static Scope<Window> Create(const WindowProps& props = WindowProps());
 	};
@@ -8,13 +8,13 @@ namespace Engine
 	{
 	public:
 		WindowResizeEvent(unsigned int width, unsigned int height)
-			: m_width(width), m_height(height)
+			: Event(GetStaticType(), GetStaticCategoryFlags()), m_width(width), m_height(height)
 		{}
 
 		unsigned int GetWidth() const { return m_width; }
 		unsigned int GetHeight() const { return m_height; }
 
-		std::string ToString() const override
+		std::string ToString() const
 		{
 			std::stringstream ss;
 			ss << "WindowResizeEvent: " << m_width << ", " << m_height;
@@ -32,7 +32,9 @@ namespace Engine
 	class WindowCloseEvent : public Event
 	{
 	public:
-		WindowCloseEvent() = default;
+		WindowCloseEvent()
+			: Event(GetStaticType(), GetStaticCategoryFlags())
+		{}
 
 		EVENT_CLASS_TYPE(WindowClose);
 		EVENT_CLASS_CATEGORY(EventCategoryApplication);
@@ -41,7 +43,9 @@ namespace Engine
 	class AppTickEvent : public Event
 	{
 	public:
-		AppTickEvent() = default;
+		AppTickEvent()
+			: Event(GetStaticType(), GetStaticCategoryFlags())
+		{}
 
 		EVENT_CLASS_TYPE(AppTick);
 		EVENT_CLASS_CATEGORY(EventCategoryApplication);
@@ -50,7 +54,9 @@ namespace Engine
 	class AppUpdateEvent : public Event
 	{
 	public:
-		AppUpdateEvent() = default;
+		AppUpdateEvent()
+			: Event(GetStaticType(), GetStaticCategoryFlags())
+		{}
 
 		EVENT_CLASS_TYPE(AppUpdate);
 		EVENT_CLASS_CATEGORY(EventCategoryApplication);
@@ -59,7 +65,9 @@ namespace Engine
 	class AppRenderEvent : public Event
 	{
 	public:
-		AppRenderEvent() = default;
+		AppRenderEvent()
+			: Event(GetStaticType(), GetStaticCategoryFlags())
+		{}
 
 		EVENT_CLASS_TYPE(AppRender);
 		EVENT_CLASS_CATEGORY(EventCategoryApplication);
@@ -26,29 +26,60 @@ namespace Engine
 		EventCategoryMouseButton = BIT(4)
 	};
 
-	#define EVENT_CLASS_TYPE(type) static EventType GetStaticType() { return EventType::type; }\
-	virtual EventType GetEventType() const override { return GetStaticType(); }\
-	virtual const char* GetName() const override { return #type; }
+	inline const char* GetEventTypeName(EventType type)
+	{
+		switch (type)
+		{
+			case EventType::WindowClose:         return "WindowClose";
+			case EventType::WindowResize:        return "WindowResize";
+			case EventType::WindowFocus:         return "WindowFocus";
+			case EventType::WindowLostFocus:     return "WindowLostFocus";
+			case EventType::WindowMoved:         return "WindowMoved";
+			case EventType::AppTick:             return "AppTick";
+			case EventType::AppUpdate:           return "AppUpdate";
+			case EventType::AppRender:           return "AppRender";
+			case EventType::KeyPressed:          return "KeyPressed";
+			case EventType::KeyReleased:         return "KeyReleased";
+			case EventType::KeyTyped:            return "KeyTyped";
+			case EventType::MouseButtonPressed:  return "MouseButtonPressed";
+			case EventType::MouseButtonReleased: return "MouseButtonReleased";
+			case EventType::MouseMoved:          return "MouseMoved";
+			case EventType::MouseScrolled:       return "MouseScrolled";
+			default:                             return "None";
+		}
+	}
+
+	static constexpr size_t EventTypeCount = (size_t) EventType::MouseScrolled + 1;
+
+	#define EVENT_CLASS_TYPE(type) static constexpr EventType GetStaticType() { return EventType::type; }
 
-	#define EVENT_CLASS_CATEGORY(category) virtual int GetCategoryFlags() const override { return category; }
+	#define EVENT_CLASS_CATEGORY(category) static constexpr int GetStaticCategoryFlags() { return category; }
 
+	// Events are plain data without virtual functions, the type and category are stored in the event itself.
+	// That keeps them trivially copyable, the event queue copies them into its frame arena as they are.
 	class Event
 	{
-		friend class EventDispatcher;
-
 	public:
-		virtual ~Event() = default;
 		bool handled = false;
 
-		virtual EventType GetEventType() const = 0;
-		virtual const char* GetName() const = 0;
-		virtual int GetCategoryFlags() const = 0;
-		virtual std::string ToString() const { return GetName(); }
+		EventType GetEventType() const { return m_type; }
+		const char* GetName() const { return GetEventTypeName(m_type); }
+		int GetCategoryFlags() const { return m_categoryFlags; }
+		std::string ToString() const { return GetName(); }
 
-		bool IsInCategory(EventCategory category)
+		bool IsInCategory(EventCategory category) const
 		{
-			return GetCategoryFlags() & category;
+			return m_categoryFlags & category;
 		}
+
+	protected:
+		Event(EventType type, int categoryFlags)
+			: m_type(type), m_categoryFlags(categoryFlags)
+		{}
+
+	private:
+		EventType m_type;
+		int m_categoryFlags;
 	};
 
 	class EventDispatcher
@@ -74,7 +105,9 @@ namespace Engine
 		Event& m_event;
 	};
 
-	inline std::ostream& operator<<(std::ostream& os, const Event& e)
+	// ToString is not virtual, so the concrete type picks the overload
+	template<typename T, typename = std::enable_if_t<std::is_base_of_v<Event, T>>>
+	inline std::ostream& operator<<(std::ostream& os, const T& e)
 	{
 		return os << e.ToString();
 	}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "Engine/Core/JobSystem.h"
+#include "Engine/Events/ApplicationEvent.h"
+#include "Engine/Events/Event.h"
+#include "Engine/Events/KeyEvent.h"
+#include "Engine/Events/MouseEvent.h"
+
+namespace Engine
+{
+	// Calls func with the concrete type of the event, returns false for types that can't be queued
+	template<typename Func>
+	bool VisitEvent(Event& event, const Func& func)
+	{
+		switch (event.GetEventType())
+		{
+			case EventType::WindowClose:         func(static_cast<WindowCloseEvent&>(event)); return true;
+			case EventType::WindowResize:        func(static_cast<WindowResizeEvent&>(event)); return true;
+			case EventType::KeyPressed:          func(static_cast<KeyPressedEvent&>(event)); return true;
+			case EventType::KeyReleased:         func(static_cast<KeyReleasedEvent&>(event)); return true;
+			case EventType::KeyTyped:            func(static_cast<KeyTypedEvent&>(event)); return true;
+			case EventType::MouseButtonPressed:  func(static_cast<MouseButtonPressedEvent&>(event)); return true;
+			case EventType::MouseButtonReleased: func(static_cast<MouseButtonReleasedEvent&>(event)); return true;
+			case EventType::MouseMoved:          func(static_cast<MouseMovedEvent&>(event)); return true;
+			case EventType::MouseScrolled:       func(static_cast<MouseScrolledEvent&>(event)); return true;
+			default:
+				return false;
+		}
+	}
+
+	// Collects the events of the window callbacks so they can be dispatched once per frame. Events are copied
+	// into a frame arena and chained in the order they were pushed, one arena is filled while the other is
+	// dispatched and then reset, so queuing allocates nothing. Consecutive mouse moves and window resizes are
+	// merged, only the latest position or size is dispatched.
+	class EventQueue
+	{
+	public:
+		EventQueue()
+			: m_arenas{ { ArenaSize }, { ArenaSize } }
+		{}
+
+		void Push(Event& event)
+		{
+			if (!VisitEvent(event, [this] (auto& e) { Push(e); }))
+				ENG_CORE_ASSERT(false, "Event type can't be queued!");
+		}
+
+		template<typename T>
+		void Push(const T& event)
+		{
+			static_assert(std::is_trivially_copyable_v<T>, "Queued events are copied into the arena as they are!");
+
+			if constexpr (std::is_same_v<T, MouseMovedEvent> || std::is_same_v<T, WindowResizeEvent>)
+			{
+				if (m_last && m_last->Data->GetEventType() == T::GetStaticType())
+				{
+					static_cast<T&>(*m_last->Data) = event;
+					return;
+				}
+			}
+
+			FrameAllocator& arena = m_arenas[m_current];
+			T* copy = new (arena.Allocate(sizeof(T), alignof(T))) T(event);
+			Node* node = new (arena.Allocate(sizeof(Node), alignof(Node))) Node{ nullptr, copy };
+
+			if (m_last)
+				m_last->Next = node;
+			else
+				m_first = node;
+			m_last = node;
+		}
+
+		// Calls func with the concrete type of every queued event, in the order they were pushed. Events pushed
+		// by the handlers are dispatched the next time.
+		template<typename Func>
+		void Dispatch(const Func& func)
+		{
+			Node* node = m_first;
+			FrameAllocator& arena = m_arenas[m_current];
+
+			m_first = m_last = nullptr;
+			m_current ^= 1;
+
+			for (; node; node = node->Next)
+				VisitEvent(*node->Data, func);
+
+			arena.Reset();
+		}
+
+		bool IsEmpty() const { return m_first == nullptr; }
+
+	private:
+		struct Node
+		{
+			Node* Next;
+			Event* Data;
+		};
+
+		static constexpr size_t ArenaSize = 64 * 1024;
+
+		FrameAllocator m_arenas[2];
+		uint32_t m_current = 0;
+		Node* m_first = nullptr;
+		Node* m_last = nullptr;
+	};
+}
@@ -13,8 +13,8 @@ namespace Engine
 		EVENT_CLASS_CATEGORY(EventCategoryKeyboard | EventCategoryInput);
 
 	protected:
-		KeyEvent(const KeyCode keycode)
-			: m_keyCode(keycode)
+		KeyEvent(EventType type, const KeyCode keycode)
+			: Event(type, GetStaticCategoryFlags()), m_keyCode(keycode)
 		{}
 
 		KeyCode m_keyCode;
@@ -24,12 +24,12 @@ namespace Engine
 	{
 	public:
 		KeyPressedEvent(const KeyCode keycode, const uint16_t repeatCount)
-			: KeyEvent(keycode), m_repeatCount(repeatCount)
+			: KeyEvent(GetStaticType(), keycode), m_repeatCount(repeatCount)
 		{}
 
 		uint16_t GetRepeatCount() const { return m_repeatCount; }
 
-		std::string ToString() const override
+		std::string ToString() const
 		{
 			std::stringstream ss;
 			ss << "KeyPressedEvent: " << m_keyCode << " (" << m_repeatCount << " repeats)";
@@ -47,10 +47,10 @@ namespace Engine
 	{
 	public:
 		KeyReleasedEvent(const KeyCode keycode)
-			: KeyEvent(keycode)
+			: KeyEvent(GetStaticType(), keycode)
 		{}
 
-		std::string ToString() const override
+		std::string ToString() const
 		{
 			std::stringstream ss;
 			ss << "KeyReleasedEvent: " << m_keyCode;
@@ -65,10 +65,10 @@ namespace Engine
 	{
 	public:
 		KeyTypedEvent(const KeyCode keycode)
-			: KeyEvent(keycode)
+			: KeyEvent(GetStaticType(), keycode)
 		{}
 
-		std::string ToString() const override
+		std::string ToString() const
 		{
 			std::stringstream ss;
 			ss << "KeyTypedEvent: " << m_keyCode;
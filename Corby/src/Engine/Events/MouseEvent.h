@@ -9,13 +9,13 @@ namespace Engine
 	{
 	public:
 		MouseMovedEvent(const float x, const float y)
-			: m_mouseX(x), m_mouseY(y)
+			: Event(GetStaticType(), GetStaticCategoryFlags()), m_mouseX(x), m_mouseY(y)
 		{}
 
 		float GetX() const { return m_mouseX; }
 		float GetY() const { return m_mouseY; }
 
-		std::string ToString() const override
+		std::string ToString() const
 		{
 			std::stringstream ss;
 			ss << "MouseMovedEvent: " << m_mouseX << ", " << m_mouseY;
@@ -33,13 +33,13 @@ namespace Engine
 	{
 	public:
 		MouseScrolledEvent(const float xOffset, const float yOffset)
-			: m_xOffset(xOffset), m_yOffset(yOffset)
+			: Event(GetStaticType(), GetStaticCategoryFlags()), m_xOffset(xOffset), m_yOffset(yOffset)
 		{}
 
 		float GetXOffset() const { return m_xOffset; }
 		float GetYOffset() const { return m_yOffset; }
 
-		std::string ToString() const override
+		std::string ToString() const
 		{
 			std::stringstream ss;
 			ss << "MouseScrolledEvent: " << GetXOffset() << ", " << GetYOffset();
@@ -60,8 +60,8 @@ namespace Engine
 
 		EVENT_CLASS_CATEGORY(EventCategoryMouse | EventCategoryInput | EventCategoryMouseButton);
 	protected:
-		MouseButtonEvent(const MouseCode button)
-			: m_button(button)
+		MouseButtonEvent(EventType type, const MouseCode button)
+			: Event(type, GetStaticCategoryFlags()), m_button(button)
 		{}
 
 		MouseCode m_button;
@@ -71,10 +71,10 @@ namespace Engine
 	{
 	public:
 		MouseButtonPressedEvent(const MouseCode button)
-			: MouseButtonEvent(button)
+			: MouseButtonEvent(GetStaticType(), button)
 		{}
 
-		std::string ToString() const override
+		std::string ToString() const
 		{
 			std::stringstream ss;
 			ss << "MouseButtonPressedEvent: " << m_button;
@@ -89,10 +89,10 @@ namespace Engine
 	{
 	public:
 		MouseButtonReleasedEvent(const MouseCode button)
-			: MouseButtonEvent(button)
+			: MouseButtonEvent(GetStaticType(), button)
 		{}
 
-		std::string ToString() const override
+		std::string ToString() const
 		{
 			std::stringstream ss;
 			ss << "MouseButtonReleasedEvent: " << m_button;
@@ -2,6 +2,7 @@
 #include "ImGuiLayer.h"
 
 #include "Engine/Core/Application.h"
+#include "Engine/Renderer/RenderThread.h"
 
 #include <backends/imgui_impl_glfw.h>
 #include <backends/imgui_impl_opengl3.h>
@@ -14,9 +15,59 @@
 
 namespace Engine
 {
+	// The render thread draws a copy of the draw data, ImGui builds the next frame in the meantime. The first
+	// copy is the main viewport, the others are the platform windows.
+	struct ImGuiDrawDataCopy
+	{
+		GLFWwindow* Window = nullptr;
+		bool Clear = false;
+
+		ImDrawData Data;
+		std::vector<ImDrawList*> Lists;
+	};
+
+	static std::vector<ImGuiDrawDataCopy> s_drawDataCopies;
+
+	template<typename T>
+	static void CopyImVector(ImVector<T>& destination, const ImVector<T>& source)
+	{
+		// Keeps the capacity of the last frame
+		destination.resize(source.Size);
+		if (source.Size)
+			memcpy(destination.Data, source.Data, source.size_in_bytes());
+	}
+
+	static void CopyDrawData(const ImDrawData* source, ImGuiDrawDataCopy& copy)
+	{
+		while (copy.Lists.size() < (size_t) source->CmdListsCount)
+			copy.Lists.push_back(IM_NEW(ImDrawList)(ImGui::GetDrawListSharedData()));
+
+		for (int i = 0; i < source->CmdListsCount; i++)
+		{
+			const ImDrawList* sourceList = source->CmdLists[i];
+			ImDrawList* list = copy.Lists[i];
+
+			CopyImVector(list->CmdBuffer, sourceList->CmdBuffer);
+			CopyImVector(list->IdxBuffer, sourceList->IdxBuffer);
+			CopyImVector(list->VtxBuffer, sourceList->VtxBuffer);
+			list->Flags = sourceList->Flags;
+		}
+
+		copy.Data = *source;
+		copy.Data.CmdLists = copy.Lists.data();
+	}
+
 	ImGuiLayer::ImGuiLayer()
 		: Layer("ImGuiLayer")
-	{}
+	{
+		Subscribe<KeyPressedEvent>(ENG_BIND_EVENT_FN(ImGuiLayer::OnInputEvent));
+		Subscribe<KeyReleasedEvent>(ENG_BIND_EVENT_FN(ImGuiLayer::OnInputEvent));
+		Subscribe<KeyTypedEvent>(ENG_BIND_EVENT_FN(ImGuiLayer::OnInputEvent));
+		Subscribe<MouseButtonPressedEvent>(ENG_BIND_EVENT_FN(ImGuiLayer::OnInputEvent));
+		Subscribe<MouseButtonReleasedEvent>(ENG_BIND_EVENT_FN(ImGuiLayer::OnInputEvent));
+		Subscribe<MouseMovedEvent>(ENG_BIND_EVENT_FN(ImGuiLayer::OnInputEvent));
+		Subscribe<MouseScrolledEvent>(ENG_BIND_EVENT_FN(ImGuiLayer::OnInputEvent));
+	}
 
 	ImGuiLayer::~ImGuiLayer()
 	{}
@@ -59,26 +110,35 @@ namespace Engine
 		GLFWwindow* window = static_cast<GLFWwindow*>(app.GetWindow().GetNativeWindow());
 
 		ImGui_ImplGlfw_InitForOpenGL(window, true);
-		ImGui_ImplOpenGL3_Init("#version 410");
+		RenderThread::ExecuteAndWait([] () {
+			ImGui_ImplOpenGL3_Init("#version 410");
+			ImGui_ImplOpenGL3_CreateDeviceObjects();
+			});
 	}
 
 	void ImGuiLayer::OnDetach()
 	{
 		ENG_PROFILE_FUNCTION();
 
+		for (ImGuiDrawDataCopy& copy : s_drawDataCopies)
+		{
+			for (ImDrawList* list : copy.Lists)
+				IM_DELETE(list);
+		}
+		s_drawDataCopies.clear();
+
 		ImGui_ImplOpenGL3_Shutdown();
 		ImGui_ImplGlfw_Shutdown();
 		ImGui::DestroyContext();
 	}
 
-	void ImGuiLayer::OnEvent(Event& e)
+	bool ImGuiLayer::OnInputEvent(Event& e)
 	{
-		if (m_blockEvents)
-		{
-			ImGuiIO& io = ImGui::GetIO();
-			e.handled |= e.IsInCategory(EventCategoryMouse) & io.WantCaptureMouse;
-			e.handled |= e.IsInCategory(EventCategoryKeyboard) & io.WantCaptureKeyboard;
-		}
+		if (!m_blockEvents)
+			return false;
+
+		ImGuiIO& io = ImGui::GetIO();
+		return (e.IsInCategory(EventCategoryMouse) && io.WantCaptureMouse) || (e.IsInCategory(EventCategoryKeyboard) && io.WantCaptureKeyboard);
 	}
 
 	void ImGuiLayer::Begin()
@@ -101,15 +161,61 @@ namespace Engine
 
 		// Rendering
 		ImGui::Render();
-		ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+
+		// The last copies are free once the render thread is done, and the platform windows can only be created
+		// or destroyed while it doesn't draw into them
+		RenderThread::WaitForIdle();
+
+		if (s_drawDataCopies.empty())
+			s_drawDataCopies.resize(1);
+		CopyDrawData(ImGui::GetDrawData(), s_drawDataCopies[0]);
+		uint32_t count = 1;
 
 		if (io.ConfigFlags & ImGuiConfigFlags_ViewportsEnable)
 		{
+			// Creating a platform window makes its context current
 			GLFWwindow* backupCurrentContext = glfwGetCurrentContext();
 			ImGui::UpdatePlatformWindows();
-			ImGui::RenderPlatformWindowsDefault();
 			glfwMakeContextCurrent(backupCurrentContext);
+
+			ImGuiPlatformIO& platformIO = ImGui::GetPlatformIO();
+			for (int i = 1; i < platformIO.Viewports.Size; i++)
+			{
+				ImGuiViewport* viewport = platformIO.Viewports[i];
+				if (viewport->Flags & ImGuiViewportFlags_Minimized)
+					continue;
+
+				if (s_drawDataCopies.size() == count)
+					s_drawDataCopies.emplace_back();
+
+				ImGuiDrawDataCopy& copy = s_drawDataCopies[count++];
+				copy.Window = static_cast<GLFWwindow*>(viewport->PlatformHandle);
+				copy.Clear = !(viewport->Flags & ImGuiViewportFlags_NoRendererClear);
+				CopyDrawData(viewport->DrawData, copy);
+			}
 		}
+
+		GLFWwindow* window = static_cast<GLFWwindow*>(app.GetWindow().GetNativeWindow());
+		RenderThread::Submit([window, count] () {
+			ImGui_ImplOpenGL3_RenderDrawData(&s_drawDataCopies[0].Data);
+
+			for (uint32_t i = 1; i < count; i++)
+			{
+				ImGuiDrawDataCopy& copy = s_drawDataCopies[i];
+
+				glfwMakeContextCurrent(copy.Window);
+				if (copy.Clear)
+				{
+					glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+					glClear(GL_COLOR_BUFFER_BIT);
+				}
+				ImGui_ImplOpenGL3_RenderDrawData(&copy.Data);
+				glfwSwapBuffers(copy.Window);
+			}
+
+			if (count > 1)
+				glfwMakeContextCurrent(window);
+			});
 	}
 
 	void ImGuiLayer::SetDarkThemeColors()
@@ -15,7 +15,6 @@ namespace Engine
 
 		virtual void OnAttach() override;
 		virtual void OnDetach() override;
-		virtual void OnEvent(Event& e) override;
 
 		void Begin();
 		void End();
@@ -23,6 +22,9 @@ namespace Engine
 		void BlockEvents(bool block) { m_blockEvents = block; }
 
 		void SetDarkThemeColors();
+	private:
+		bool OnInputEvent(Event& e);
+
 	private:
 		bool m_blockEvents = true;
 	};
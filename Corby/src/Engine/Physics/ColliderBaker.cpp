@@ -0,0 +1,98 @@
+#include "engpch.h"
+#include "ColliderBaker.h"
+
+namespace Engine
+{
+	// Directions in counterclockwise order, turning left is the next direction
+	enum Direction : uint8_t { PositiveX = 0, PositiveY, NegativeX, NegativeY, DirectionCount };
+
+	static const int32_t s_directionX[DirectionCount] = { 1, 0, -1, 0 };
+	static const int32_t s_directionY[DirectionCount] = { 0, 1, 0, -1 };
+
+	std::vector<ChainCollider2DComponent::Chain> ColliderBaker::BakeTilemap(const TilemapComponent& tilemap)
+	{
+		ENG_PROFILE_FUNCTION();
+
+		std::vector<ChainCollider2DComponent::Chain> chains;
+
+		uint32_t width = tilemap.GetWidth();
+		uint32_t height = tilemap.GetHeight();
+		if (width == 0 || height == 0)
+			return chains;
+
+		uint32_t stride = width + 1;
+		auto solid = [&] (int32_t x, int32_t y) {
+			return x >= 0 && y >= 0 && tilemap.GetTile((uint32_t) x, (uint32_t) y) != TilemapComponent::EmptyTile;
+		};
+
+		// Every tile side facing an empty tile becomes an edge leaving one of the grid corners, one bit per direction.
+		// Edges keep the tile on their left, which makes outlines counterclockwise and holes clockwise.
+		std::vector<uint8_t> edges((size_t) stride * (height + 1), 0);
+		for (int32_t y = 0; y < (int32_t) height; y++)
+		{
+			for (int32_t x = 0; x < (int32_t) width; x++)
+			{
+				if (!solid(x, y))
+					continue;
+
+				if (!solid(x, y - 1))
+					edges[(size_t) y * stride + x] |= 1 << PositiveX;
+				if (!solid(x + 1, y))
+					edges[(size_t) y * stride + x + 1] |= 1 << PositiveY;
+				if (!solid(x, y + 1))
+					edges[(size_t) (y + 1) * stride + x + 1] |= 1 << NegativeX;
+				if (!solid(x - 1, y))
+					edges[(size_t) (y + 1) * stride + x] |= 1 << NegativeY;
+			}
+		}
+
+		// Where two tiles only touch at a corner, a corner has two edges leaving it. Preferring the left turn keeps
+		// following the tile we came along, which makes the next edge a fixed function of the current one.
+		auto nextDirection = [&] (size_t corner, uint8_t direction) {
+			for (int turn : { 1, 0, 3 })
+			{
+				uint8_t next = (uint8_t) ((direction + turn) % DirectionCount);
+				if (edges[corner] & (1 << next))
+					return next;
+			}
+
+			ENG_CORE_ASSERT(false, "Tile outline is not closed!");
+			return direction;
+		};
+
+		std::vector<uint8_t> visited(edges.size(), 0);
+		for (size_t start = 0; start < edges.size(); start++)
+		{
+			for (uint8_t startDirection = 0; startDirection < DirectionCount; startDirection++)
+			{
+				if (!(edges[start] & ~visited[start] & (1 << startDirection)))
+					continue;
+
+				// Walk the loop and keep only the corners where it changes direction
+				auto& chain = chains.emplace_back();
+				size_t corner = start;
+				uint8_t direction = startDirection;
+
+				while (!(visited[corner] & (1 << direction)))
+				{
+					visited[corner] |= 1 << direction;
+
+					int32_t x = (int32_t) (corner % stride) + s_directionX[direction];
+					int32_t y = (int32_t) (corner / stride) + s_directionY[direction];
+					size_t nextCorner = (size_t) y * stride + x;
+					uint8_t next = nextDirection(nextCorner, direction);
+
+					if (next != direction)
+						chain.Vertices.push_back(glm::vec2((float) x, (float) y));
+
+					corner = nextCorner;
+					direction = next;
+				}
+
+				ENG_CORE_ASSERT(corner == start && direction == startDirection, "Tile outline is not closed!");
+			}
+		}
+
+		return chains;
+	}
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include "Engine/Scene/Components.h"
+
+namespace Engine
+{
+	// Turns level data into a handful of chain shapes, so the physics world does not have to deal with a body per tile
+	class ColliderBaker
+	{
+	public:
+		// Traces the outlines of all non-empty tiles into closed loops in tilemap space, one unit per tile.
+		// Adjacent tiles merge into a single loop and straight runs of tile edges into a single edge.
+		static std::vector<ChainCollider2DComponent::Chain> BakeTilemap(const TilemapComponent& tilemap);
+	};
+}
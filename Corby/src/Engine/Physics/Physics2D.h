@@ -0,0 +1,16 @@
+#pragma once
+
+#include "Engine/Scene/Entity.h"
+
+#include <glm/glm.hpp>
+
+namespace Engine
+{
+	struct RaycastHit2D
+	{
+		Entity HitEntity;
+		glm::vec2 Point = { 0.0f, 0.0f };
+		glm::vec2 Normal = { 0.0f, 0.0f };
+		float Fraction = 0.0f; // Position of the hit along the ray, 0 at the start and 1 at the end
+	};
+}
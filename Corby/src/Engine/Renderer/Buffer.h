@@ -10,7 +10,8 @@ namespace Engine
 	// -----------------------------------------
 	enum class ShaderDataType
 	{
-		None = 0, Float, Float2, Float3, Float4, Mat3, Mat4, Int, Int2, Int3, Int4, Bool
+		None = 0, Float, Float2, Float3, Float4, Mat3, Mat4, Int, Int2, Int3, Int4, Bool,
+		UInt, Half2, UByte4
 	};
 
 	static unsigned int ShaderDataTypeSize(ShaderDataType type)
@@ -28,6 +29,9 @@ namespace Engine
 			case ShaderDataType::Int3:		return 4 * 3;
 			case ShaderDataType::Int4:		return 4 * 4;
 			case ShaderDataType::Bool:		return 1;
+			case ShaderDataType::UInt:		return 4;
+			case ShaderDataType::Half2:		return 2 * 2;
+			case ShaderDataType::UByte4:	return 1 * 4;
 		}
 
 		ENG_CORE_ASSERT(false, "Unknown ShaderDataType!");
@@ -66,6 +70,9 @@ namespace Engine
 				case ShaderDataType::Int3:		return 3;
 				case ShaderDataType::Int4:		return 4;
 				case ShaderDataType::Bool:		return 1;
+				case ShaderDataType::UInt:		return 1;
+				case ShaderDataType::Half2:		return 2;
+				case ShaderDataType::UByte4:	return 4;
 			}
 
 			ENG_CORE_ASSERT(false, "Unknown ShaderDataType!");
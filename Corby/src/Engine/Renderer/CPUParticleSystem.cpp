@@ -0,0 +1,113 @@
+#include "engpch.h"
+#include "CPUParticleSystem.h"
+
+#include "Engine/Renderer/Renderer2D.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace Engine
+{
+	CPUParticleSystem::CPUParticleSystem(uint32_t maxParticles)
+		: m_maxParticles(maxParticles)
+	{
+		m_positionX.resize(maxParticles);
+		m_positionY.resize(maxParticles);
+		m_velocityX.resize(maxParticles);
+		m_velocityY.resize(maxParticles);
+		m_age.resize(maxParticles);
+		m_lifeTime.resize(maxParticles);
+	}
+
+	void CPUParticleSystem::OnUpdate(Timestep ts, const glm::mat4& emitterTransform, const ParticleProps& props)
+	{
+		ENG_PROFILE_FUNCTION();
+
+		const float dt = ts;
+		const float gravityX = props.Gravity.x * dt;
+		const float gravityY = props.Gravity.y * dt;
+
+		// Integrate
+		{
+			float* __restrict positionX = m_positionX.data();
+			float* __restrict positionY = m_positionY.data();
+			float* __restrict velocityX = m_velocityX.data();
+			float* __restrict velocityY = m_velocityY.data();
+			float* __restrict age = m_age.data();
+
+			for (uint32_t i = 0; i < m_aliveCount; i++)
+			{
+				velocityX[i] += gravityX;
+				velocityY[i] += gravityY;
+				positionX[i] += velocityX[i] * dt;
+				positionY[i] += velocityY[i] * dt;
+				age[i] += dt;
+			}
+		}
+
+		// Kill, dead particles are replaced by the last alive one to keep the arrays packed
+		for (uint32_t i = 0; i < m_aliveCount;)
+		{
+			if (m_age[i] < m_lifeTime[i])
+			{
+				i++;
+				continue;
+			}
+
+			uint32_t last = --m_aliveCount;
+			m_positionX[i] = m_positionX[last];
+			m_positionY[i] = m_positionY[last];
+			m_velocityX[i] = m_velocityX[last];
+			m_velocityY[i] = m_velocityY[last];
+			m_age[i] = m_age[last];
+			m_lifeTime[i] = m_lifeTime[last];
+		}
+
+		// Emit
+		m_emitAccumulator += props.EmissionRate * dt;
+		uint32_t emitCount = (uint32_t) m_emitAccumulator;
+		m_emitAccumulator -= (float) emitCount;
+
+		m_positionZ = emitterTransform[3].z;
+		Emit(std::min(emitCount, m_maxParticles - m_aliveCount), glm::vec3(emitterTransform[3]), props);
+	}
+
+	void CPUParticleSystem::OnRender(const ParticleProps& props, int entityID)
+	{
+		ENG_PROFILE_FUNCTION();
+
+		for (uint32_t i = 0; i < m_aliveCount; i++)
+		{
+			float life = m_age[i] / m_lifeTime[i];
+			glm::vec4 color = glm::mix(props.ColorBegin, props.ColorEnd, life);
+			float size = glm::mix(props.SizeBegin, props.SizeEnd, life);
+
+			glm::mat4 transform = glm::translate(glm::mat4(1.0f), { m_positionX[i], m_positionY[i], m_positionZ })
+				* glm::scale(glm::mat4(1.0f), { size, size, 1.0f });
+			Renderer2D::DrawCircle(transform, color, 1.0f, 0.5f, entityID);
+		}
+	}
+
+	void CPUParticleSystem::Emit(uint32_t count, const glm::vec3& position, const ParticleProps& props)
+	{
+		for (uint32_t i = m_aliveCount; i < m_aliveCount + count; i++)
+		{
+			m_positionX[i] = position.x;
+			m_positionY[i] = position.y;
+			m_velocityX[i] = props.Velocity.x + props.VelocityVariation.x * (NextRandom() - 0.5f);
+			m_velocityY[i] = props.Velocity.y + props.VelocityVariation.y * (NextRandom() - 0.5f);
+			m_age[i] = 0.0f;
+			m_lifeTime[i] = props.LifeTime;
+		}
+
+		m_aliveCount += count;
+	}
+
+	float CPUParticleSystem::NextRandom()
+	{
+		// xorshift32
+		m_randomState ^= m_randomState << 13;
+		m_randomState ^= m_randomState >> 17;
+		m_randomState ^= m_randomState << 5;
+		return (float) m_randomState / (float) std::numeric_limits<uint32_t>::max();
+	}
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "Engine/Renderer/ParticleSystem.h"
+
+namespace Engine
+{
+	// Fallback for when there is no GPU to simulate on. Particles are stored as a structure of arrays with
+	// the alive ones packed at the front, so the integration loop runs over contiguous floats and vectorizes.
+	// Simulation does not touch the renderer, only OnRender does.
+	class CPUParticleSystem : public ParticleSystem
+	{
+	public:
+		CPUParticleSystem(uint32_t maxParticles);
+
+		virtual void OnUpdate(Timestep ts, const glm::mat4& emitterTransform, const ParticleProps& props) override;
+		virtual void OnRender(const ParticleProps& props, int entityID = -1) override;
+
+		virtual uint32_t GetMaxParticles() const override { return m_maxParticles; }
+		uint32_t GetAliveCount() const { return m_aliveCount; }
+
+	private:
+		void Emit(uint32_t count, const glm::vec3& position, const ParticleProps& props);
+		float NextRandom();
+
+	private:
+		uint32_t m_maxParticles = 0;
+		uint32_t m_aliveCount = 0;
+		float m_emitAccumulator = 0.0f;
+		uint32_t m_randomState = 0x9e3779b9u;
+		float m_positionZ = 0.0f;
+
+		std::vector<float> m_positionX;
+		std::vector<float> m_positionY;
+		std::vector<float> m_velocityX;
+		std::vector<float> m_velocityY;
+		std::vector<float> m_age;
+		std::vector<float> m_lifeTime;
+	};
+}
@@ -58,13 +58,10 @@ namespace Engine
 		m_cameraTranslationSpeed = m_zoomLevel;
 	}
 
-	void CameraController::OnEvent(Event& e)
+	void CameraController::Subscribe(Layer& layer)
 	{
-		ENG_PROFILE_FUNCTION();
-
-		EventDispatcher dispatcher(e);
-		dispatcher.Dispatch<MouseScrolledEvent>(ENG_BIND_EVENT_FN(CameraController::OnMouseScrolled));
-		dispatcher.Dispatch<WindowResizeEvent>(ENG_BIND_EVENT_FN(CameraController::OnWindowResized));
+		layer.Subscribe<MouseScrolledEvent>(ENG_BIND_EVENT_FN(CameraController::OnMouseScrolled));
+		layer.Subscribe<WindowResizeEvent>(ENG_BIND_EVENT_FN(CameraController::OnWindowResized));
 	}
 
 	void CameraController::OnResize(float width, float height)
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "Engine/Core/Layer.h"
 #include "Engine/Core/Timestep.h"
 #include "Engine/Events/ApplicationEvent.h"
 #include "Engine/Events/MouseEvent.h"
@@ -13,7 +14,8 @@ namespace Engine
 		CameraController(float aspectRatio, bool rotation = false);
 
 		void OnUpdate(Timestep ts);
-		void OnEvent(Event& e);
+		// Registers the scroll and resize handlers with the layer that owns the controller
+		void Subscribe(Layer& layer);
 		void OnResize(float width, float height);
 
 		OrthographicCamera& GetCamera() { return m_camera; }
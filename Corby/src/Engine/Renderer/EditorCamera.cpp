@@ -37,10 +37,9 @@ namespace Engine
 		UpdateView();
 	}
 
-	void EditorCamera::OnEvent(Event& e)
+	void EditorCamera::Subscribe(Layer& layer)
 	{
-		EventDispatcher dispatcher(e);
-		dispatcher.Dispatch<MouseScrolledEvent>(ENG_BIND_EVENT_FN(EditorCamera::OnMouseScroll));
+		layer.Subscribe<MouseScrolledEvent>(ENG_BIND_EVENT_FN(EditorCamera::OnMouseScroll));
 	}
 
 	float EditorCamera::GetDistance() const
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "Engine/Core/Layer.h"
 #include "Engine/Core/Timestep.h"
 #include "Engine/Events/Event.h"
 #include "Engine/Events/MouseEvent.h"
@@ -16,7 +17,8 @@ namespace Engine
 		EditorCamera(float fov, float aspectRatio, float nearClip, float farClip);
 
 		void OnUpdate(Timestep ts);
-		void OnEvent(Event& e);
+		// Registers the scroll handler with the layer that owns the camera
+		void Subscribe(Layer& layer);
 
 		float GetDistance() const;
 		void SetDistance(float distance);
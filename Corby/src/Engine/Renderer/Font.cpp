@@ -0,0 +1,155 @@
+#include "engpch.h"
+#include "Font.h"
+
+#include <yaml-cpp/yaml.h>
+
+namespace Engine
+{
+	static uint64_t KerningKey(uint32_t first, uint32_t second)
+	{
+		return ((uint64_t) first << 32) | second;
+	}
+
+	Font::Font(const std::filesystem::path& fontPath)
+		: m_path(fontPath)
+	{
+		ENG_PROFILE_FUNCTION();
+
+		std::filesystem::path atlasPath = fontPath;
+		atlasPath.replace_extension(".png");
+		std::filesystem::path layoutPath = fontPath;
+		layoutPath.replace_extension(".json");
+
+		if (!std::filesystem::exists(atlasPath) || !std::filesystem::exists(layoutPath))
+		{
+			ENG_CORE_ERROR("Font '{0}' has not been baked, run scripts/BakeFont.py first", fontPath.string());
+			return;
+		}
+
+		m_atlasTexture = Texture2D::Create(atlasPath.string());
+		if (!m_atlasTexture->IsLoaded())
+		{
+			ENG_CORE_ERROR("Could not load font atlas '{0}'", atlasPath.string());
+			return;
+		}
+
+		m_isLoaded = LoadLayout(layoutPath);
+	}
+
+	bool Font::LoadLayout(const std::filesystem::path& layoutPath)
+	{
+		YAML::Node data;
+		try
+		{
+			data = YAML::LoadFile(layoutPath.string());
+		} catch (const YAML::ParserException& e)
+		{
+			ENG_CORE_ERROR("Could not parse font layout '{0}': {1}", layoutPath.string(), e.what());
+			return false;
+		}
+
+		auto atlas = data["atlas"];
+		auto metrics = data["metrics"];
+		auto glyphs = data["glyphs"];
+		if (!atlas || !metrics || !glyphs)
+		{
+			ENG_CORE_ERROR("Font layout '{0}' is not an msdf-atlas-gen layout", layoutPath.string());
+			return false;
+		}
+
+		m_distanceRange = atlas["distanceRange"].as<float>();
+		float atlasWidth = atlas["width"].as<float>();
+		float atlasHeight = atlas["height"].as<float>();
+
+		// Texture2D flips images on load, so texture coordinates expect a bottom-left origin
+		bool yOriginTop = atlas["yOrigin"] && atlas["yOrigin"].as<std::string>() == "top";
+
+		m_metrics.LineHeight = metrics["lineHeight"].as<float>();
+		m_metrics.Ascender = metrics["ascender"].as<float>();
+		m_metrics.Descender = metrics["descender"].as<float>();
+
+		for (auto glyphNode : glyphs)
+		{
+			uint32_t codepoint = glyphNode["unicode"].as<uint32_t>();
+
+			Glyph glyph;
+			glyph.Advance = glyphNode["advance"].as<float>();
+
+			auto planeBounds = glyphNode["planeBounds"];
+			auto atlasBounds = glyphNode["atlasBounds"];
+			if (planeBounds && atlasBounds)
+			{
+				glyph.Visible = true;
+				glyph.PlaneMin = { planeBounds["left"].as<float>(), planeBounds["bottom"].as<float>() };
+				glyph.PlaneMax = { planeBounds["right"].as<float>(), planeBounds["top"].as<float>() };
+
+				float bottom = atlasBounds["bottom"].as<float>();
+				float top = atlasBounds["top"].as<float>();
+				if (yOriginTop)
+				{
+					bottom = atlasHeight - bottom;
+					top = atlasHeight - top;
+				}
+
+				glyph.TexCoordMin = { atlasBounds["left"].as<float>() / atlasWidth, bottom / atlasHeight };
+				glyph.TexCoordMax = { atlasBounds["right"].as<float>() / atlasWidth, top / atlasHeight };
+			}
+
+			if (codepoint < AsciiGlyphCount)
+				m_asciiGlyphs[codepoint] = glyph;
+			else
+				m_glyphs[codepoint] = glyph;
+		}
+
+		auto kerning = data["kerning"];
+		if (kerning)
+		{
+			for (auto pair : kerning)
+			{
+				uint64_t key = KerningKey(pair["unicode1"].as<uint32_t>(), pair["unicode2"].as<uint32_t>());
+				m_kerning[key] = pair["advance"].as<float>();
+			}
+		}
+
+		ENG_CORE_TRACE("Loaded font '{0}' with {1} glyphs", m_path.string(), glyphs.size());
+		return true;
+	}
+
+	const Glyph* Font::GetGlyph(uint32_t codepoint) const
+	{
+		if (codepoint < AsciiGlyphCount)
+			return &m_asciiGlyphs[codepoint];
+
+		auto it = m_glyphs.find(codepoint);
+		if (it == m_glyphs.end())
+			return nullptr;
+
+		return &it->second;
+	}
+
+	float Font::GetKerning(uint32_t first, uint32_t second) const
+	{
+		if (m_kerning.empty())
+			return 0.0f;
+
+		auto it = m_kerning.find(KerningKey(first, second));
+		return it == m_kerning.end() ? 0.0f : it->second;
+	}
+
+	Ref<Font> Font::Load(const std::filesystem::path& fontPath)
+	{
+		static std::unordered_map<std::string, Ref<Font>> s_fontCache;
+
+		std::string key = fontPath.string();
+		auto it = s_fontCache.find(key);
+		if (it != s_fontCache.end())
+			return it->second;
+
+		Ref<Font> font = CreateRef<Font>(fontPath);
+		if (!font->IsLoaded())
+			return nullptr;
+
+		s_fontCache[key] = font;
+		return font;
+	}
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "Engine/Core/Base.h"
+#include "Engine/Renderer/Texture.h"
+
+#include <filesystem>
+#include <glm/glm.hpp>
+
+namespace Engine
+{
+	struct Glyph
+	{
+		// Quad bounds relative to the pen position, in em units
+		glm::vec2 PlaneMin = { 0.0f, 0.0f };
+		glm::vec2 PlaneMax = { 0.0f, 0.0f };
+
+		// Normalized texture coordinates in the atlas
+		glm::vec2 TexCoordMin = { 0.0f, 0.0f };
+		glm::vec2 TexCoordMax = { 0.0f, 0.0f };
+
+		float Advance = 0.0f;
+		bool Visible = false;
+	};
+
+	struct FontMetrics
+	{
+		float LineHeight = 1.0f;
+		float Ascender = 1.0f;
+		float Descender = 0.0f;
+	};
+
+	// Multi-channel signed distance field font. The atlas is baked offline by msdf-atlas-gen
+	// (see scripts/BakeFont.py), this only loads the resulting image and glyph layout.
+	class Font
+	{
+	public:
+		Font(const std::filesystem::path& fontPath);
+
+		const Glyph* GetGlyph(uint32_t codepoint) const;
+		float GetKerning(uint32_t first, uint32_t second) const;
+
+		const FontMetrics& GetMetrics() const { return m_metrics; }
+		float GetDistanceRange() const { return m_distanceRange; }
+		const Ref<Texture2D>& GetAtlasTexture() const { return m_atlasTexture; }
+		const std::filesystem::path& GetPath() const { return m_path; }
+
+		bool IsLoaded() const { return m_isLoaded; }
+
+		static Ref<Font> Load(const std::filesystem::path& fontPath);
+
+	private:
+		bool LoadLayout(const std::filesystem::path& layoutPath);
+
+	private:
+		static constexpr uint32_t AsciiGlyphCount = 128;
+
+		std::filesystem::path m_path;
+		bool m_isLoaded = false;
+
+		FontMetrics m_metrics;
+		float m_distanceRange = 2.0f;
+		Ref<Texture2D> m_atlasTexture;
+
+		// ASCII glyphs are looked up by index, everything else goes through the map
+		std::array<Glyph, AsciiGlyphCount> m_asciiGlyphs;
+		std::unordered_map<uint32_t, Glyph> m_glyphs;
+		std::unordered_map<uint64_t, float> m_kerning;
+	};
+}
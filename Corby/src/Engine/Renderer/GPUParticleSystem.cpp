@@ -0,0 +1,202 @@
+#include "engpch.h"
+#include "GPUParticleSystem.h"
+
+#include "Engine/Renderer/RenderCommand.h"
+#include "Engine/Renderer/Renderer2D.h"
+#include "Engine/Renderer/Shader.h"
+#include "Engine/Renderer/UniformBuffer.h"
+#include "Engine/Renderer/VertexArray.h"
+
+#include <numeric>
+
+namespace Engine
+{
+	static const uint32_t ParticleGroupSize = 256;
+
+	// Matches the Particle struct in the particle shaders (std430)
+	struct GPUParticle
+	{
+		glm::vec2 Position;
+		glm::vec2 Velocity;
+		float Age;
+		float LifeTime;
+		glm::vec2 Padding;
+	};
+
+	// Matches the Arguments block in the particle shaders (std430). The compute passes write the
+	// dispatch and draw arguments so the counts never have to travel back to the CPU.
+	struct ParticleArguments
+	{
+		uint32_t EmitGroups[3];
+		uint32_t SimulateGroups[3];
+
+		uint32_t DrawIndexCount;
+		uint32_t DrawInstanceCount;
+		uint32_t DrawFirstIndex;
+		int32_t DrawBaseVertex;
+		uint32_t DrawBaseInstance;
+
+		uint32_t AliveCount;
+		uint32_t DeadCount;
+		uint32_t EmitCount;
+	};
+
+	static const uint32_t EmitArgumentsOffset = offsetof(ParticleArguments, EmitGroups);
+	static const uint32_t SimulateArgumentsOffset = offsetof(ParticleArguments, SimulateGroups);
+	static const uint32_t DrawArgumentsOffset = offsetof(ParticleArguments, DrawIndexCount);
+
+	// Matches the Emitter uniform block in the particle shaders (std140)
+	struct EmitterData
+	{
+		glm::vec4 Position;
+		glm::vec4 ColorBegin;
+		glm::vec4 ColorEnd;
+		glm::vec2 Velocity;
+		glm::vec2 VelocityVariation;
+		glm::vec2 Gravity;
+		float SizeBegin;
+		float SizeEnd;
+		float LifeTime;
+		float DeltaTime;
+		uint32_t EmitRequest;
+		uint32_t MaxParticles;
+		uint32_t RandomSeed;
+		int EntityID;
+		float Padding[2];
+	};
+
+	struct GPUParticleData
+	{
+		Ref<Shader> KickoffShader;
+		Ref<Shader> EmitShader;
+		Ref<Shader> SimulateShader;
+		Ref<Shader> RenderShader;
+
+		Ref<VertexArray> QuadVertexArray;
+		Ref<UniformBuffer> EmitterUniformBuffer;
+	};
+
+	static Scope<GPUParticleData> s_data;
+
+	static void InitSharedData()
+	{
+		ENG_PROFILE_FUNCTION();
+
+		s_data = CreateScope<GPUParticleData>();
+
+		s_data->KickoffShader = Shader::Create("assets/shaders/ParticleKickoff.glsl");
+		s_data->EmitShader = Shader::Create("assets/shaders/ParticleEmit.glsl");
+		s_data->SimulateShader = Shader::Create("assets/shaders/ParticleSimulate.glsl");
+		s_data->RenderShader = Shader::Create("assets/shaders/Particle.glsl");
+
+		// Corners are generated in the vertex shader, the vertex array only carries the indices
+		uint32_t quadIndices[] = { 0, 1, 2, 2, 3, 0 };
+		s_data->QuadVertexArray = VertexArray::Create();
+		s_data->QuadVertexArray->SetIndexBuffer(IndexBuffer::Create(quadIndices, 6));
+
+		s_data->EmitterUniformBuffer = UniformBuffer::Create(sizeof(EmitterData), 1);
+	}
+
+	void GPUParticleSystem::Shutdown()
+	{
+		s_data.reset();
+	}
+
+	GPUParticleSystem::GPUParticleSystem(uint32_t maxParticles)
+		: m_maxParticles(maxParticles)
+	{
+		ENG_PROFILE_FUNCTION();
+
+		if (!s_data)
+			InitSharedData();
+
+		m_particleBuffer = StorageBuffer::Create(maxParticles * sizeof(GPUParticle));
+		m_aliveLists[0] = StorageBuffer::Create(maxParticles * sizeof(uint32_t));
+		m_aliveLists[1] = StorageBuffer::Create(maxParticles * sizeof(uint32_t));
+
+		// Every particle starts out dead
+		std::vector<uint32_t> deadList(maxParticles);
+		std::iota(deadList.begin(), deadList.end(), 0);
+		m_deadList = StorageBuffer::Create(maxParticles * sizeof(uint32_t), deadList.data());
+
+		ParticleArguments arguments = {};
+		arguments.EmitGroups[1] = arguments.EmitGroups[2] = 1;
+		arguments.SimulateGroups[1] = arguments.SimulateGroups[2] = 1;
+		arguments.DrawIndexCount = 6;
+		arguments.DeadCount = maxParticles;
+		m_argumentBuffer = StorageBuffer::Create(sizeof(ParticleArguments), &arguments);
+	}
+
+	void GPUParticleSystem::OnUpdate(Timestep ts, const glm::mat4& emitterTransform, const ParticleProps& props)
+	{
+		ENG_PROFILE_FUNCTION();
+
+		m_emitAccumulator += props.EmissionRate * ts;
+		uint32_t emitCount = (uint32_t) m_emitAccumulator;
+		m_emitAccumulator -= (float) emitCount;
+
+		m_emitterPosition = glm::vec3(emitterTransform[3]);
+		UploadEmitterData(props, ts, emitCount, -1);
+		BindBuffers();
+
+		// Kickoff clamps the emit count to the free particles and writes the dispatch arguments for this frame
+		s_data->KickoffShader->Bind();
+		RenderCommand::DispatchCompute(1);
+		RenderCommand::StorageBufferBarrier();
+
+		s_data->EmitShader->Bind();
+		RenderCommand::DispatchComputeIndirect(m_argumentBuffer, EmitArgumentsOffset);
+		RenderCommand::StorageBufferBarrier();
+
+		s_data->SimulateShader->Bind();
+		RenderCommand::DispatchComputeIndirect(m_argumentBuffer, SimulateArgumentsOffset);
+		RenderCommand::StorageBufferBarrier();
+
+		// Survivors were compacted into the other list
+		m_currentAliveList = 1 - m_currentAliveList;
+		m_frameIndex++;
+	}
+
+	void GPUParticleSystem::OnRender(const ParticleProps& props, int entityID)
+	{
+		ENG_PROFILE_FUNCTION();
+
+		Renderer2D::NextBatch();
+
+		UploadEmitterData(props, 0.0f, 0, entityID);
+		BindBuffers();
+
+		s_data->RenderShader->Bind();
+		RenderCommand::DrawIndexedIndirect(s_data->QuadVertexArray, m_argumentBuffer, DrawArgumentsOffset);
+	}
+
+	void GPUParticleSystem::UploadEmitterData(const ParticleProps& props, float deltaTime, uint32_t emitCount, int entityID)
+	{
+		EmitterData data = {};
+		data.Position = glm::vec4(m_emitterPosition, 1.0f);
+		data.ColorBegin = props.ColorBegin;
+		data.ColorEnd = props.ColorEnd;
+		data.Velocity = props.Velocity;
+		data.VelocityVariation = props.VelocityVariation;
+		data.Gravity = props.Gravity;
+		data.SizeBegin = props.SizeBegin;
+		data.SizeEnd = props.SizeEnd;
+		data.LifeTime = props.LifeTime;
+		data.DeltaTime = deltaTime;
+		data.EmitRequest = emitCount;
+		data.MaxParticles = m_maxParticles;
+		data.RandomSeed = m_frameIndex * 0x9e3779b9u;
+		data.EntityID = entityID;
+
+		s_data->EmitterUniformBuffer->SetData(&data, sizeof(EmitterData));
+	}
+
+	void GPUParticleSystem::BindBuffers() const
+	{
+		m_particleBuffer->Bind(0);
+		m_aliveLists[m_currentAliveList]->Bind(1);
+		m_aliveLists[1 - m_currentAliveList]->Bind(2);
+		m_deadList->Bind(3);
+		m_argumentBuffer->Bind(4);
+	}
+}
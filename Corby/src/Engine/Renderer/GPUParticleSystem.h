@@ -0,0 +1,39 @@
+#pragma once
+
+#include "Engine/Renderer/ParticleSystem.h"
+#include "Engine/Renderer/StorageBuffer.h"
+
+namespace Engine
+{
+	// Spawning, integration, killing and compaction all run in compute shaders. Alive particles are
+	// tracked in two index lists that swap every frame, the simulate pass writes the survivors into the
+	// other list and counts them straight into the indirect draw arguments, so the CPU never reads back.
+	class GPUParticleSystem : public ParticleSystem
+	{
+	public:
+		GPUParticleSystem(uint32_t maxParticles);
+
+		virtual void OnUpdate(Timestep ts, const glm::mat4& emitterTransform, const ParticleProps& props) override;
+		virtual void OnRender(const ParticleProps& props, int entityID = -1) override;
+
+		virtual uint32_t GetMaxParticles() const override { return m_maxParticles; }
+
+		static void Shutdown();
+
+	private:
+		void UploadEmitterData(const ParticleProps& props, float deltaTime, uint32_t emitCount, int entityID);
+		void BindBuffers() const;
+
+	private:
+		uint32_t m_maxParticles = 0;
+		float m_emitAccumulator = 0.0f;
+		uint32_t m_frameIndex = 0;
+		glm::vec3 m_emitterPosition = { 0.0f, 0.0f, 0.0f };
+
+		Ref<StorageBuffer> m_particleBuffer;
+		Ref<StorageBuffer> m_aliveLists[2];
+		Ref<StorageBuffer> m_deadList;
+		Ref<StorageBuffer> m_argumentBuffer;
+		uint32_t m_currentAliveList = 0;
+	};
+}
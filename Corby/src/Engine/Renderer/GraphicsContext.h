@@ -10,6 +10,10 @@ namespace Engine
 		virtual void Init() = 0;
 		virtual void SwapBuffers() = 0;
 
+		// The render thread takes the context over from the thread that created it
+		virtual void MakeCurrent() = 0;
+		virtual void ReleaseCurrent() = 0;
+
 		static Scope<GraphicsContext> Create(void* window);
 	};
 };
@@ -0,0 +1,33 @@
+#include "engpch.h"
+#include "ParticleSystem.h"
+
+#include "Engine/Renderer/CPUParticleSystem.h"
+#include "Engine/Renderer/GPUParticleSystem.h"
+#include "Engine/Renderer/Renderer.h"
+
+namespace Engine
+{
+	Ref<ParticleSystem> ParticleSystem::Create(uint32_t maxParticles)
+	{
+		switch (Renderer::GetAPI())
+		{
+			case RendererAPI::API::None:
+			{
+				return CreateRef<CPUParticleSystem>(maxParticles);
+			}
+
+			case RendererAPI::API::OpenGL:
+			{
+				return CreateRef<GPUParticleSystem>(maxParticles);
+			}
+		}
+
+		ENG_CORE_ASSERT(false, "Unknown RendererAPI!");
+		return nullptr;
+	}
+
+	void ParticleSystem::Shutdown()
+	{
+		GPUParticleSystem::Shutdown();
+	}
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "Engine/Core/Base.h"
+#include "Engine/Core/Timestep.h"
+
+#include <glm/glm.hpp>
+
+namespace Engine
+{
+	struct ParticleProps
+	{
+		uint32_t MaxParticles = 100000;
+		float EmissionRate = 10000.0f; // Particles per second
+		float LifeTime = 1.0f;
+
+		glm::vec2 Velocity = { 0.0f, 2.0f };
+		glm::vec2 VelocityVariation = { 1.0f, 1.0f };
+		glm::vec2 Gravity = { 0.0f, -1.0f };
+
+		glm::vec4 ColorBegin = { 1.0f, 1.0f, 1.0f, 1.0f };
+		glm::vec4 ColorEnd = { 1.0f, 1.0f, 1.0f, 0.0f };
+		float SizeBegin = 0.05f;
+		float SizeEnd = 0.0f;
+	};
+
+	// Particles are simulated in world space, moving the emitter only moves where new particles spawn
+	class ParticleSystem
+	{
+	public:
+		virtual ~ParticleSystem() = default;
+
+		virtual void OnUpdate(Timestep ts, const glm::mat4& emitterTransform, const ParticleProps& props) = 0;
+		// Has to be called between Renderer2D::BeginScene and Renderer2D::EndScene
+		virtual void OnRender(const ParticleProps& props, int entityID = -1) = 0;
+
+		virtual uint32_t GetMaxParticles() const = 0;
+
+		// Simulates on the GPU when the renderer supports it, on the CPU otherwise
+		static Ref<ParticleSystem> Create(uint32_t maxParticles);
+
+		static void Shutdown();
+	};
+}
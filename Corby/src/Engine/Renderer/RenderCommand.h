@@ -1,45 +1,89 @@
 #pragma once
 
 #include "Engine/Renderer/RendererAPI.h"
+#include "Engine/Renderer/RenderThread.h"
 
 namespace Engine
 {
+	// Commands are recorded and run on the render thread
 	class RenderCommand
 	{
 	public:
 		static void Init()
 		{
-			s_rendererAPI->Init();
+			RenderThread::Submit([] () {
+				s_rendererAPI->Init();
+				});
 		}
 
 		static void SetViewport(uint32_t x, uint32_t y, uint32_t width, uint32_t height)
 		{
-			s_rendererAPI->SetViewport(x, y, width, height);
+			RenderThread::Submit([x, y, width, height] () {
+				s_rendererAPI->SetViewport(x, y, width, height);
+				});
 		}
 
 		static void SetClearColor(const glm::vec4& color)
 		{
-			s_rendererAPI->SetClearColor(color);
+			RenderThread::Submit([color] () {
+				s_rendererAPI->SetClearColor(color);
+				});
 		}
 
 		static void Clear()
 		{
-			s_rendererAPI->Clear();
+			RenderThread::Submit([] () {
+				s_rendererAPI->Clear();
+				});
 		}
 
 		static void DrawIndexed(const Ref<VertexArray>& vertexArray, uint32_t indexCount = 0)
 		{
-			s_rendererAPI->DrawIndexed(vertexArray, indexCount);
+			RenderThread::Submit([vertexArray, indexCount] () {
+				s_rendererAPI->DrawIndexed(vertexArray, indexCount);
+				});
 		}
 
 		static void DrawLines(const Ref<VertexArray>& vertexArray, uint32_t vertexCount)
 		{
-			s_rendererAPI->DrawLines(vertexArray, vertexCount);
+			RenderThread::Submit([vertexArray, vertexCount] () {
+				s_rendererAPI->DrawLines(vertexArray, vertexCount);
+				});
+		}
+
+		static void DrawIndexedIndirect(const Ref<VertexArray>& vertexArray, const Ref<StorageBuffer>& argumentBuffer, uint32_t offset = 0)
+		{
+			RenderThread::Submit([vertexArray, argumentBuffer, offset] () {
+				s_rendererAPI->DrawIndexedIndirect(vertexArray, argumentBuffer, offset);
+				});
+		}
+
+		static void DispatchCompute(uint32_t groupCountX, uint32_t groupCountY = 1, uint32_t groupCountZ = 1)
+		{
+			RenderThread::Submit([groupCountX, groupCountY, groupCountZ] () {
+				s_rendererAPI->DispatchCompute(groupCountX, groupCountY, groupCountZ);
+				});
+		}
+
+		static void DispatchComputeIndirect(const Ref<StorageBuffer>& argumentBuffer, uint32_t offset = 0)
+		{
+			RenderThread::Submit([argumentBuffer, offset] () {
+				s_rendererAPI->DispatchComputeIndirect(argumentBuffer, offset);
+				});
+		}
+
+		static void StorageBufferBarrier()
+		{
+			RenderThread::Submit([] () {
+				s_rendererAPI->StorageBufferBarrier();
+				});
 		}
 
 		static void SetLineWidth(float width)
 		{
-			s_rendererAPI->SetLineWidth(width);
+			RenderThread::Submit([width] () {
+				s_rendererAPI->SetLineWidth(width);
+				});
 		}
 
 	private:
@@ -0,0 +1,97 @@
+#include "engpch.h"
+#include "RenderCommandQueue.h"
+
+namespace Engine
+{
+	// Data blocks have no function and are skipped when the queue executes
+	struct CommandHeader
+	{
+		RenderCommandQueue::CommandFunction Function;
+		uint32_t Size;
+	};
+
+	static constexpr uint32_t AlignSize(uint32_t size)
+	{
+		return (size + RenderCommandQueue::Alignment - 1) & ~(RenderCommandQueue::Alignment - 1);
+	}
+
+	static constexpr uint32_t HeaderSize = AlignSize(sizeof(CommandHeader));
+
+	RenderCommandQueue::RenderCommandQueue(uint32_t pageSize)
+		: m_pageSize(pageSize)
+	{
+		m_pages.push_back({ Scope<uint8_t[]>(new uint8_t[pageSize]), pageSize, 0 });
+	}
+
+	RenderCommandQueue::~RenderCommandQueue()
+	{}
+
+	void* RenderCommandQueue::Allocate(CommandFunction function, uint32_t size)
+	{
+		uint8_t* memory = Reserve(HeaderSize + AlignSize(size));
+
+		CommandHeader* header = (CommandHeader*) memory;
+		header->Function = function;
+		header->Size = AlignSize(size);
+
+		m_commandCount++;
+		return memory + HeaderSize;
+	}
+
+	void* RenderCommandQueue::AllocateData(uint32_t size)
+	{
+		uint8_t* memory = Reserve(HeaderSize + AlignSize(size));
+
+		CommandHeader* header = (CommandHeader*) memory;
+		header->Function = nullptr;
+		header->Size = AlignSize(size);
+
+		return memory + HeaderSize;
+	}
+
+	void RenderCommandQueue::Execute()
+	{
+		ENG_PROFILE_FUNCTION();
+
+		for (uint32_t i = 0; i <= m_currentPage; i++)
+		{
+			Page& page = m_pages[i];
+
+			uint32_t offset = 0;
+			while (offset < page.Size)
+			{
+				CommandHeader* header = (CommandHeader*) (page.Buffer.get() + offset);
+				if (header->Function)
+					header->Function(page.Buffer.get() + offset + HeaderSize);
+
+				offset += HeaderSize + header->Size;
+			}
+
+			page.Size = 0;
+		}
+
+		m_currentPage = 0;
+		m_commandCount = 0;
+	}
+
+	uint8_t* RenderCommandQueue::Reserve(uint32_t size)
+	{
+		Page* page = &m_pages[m_currentPage];
+		if (page->Size + size > page->Capacity)
+		{
+			// Pages stay allocated for the next frames, a page only grows the queue when none of the spare ones fit
+			m_currentPage++;
+			if (m_currentPage == m_pages.size() || m_pages[m_currentPage].Capacity < size)
+			{
+				uint32_t capacity = std::max(m_pageSize, size);
+				m_pages.insert(m_pages.begin() + m_currentPage, { Scope<uint8_t[]>(new uint8_t[capacity]), capacity, 0 });
+			}
+
+			page = &m_pages[m_currentPage];
+		}
+
+		uint8_t* memory = page->Buffer.get() + page->Size;
+		page->Size += size;
+		return memory;
+	}
+}
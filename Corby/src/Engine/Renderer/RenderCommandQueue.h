@@ -0,0 +1,71 @@
+#pragma once
+
+#include "Engine/Core/Base.h"
+
+#include <new>
+#include <type_traits>
+#include <vector>
+
+namespace Engine
+{
+	// Linear buffer of recorded render commands. Every command is a function pointer followed by its payload,
+	// recording never calls into the graphics API and executing runs the commands in the order they came in.
+	// Memory is kept in pages that are reused every frame, so pointers into the queue stay valid until it is executed.
+	class RenderCommandQueue
+	{
+	public:
+		using CommandFunction = void(*)(void* payload);
+
+		RenderCommandQueue(uint32_t pageSize = 1024 * 1024);
+		~RenderCommandQueue();
+
+		RenderCommandQueue(const RenderCommandQueue&) = delete;
+		RenderCommandQueue& operator=(const RenderCommandQueue&) = delete;
+
+		// Returns the memory for the payload, the function receives it when the command runs
+		void* Allocate(CommandFunction function, uint32_t size);
+
+		// Memory that is only read by other commands, such as vertex data, it lives until the queue is executed
+		void* AllocateData(uint32_t size);
+
+		template<typename Function>
+		void Submit(Function&& function)
+		{
+			using Command = std::decay_t<Function>;
+			static_assert(alignof(Command) <= Alignment, "Render commands can't be over aligned!");
+
+			auto execute = [] (void* payload) {
+				Command* command = (Command*) payload;
+				(*command)();
+				command->~Command();
+			};
+
+			void* payload = Allocate(execute, sizeof(Command));
+			new (payload) Command(std::forward<Function>(function));
+		}
+
+		// Runs all recorded commands and resets the queue
+		void Execute();
+
+		uint32_t GetCommandCount() const { return m_commandCount; }
+
+	public:
+		static const uint32_t Alignment = 16;
+
+	private:
+		struct Page
+		{
+			Scope<uint8_t[]> Buffer;
+			uint32_t Capacity = 0;
+			uint32_t Size = 0;
+		};
+
+		uint8_t* Reserve(uint32_t size);
+
+	private:
+		std::vector<Page> m_pages;
+		uint32_t m_currentPage = 0;
+		uint32_t m_pageSize;
+		uint32_t m_commandCount = 0;
+	};
+}
@@ -0,0 +1,182 @@
+#include "engpch.h"
+#include "RenderThread.h"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace Engine
+{
+	struct ExecuteRequest
+	{
+		const std::function<void()>* Function;
+		bool Done = false;
+	};
+
+	struct RenderThreadData
+	{
+		GraphicsContext* Context = nullptr;
+		std::thread Thread;
+		std::thread::id ThreadID;
+		bool Started = false; // Only touched by the main thread
+
+		std::mutex Mutex;
+		std::condition_variable Condition;
+		bool Running = false;
+		bool FramePending = false; // The queue that is not recorded into waits for the render thread
+		std::deque<ExecuteRequest*> Requests;
+
+		RenderCommandQueue Queues[2];
+		uint32_t RecordIndex = 0;
+	};
+
+	static RenderThreadData s_data;
+
+	static void RenderThreadMain()
+	{
+		s_data.Context->MakeCurrent();
+
+		std::unique_lock<std::mutex> lock(s_data.Mutex);
+		while (true)
+		{
+			s_data.Condition.wait(lock, [] () { return !s_data.Requests.empty() || s_data.FramePending || !s_data.Running; });
+
+			while (!s_data.Requests.empty())
+			{
+				ExecuteRequest* request = s_data.Requests.front();
+				s_data.Requests.pop_front();
+
+				lock.unlock();
+				(*request->Function)();
+				lock.lock();
+
+				request->Done = true;
+				s_data.Condition.notify_all();
+			}
+
+			if (s_data.FramePending)
+			{
+				RenderCommandQueue& queue = s_data.Queues[1 - s_data.RecordIndex];
+
+				lock.unlock();
+				queue.Execute();
+				lock.lock();
+
+				s_data.FramePending = false;
+				s_data.Condition.notify_all();
+			} else if (!s_data.Running)
+			{
+				break;
+			}
+		}
+
+		s_data.Context->ReleaseCurrent();
+	}
+
+	void RenderThread::Init(GraphicsContext& context)
+	{
+		ENG_PROFILE_FUNCTION();
+
+		ENG_CORE_ASSERT(!s_data.Started, "Render thread already running!");
+
+		// The context can only be current on one thread
+		context.ReleaseCurrent();
+
+		s_data.Context = &context;
+		s_data.Running = true;
+		s_data.Thread = std::thread(RenderThreadMain);
+		s_data.ThreadID = s_data.Thread.get_id();
+		s_data.Started = true;
+	}
+
+	void RenderThread::Shutdown()
+	{
+		ENG_PROFILE_FUNCTION();
+
+		if (!s_data.Started)
+			return;
+
+		// Commands still hold resources, they have to run while the context is there
+		EndFrame();
+
+		{
+			std::lock_guard<std::mutex> lock(s_data.Mutex);
+			s_data.Running = false;
+		}
+		s_data.Condition.notify_all();
+		s_data.Thread.join();
+
+		s_data.Started = false;
+		s_data.Context->MakeCurrent();
+	}
+
+	const void* RenderThread::CopyCommandData(const void* data, uint32_t size)
+	{
+		if (RunsImmediately())
+			return data;
+
+		void* copy = GetRecordQueue().AllocateData(size);
+		memcpy(copy, data, size);
+		return copy;
+	}
+
+	void RenderThread::ExecuteAndWait(const std::function<void()>& function)
+	{
+		if (RunsImmediately())
+		{
+			function();
+			return;
+		}
+
+		ENG_PROFILE_FUNCTION();
+
+		ExecuteRequest request = { &function };
+
+		std::unique_lock<std::mutex> lock(s_data.Mutex);
+		s_data.Requests.push_back(&request);
+		s_data.Condition.notify_all();
+		s_data.Condition.wait(lock, [&request] () { return request.Done; });
+	}
+
+	void RenderThread::EndFrame()
+	{
+		ENG_PROFILE_FUNCTION();
+
+		if (!s_data.Started)
+			return;
+
+		std::unique_lock<std::mutex> lock(s_data.Mutex);
+		s_data.Condition.wait(lock, [] () { return !s_data.FramePending; });
+
+		s_data.RecordIndex = 1 - s_data.RecordIndex;
+		s_data.FramePending = true;
+		s_data.Condition.notify_all();
+	}
+
+	void RenderThread::WaitForIdle()
+	{
+		ENG_PROFILE_FUNCTION();
+
+		if (!s_data.Started)
+			return;
+
+		std::unique_lock<std::mutex> lock(s_data.Mutex);
+		s_data.Condition.wait(lock, [] () { return !s_data.FramePending; });
+	}
+
+	bool RenderThread::IsRenderThread()
+	{
+		return s_data.Started && std::this_thread::get_id() == s_data.ThreadID;
+	}
+
+	bool RenderThread::RunsImmediately()
+	{
+		return !s_data.Started || std::this_thread::get_id() == s_data.ThreadID;
+	}
+
+	RenderCommandQueue& RenderThread::GetRecordQueue()
+	{
+		return s_data.Queues[s_data.RecordIndex];
+	}
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "Engine/Core/Base.h"
+#include "Engine/Renderer/GraphicsContext.h"
+#include "Engine/Renderer/RenderCommandQueue.h"
+
+#include <functional>
+
+namespace Engine
+{
+	// Owns the graphics context and replays the commands the main thread recorded. Commands are recorded into one
+	// queue while the render thread executes the other, so the update of the next frame overlaps with the graphics
+	// API work of the last one. Before Init and after Shutdown there is no render thread and everything runs right
+	// away on the calling thread, which then owns the context.
+	class RenderThread
+	{
+	public:
+		static void Init(GraphicsContext& context);
+		static void Shutdown();
+
+		// Records a command. Everything it uses has to be captured by value, objects can be gone by the time it
+		// runs. Called on the render thread itself the command runs right away. Only the main thread records.
+		template<typename Function>
+		static void Submit(Function&& function)
+		{
+			if (RunsImmediately())
+				function();
+			else
+				GetRecordQueue().Submit(std::forward<Function>(function));
+		}
+
+		// Copies data the recorded commands read, such as vertices, so the caller can reuse its memory right away.
+		// Where commands run right away the data is used as it is.
+		static const void* CopyCommandData(const void* data, uint32_t size);
+
+		// Runs the function on the render thread and returns once it ran, for creating resources and reading back.
+		// It runs between frames, ahead of the commands recorded for the current one.
+		static void ExecuteAndWait(const std::function<void()>& function);
+
+		// Hands the recorded frame to the render thread once it is done with the last one
+		static void EndFrame();
+		// Returns once the render thread executed every frame handed to it
+		static void WaitForIdle();
+
+		static bool IsRenderThread();
+
+	private:
+		static bool RunsImmediately();
+		static RenderCommandQueue& GetRecordQueue();
+	};
+}
@@ -1,22 +1,30 @@
 #include "engpch.h"
 #include "Renderer.h"
 
+#include "Engine/Renderer/ParticleSystem.h"
 #include "Engine/Renderer/Renderer2D.h"
+#include "Engine/Renderer/RenderThread.h"
 
 namespace Engine
 {
 	Scope<Renderer::SceneData> Renderer::m_sceneData = CreateScope<Renderer::SceneData>();
 
-	void Renderer::Init()
+	void Renderer::Init(GraphicsContext& context)
 	{
 		ENG_PROFILE_FUNCTION();
 
+		RenderThread::Init(context);
+
 		RenderCommand::Init();
 		Renderer2D::Init();
 	}
 
 	void Renderer::Shutdown()
 	{
+		// Runs what is still recorded, resources released from here on are deleted right away
+		RenderThread::Shutdown();
+
+		ParticleSystem::Shutdown();
 		Renderer2D::Shutdown();
 	}
 
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "Engine/Renderer/GraphicsContext.h"
 #include "Engine/Renderer/OrthographicCamera.h"
 #include "Engine/Renderer/RenderCommand.h"
 #include "Engine/Renderer/Shader.h"
@@ -9,7 +10,8 @@ namespace Engine
 	class Renderer
 	{
 	public:
-		static void Init();
+		// Starts the render thread, which takes the context over
+		static void Init(GraphicsContext& context);
 		static void Shutdown();
 
 		static void OnWindowResize(uint32_t width, uint32_t height);
@@ -7,8 +7,15 @@
 #include "Engine/Renderer/VertexArray.h"
 
 #include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/packing.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+// Set to 1 to submit quads with the compact 28 byte vertex layout instead of the 48 byte one.
+// Colors are clamped to [0, 1] and texture coordinates lose precision on atlases larger than 2048 pixels.
+#ifndef ENG_RENDERER2D_PACKED_QUADS
+#define ENG_RENDERER2D_PACKED_QUADS 0
+#endif
+
 namespace Engine
 {
 	struct QuadVertex
@@ -22,6 +29,22 @@ namespace Engine
 		int EntityID;
 	};
 
+	struct PackedQuadVertex
+	{
+		glm::vec3 Position;
+		uint32_t Color;				// RGBA8 normalized
+		uint32_t TexCoord;			// 2x half float
+		uint32_t TexIndexTiling;	// Texture slot in the low 8 bits, half float tiling factor in the high 16 bits
+
+		int EntityID;
+	};
+
+	#if ENG_RENDERER2D_PACKED_QUADS
+	using QuadVertexFormat = PackedQuadVertex;
+	#else
+	using QuadVertexFormat = QuadVertex;
+	#endif
+
 	struct CircleVertex
 	{
 		glm::vec3 WorldPosition;
@@ -41,6 +64,15 @@ namespace Engine
 		int EntityID;
 	};
 
+	struct TextVertex
+	{
+		glm::vec3 Position;
+		glm::vec4 Color;
+		glm::vec2 TexCoord;
+
+		int EntityID;
+	};
+
 	struct Renderer2DData
 	{
 		static const uint32_t MaxQuads = 20000;
@@ -61,9 +93,13 @@ namespace Engine
 		Ref<VertexBuffer> LineVertexBuffer;
 		Ref<Shader> LineShader;
 
+		Ref<VertexArray> TextVertexArray;
+		Ref<VertexBuffer> TextVertexBuffer;
+		Ref<Shader> TextShader;
+
 		uint32_t QuadIndexCount = 0;
-		QuadVertex* QuadVertexBufferBase = nullptr;
-		QuadVertex* QuadVertexBufferPtr = nullptr;
+		QuadVertexFormat* QuadVertexBufferBase = nullptr;
+		QuadVertexFormat* QuadVertexBufferPtr = nullptr;
 
 		uint32_t CircleIndexCount = 0;
 		CircleVertex* CircleVertexBufferBase = nullptr;
@@ -74,6 +110,11 @@ namespace Engine
 		LineVertex* LineVertexBufferPtr = nullptr;
 		float LineWidth = 2.0f;
 
+		uint32_t TextIndexCount = 0;
+		TextVertex* TextVertexBufferBase = nullptr;
+		TextVertex* TextVertexBufferPtr = nullptr;
+		Ref<Texture2D> FontAtlasTexture;
+
 		std::array<Ref<Texture2D>, MaxTextureSlots> TextureSlots;
 		uint32_t TextureSlotIndex = 1;
 
@@ -91,24 +132,71 @@ namespace Engine
 
 	static Renderer2DData s_data;
 
-	void Renderer2D::Init()
+	static void WriteQuadVertex(QuadVertex* vertex, const glm::vec3& position, const glm::vec4& color, const glm::vec2& texCoord, float textureIndex, float tilingFactor, int entityID)
 	{
-		ENG_PROFILE_FUNCTION();
+		vertex->Position = position;
+		vertex->Color = color;
+		vertex->TexCoord = texCoord;
+		vertex->TexIndex = textureIndex;
+		vertex->TilingFactor = tilingFactor;
+		vertex->EntityID = entityID;
+	}
 
-		// Quad vertex array + buffer
-		s_data.QuadVertexArray = VertexArray::Create();
-		s_data.QuadVertexBuffer = VertexBuffer::Create(s_data.MaxVertices * sizeof(QuadVertex));
+	static void WriteQuadVertex(PackedQuadVertex* vertex, const glm::vec3& position, const glm::vec4& color, const glm::vec2& texCoord, float textureIndex, float tilingFactor, int entityID)
+	{
+		vertex->Position = position;
+		vertex->Color = glm::packUnorm4x8(color);
+		vertex->TexCoord = glm::packHalf2x16(texCoord);
+		vertex->TexIndexTiling = glm::packHalf2x16({ 0.0f, tilingFactor }) | ((uint32_t) textureIndex & 0xff);
+		vertex->EntityID = entityID;
+	}
 
-		s_data.QuadVertexBuffer->SetLayout({
+	static BufferLayout GetQuadVertexLayout()
+	{
+		#if ENG_RENDERER2D_PACKED_QUADS
+		return {
+			{ ShaderDataType::Float3, "a_Position"			},
+			{ ShaderDataType::UByte4, "a_Color", true		},
+			{ ShaderDataType::Half2,  "a_TexCoord"			},
+			{ ShaderDataType::UInt,   "a_TexIndexTiling"	},
+			{ ShaderDataType::Int,    "a_EntityID"			}
+		};
+		#else
+		return {
 			{ ShaderDataType::Float3, "a_Position"		},
 			{ ShaderDataType::Float4, "a_Color"			},
 			{ ShaderDataType::Float2, "a_TexCoord"		},
 			{ ShaderDataType::Float,  "a_TexIndex"		},
 			{ ShaderDataType::Float,  "a_TilingFactor"	},
 			{ ShaderDataType::Int,    "a_EntityID"		}
-			});
+		};
+		#endif
+	}
+
+	static void SubmitQuad(const glm::mat4& transform, const glm::vec4& color, const glm::vec2* textureCoords, float textureIndex, float tilingFactor, int entityID)
+	{
+		constexpr size_t QuadVertexCount = 4;
+
+		for (size_t i = 0; i < QuadVertexCount; i++)
+		{
+			WriteQuadVertex(s_data.QuadVertexBufferPtr, transform * s_data.QuadVertexPositions[i], color, textureCoords[i], textureIndex, tilingFactor, entityID);
+			s_data.QuadVertexBufferPtr++;
+		}
+
+		s_data.QuadIndexCount += 6;
+		s_data.Stats.QuadCount++;
+	}
+
+	void Renderer2D::Init()
+	{
+		ENG_PROFILE_FUNCTION();
+
+		// Quad vertex array + buffer
+		s_data.QuadVertexArray = VertexArray::Create();
+		s_data.QuadVertexBuffer = VertexBuffer::Create(s_data.MaxVertices * sizeof(QuadVertexFormat));
+		s_data.QuadVertexBuffer->SetLayout(GetQuadVertexLayout());
 		s_data.QuadVertexArray->AddVertexBuffer(s_data.QuadVertexBuffer);
-		s_data.QuadVertexBufferBase = new QuadVertex[s_data.MaxVertices];
+		s_data.QuadVertexBufferBase = new QuadVertexFormat[s_data.MaxVertices];
 
 		// Quad index buffer
 		uint32_t* QuadIndices = new uint32_t[s_data.MaxIndices];
@@ -161,6 +249,21 @@ namespace Engine
 		s_data.LineVertexArray->AddVertexBuffer(s_data.LineVertexBuffer);
 		s_data.LineVertexBufferBase = new LineVertex[s_data.MaxVertices];
 
+		// Text vertex array + buffer
+		s_data.TextVertexArray = VertexArray::Create();
+		s_data.TextVertexBuffer = VertexBuffer::Create(s_data.MaxVertices * sizeof(TextVertex));
+
+		s_data.TextVertexBuffer->SetLayout({
+			{ ShaderDataType::Float3, "a_Position"	},
+			{ ShaderDataType::Float4, "a_Color"		},
+			{ ShaderDataType::Float2, "a_TexCoord"	},
+			{ ShaderDataType::Int,    "a_EntityID"	}
+			});
+
+		s_data.TextVertexArray->AddVertexBuffer(s_data.TextVertexBuffer);
+		s_data.TextVertexArray->SetIndexBuffer(quadIB);
+		s_data.TextVertexBufferBase = new TextVertex[s_data.MaxVertices];
+
 		// White texture slot
 		s_data.WhiteTexture = Texture2D::Create(1, 1);
 		uint32_t whiteTextureData = 0xffffffff;
@@ -171,9 +274,14 @@ namespace Engine
 			samplers[i] = i;
 
 		// Create shaders
+		#if ENG_RENDERER2D_PACKED_QUADS
+		s_data.QuadShader = Shader::Create("assets/shaders/2DQuadPacked.glsl");
+		#else
 		s_data.QuadShader = Shader::Create("assets/shaders/2DQuad.glsl");
+		#endif
 		s_data.CircleShader = Shader::Create("assets/shaders/2DCircle.glsl");
 		s_data.LineShader = Shader::Create("assets/shaders/2DLine.glsl");
+		s_data.TextShader = Shader::Create("assets/shaders/2DText.glsl");
 
 		// Set first texture slot to 0
 		s_data.TextureSlots[0] = s_data.WhiteTexture;
@@ -193,6 +301,7 @@ namespace Engine
 		delete[] s_data.QuadVertexBufferBase;
 		delete[] s_data.CircleVertexBufferBase;
 		delete[] s_data.LineVertexBufferBase;
+		delete[] s_data.TextVertexBufferBase;
 	}
 
 	void Renderer2D::BeginScene(const Camera& camera, const glm::mat4& transform)
@@ -275,6 +384,19 @@ namespace Engine
 			RenderCommand::DrawLines(s_data.LineVertexArray, s_data.LineVertexCount);
 			s_data.Stats.DrawCalls++;
 		}
+
+		if (s_data.TextIndexCount)
+		{
+			// Calculate data size
+			uint32_t dataSize = (uint32_t) ((uint8_t*) s_data.TextVertexBufferPtr - (uint8_t*) s_data.TextVertexBufferBase);
+			s_data.TextVertexBuffer->SetData(s_data.TextVertexBufferBase, dataSize);
+
+			// Create draw call
+			s_data.FontAtlasTexture->Bind(0);
+			s_data.TextShader->Bind();
+			RenderCommand::DrawIndexed(s_data.TextVertexArray, s_data.TextIndexCount);
+			s_data.Stats.DrawCalls++;
+		}
 	}
 
 	void Renderer2D::DrawQuad(const glm::vec2& position, const glm::vec2& size, const glm::vec4& color)
@@ -320,7 +442,6 @@ namespace Engine
 	{
 		ENG_PROFILE_FUNCTION();
 
-		constexpr size_t QuadVertexCount = 4;
 		const float textureIndex = 0.0f; // White Texture
 		constexpr glm::vec2 textureCoords[] = { { 0.0f, 0.0f }, { 1.0f, 0.0f }, { 1.0f, 1.0f }, { 0.0f, 1.0f } };
 		const float tilingFactor = 1.0f;
@@ -328,26 +449,13 @@ namespace Engine
 		if (s_data.QuadIndexCount >= Renderer2DData::MaxIndices)
 			NextBatch();
 
-		for (size_t i = 0; i < QuadVertexCount; i++)
-		{
-			s_data.QuadVertexBufferPtr->Position = transform * s_data.QuadVertexPositions[i];
-			s_data.QuadVertexBufferPtr->Color = color;
-			s_data.QuadVertexBufferPtr->TexCoord = textureCoords[i];
-			s_data.QuadVertexBufferPtr->TexIndex = textureIndex;
-			s_data.QuadVertexBufferPtr->TilingFactor = tilingFactor;
-			s_data.QuadVertexBufferPtr->EntityID = entityID;
-			s_data.QuadVertexBufferPtr++;
-		}
-
-		s_data.QuadIndexCount += 6;
-		s_data.Stats.QuadCount++;
+		SubmitQuad(transform, color, textureCoords, textureIndex, tilingFactor, entityID);
 	}
 
 	void Renderer2D::DrawQuad(const glm::mat4& transform, const Ref<Texture2D>& texture, float tilingFactor, const glm::vec4& tintColor, int entityID)
 	{
 		ENG_PROFILE_FUNCTION();
 
-		constexpr size_t QuadVertexCount = 4;
 		constexpr glm::vec2 textureCoords[] = { { 0.0f, 0.0f }, { 1.0f, 0.0f }, { 1.0f, 1.0f }, { 0.0f, 1.0f } };
 
 		if (s_data.QuadIndexCount >= Renderer2DData::MaxIndices)
@@ -373,27 +481,13 @@ namespace Engine
 			s_data.TextureSlotIndex++;
 		}
 
-		for (size_t i = 0; i < QuadVertexCount; i++)
-		{
-			s_data.QuadVertexBufferPtr->Position = transform * s_data.QuadVertexPositions[i];
-			s_data.QuadVertexBufferPtr->Color = tintColor;
-			s_data.QuadVertexBufferPtr->TexCoord = textureCoords[i];
-			s_data.QuadVertexBufferPtr->TexIndex = textureIndex;
-			s_data.QuadVertexBufferPtr->TilingFactor = tilingFactor;
-			s_data.QuadVertexBufferPtr->EntityID = entityID;
-			s_data.QuadVertexBufferPtr++;
-		}
-
-		s_data.QuadIndexCount += 6;
-
-		s_data.Stats.QuadCount++;
+		SubmitQuad(transform, tintColor, textureCoords, textureIndex, tilingFactor, entityID);
 	}
 
 	void Renderer2D::DrawQuad(const glm::mat4& transform, const Ref<SubTexture2D>& subtexture, float tilingFactor, const glm::vec4& tintColor, int entityID)
 	{
 		ENG_PROFILE_FUNCTION();
 
-		constexpr size_t QuadVertexCount = 4;
 		const glm::vec2* textureCoords = subtexture->GetTexCoords();
 		const Ref<Texture2D> texture = subtexture->GetTexture();
 
@@ -421,19 +515,7 @@ namespace Engine
 			s_data.TextureSlotIndex++;
 		}
 
-		for (size_t i = 0; i < QuadVertexCount; i++)
-		{
-			s_data.QuadVertexBufferPtr->Position = transform * s_data.QuadVertexPositions[i];
-			s_data.QuadVertexBufferPtr->Color = tintColor;
-			s_data.QuadVertexBufferPtr->TexCoord = textureCoords[i];
-			s_data.QuadVertexBufferPtr->TexIndex = textureIndex;
-			s_data.QuadVertexBufferPtr->TilingFactor = tilingFactor;
-			s_data.QuadVertexBufferPtr->EntityID = entityID;
-			s_data.QuadVertexBufferPtr++;
-		}
-
-		s_data.QuadIndexCount += 6;
-		s_data.Stats.QuadCount++;
+		SubmitQuad(transform, tintColor, textureCoords, textureIndex, tilingFactor, entityID);
 	}
 
 	void Renderer2D::DrawRotatedQuad(const glm::vec2& position, const glm::vec2& size, float rotation, const glm::vec4& color)
@@ -555,6 +637,202 @@ namespace Engine
 			DrawQuad(transform, src.Color, entityID);
 	}
 
+	void Renderer2D::DrawStaticBatch(const StaticBatch2D& batch)
+	{
+		ENG_PROFILE_FUNCTION();
+
+		NextBatch();
+
+		for (const auto& segment : batch.m_segments)
+		{
+			if (!segment.VertexArray)
+				continue;
+
+			// Bind textures
+			for (uint32_t i = 0; i < segment.TextureSlotIndex; i++)
+				segment.TextureSlots[i]->Bind(i);
+
+			// Create draw call
+			s_data.QuadShader->Bind();
+			RenderCommand::DrawIndexed(segment.VertexArray, segment.QuadCount * 6);
+			s_data.Stats.DrawCalls++;
+			s_data.Stats.QuadCount += segment.QuadCount;
+		}
+
+		for (const auto& segment : batch.m_circleSegments)
+		{
+			if (!segment.VertexArray)
+				continue;
+
+			s_data.CircleShader->Bind();
+			RenderCommand::DrawIndexed(segment.VertexArray, segment.CircleCount * 6);
+			s_data.Stats.DrawCalls++;
+			s_data.Stats.QuadCount += segment.CircleCount;
+		}
+	}
+
+	void Renderer2D::DrawTilemap(const glm::mat4& transform, TilemapComponent& tilemap, int entityID)
+	{
+		ENG_PROFILE_FUNCTION();
+
+		if (!tilemap.Spritesheet)
+			return;
+
+		// Tiles are baked in world space, so moving the tilemap rebuilds all of its chunks
+		if (tilemap.BakedTransform != transform)
+		{
+			tilemap.BakedTransform = transform;
+			tilemap.Invalidate();
+		}
+
+		uint32_t chunkCountX = tilemap.GetChunkCountX();
+		auto& chunks = tilemap.GetChunks();
+		for (uint32_t chunkIndex = 0; chunkIndex < chunks.size(); chunkIndex++)
+		{
+			auto& chunk = chunks[chunkIndex];
+			if (chunk.Dirty)
+			{
+				ENG_PROFILE_SCOPE("Renderer2D::DrawTilemap - Rebuild chunk");
+
+				if (!chunk.Batch)
+					chunk.Batch = CreateRef<StaticBatch2D>();
+				chunk.Batch->Clear();
+
+				uint32_t originX = (chunkIndex % chunkCountX) * TilemapComponent::ChunkSize;
+				uint32_t originY = (chunkIndex / chunkCountX) * TilemapComponent::ChunkSize;
+
+				for (uint32_t y = 0; y < TilemapComponent::ChunkSize; y++)
+				{
+					for (uint32_t x = 0; x < TilemapComponent::ChunkSize; x++)
+					{
+						int32_t tile = tilemap.GetTile(originX + x, originY + y);
+						if (tile == TilemapComponent::EmptyTile)
+							continue;
+
+						const Ref<SubTexture2D>& subtexture = tilemap.GetTileTexture(tile);
+						if (!subtexture)
+							continue;
+
+						// Each tile covers one unit, the tilemap origin is the bottom left corner of tile (0, 0)
+						glm::vec3 position = { originX + x + 0.5f, originY + y + 0.5f, 0.0f };
+						chunk.Batch->AddQuad(glm::translate(transform, position), subtexture, 1.0f, glm::vec4(1.0f), entityID);
+					}
+				}
+
+				chunk.Batch->Upload();
+				chunk.Dirty = false;
+			}
+
+			DrawStaticBatch(*chunk.Batch);
+		}
+	}
+
+	// Decodes one UTF-8 sequence and advances the iterator past it
+	static uint32_t NextCodepoint(std::string::const_iterator& it, std::string::const_iterator end)
+	{
+		uint8_t lead = (uint8_t) *it++;
+		if (lead < 0x80)
+			return lead;
+
+		uint32_t trailingBytes = lead >= 0xf0 ? 3 : lead >= 0xe0 ? 2 : 1;
+		uint32_t codepoint = lead & (0x3f >> trailingBytes);
+
+		for (uint32_t i = 0; i < trailingBytes && it != end; i++)
+			codepoint = (codepoint << 6) | ((uint8_t) *it++ & 0x3f);
+
+		return codepoint;
+	}
+
+	void Renderer2D::DrawString(const std::string& text, const Ref<Font>& font, const glm::mat4& transform, const glm::vec4& color, float kerning, float lineSpacing, int entityID)
+	{
+		ENG_PROFILE_FUNCTION();
+
+		if (!font || text.empty())
+			return;
+
+		// Strings using a different font atlas can't share a draw call
+		if (s_data.FontAtlasTexture && !(*s_data.FontAtlasTexture == *font->GetAtlasTexture()))
+			NextBatch();
+
+		s_data.FontAtlasTexture = font->GetAtlasTexture();
+
+		const FontMetrics& metrics = font->GetMetrics();
+		float fsScale = 1.0f / (metrics.Ascender - metrics.Descender);
+		glm::vec2 pen = { 0.0f, 0.0f };
+		uint32_t previous = 0;
+
+		for (auto it = text.begin(); it != text.end();)
+		{
+			uint32_t codepoint = NextCodepoint(it, text.end());
+
+			if (codepoint == '\r')
+				continue;
+
+			if (codepoint == '\n')
+			{
+				pen.x = 0.0f;
+				pen.y -= fsScale * metrics.LineHeight + lineSpacing;
+				previous = 0;
+				continue;
+			}
+
+			const Glyph* glyph = font->GetGlyph(codepoint);
+			if (!glyph)
+				glyph = font->GetGlyph('?');
+			if (!glyph)
+				continue;
+
+			if (previous)
+				pen.x += fsScale * font->GetKerning(previous, codepoint);
+
+			if (glyph->Visible)
+			{
+				if (s_data.TextIndexCount >= Renderer2DData::MaxIndices)
+				{
+					NextBatch();
+					s_data.FontAtlasTexture = font->GetAtlasTexture();
+				}
+
+				glm::vec2 planeMin = glyph->PlaneMin * fsScale + pen;
+				glm::vec2 planeMax = glyph->PlaneMax * fsScale + pen;
+
+				const glm::vec4 positions[] = {
+					{ planeMin.x, planeMin.y, 0.0f, 1.0f },
+					{ planeMax.x, planeMin.y, 0.0f, 1.0f },
+					{ planeMax.x, planeMax.y, 0.0f, 1.0f },
+					{ planeMin.x, planeMax.y, 0.0f, 1.0f }
+				};
+
+				const glm::vec2 textureCoords[] = {
+					{ glyph->TexCoordMin.x, glyph->TexCoordMin.y },
+					{ glyph->TexCoordMax.x, glyph->TexCoordMin.y },
+					{ glyph->TexCoordMax.x, glyph->TexCoordMax.y },
+					{ glyph->TexCoordMin.x, glyph->TexCoordMax.y }
+				};
+
+				for (size_t i = 0; i < 4; i++)
+				{
+					s_data.TextVertexBufferPtr->Position = transform * positions[i];
+					s_data.TextVertexBufferPtr->Color = color;
+					s_data.TextVertexBufferPtr->TexCoord = textureCoords[i];
+					s_data.TextVertexBufferPtr->EntityID = entityID;
+					s_data.TextVertexBufferPtr++;
+				}
+
+				s_data.TextIndexCount += 6;
+				s_data.Stats.QuadCount++;
+			}
+
+			pen.x += fsScale * glyph->Advance + kerning;
+			previous = codepoint;
+		}
+	}
+
+	void Renderer2D::DrawString(const glm::mat4& transform, const TextComponent& component, int entityID)
+	{
+		DrawString(component.TextString, component.FontAsset, transform, component.Color, component.Kerning, component.LineSpacing, entityID);
+	}
+
 	float Renderer2D::GetLineWidth()
 	{
 		return s_data.LineWidth;
@@ -586,6 +864,10 @@ namespace Engine
 		s_data.LineVertexCount = 0;
 		s_data.LineVertexBufferPtr = s_data.LineVertexBufferBase;
 
+		s_data.TextIndexCount = 0;
+		s_data.TextVertexBufferPtr = s_data.TextVertexBufferBase;
+		s_data.FontAtlasTexture = nullptr;
+
 		s_data.TextureSlotIndex = 1;
 	}
 
@@ -594,4 +876,179 @@ namespace Engine
 		Flush();
 		StartBatch();
 	}
+
+	// -----------------------------------------
+	//
+	//    StaticBatch2D
+	//
+	// -----------------------------------------
+	struct StaticBatch2D::Segment
+	{
+		std::vector<QuadVertexFormat> Vertices;
+		uint32_t QuadCount = 0;
+
+		std::array<Ref<Texture2D>, Renderer2DData::MaxTextureSlots> TextureSlots;
+		uint32_t TextureSlotIndex = 1;
+
+		Ref<VertexArray> VertexArray;
+		bool Dirty = true;
+	};
+
+	struct StaticBatch2D::CircleSegment
+	{
+		std::vector<CircleVertex> Vertices;
+		uint32_t CircleCount = 0;
+
+		Ref<VertexArray> VertexArray;
+		bool Dirty = true;
+	};
+
+	StaticBatch2D::StaticBatch2D()
+	{}
+
+	StaticBatch2D::~StaticBatch2D()
+	{}
+
+	void StaticBatch2D::Clear()
+	{
+		m_segments.clear();
+		m_circleSegments.clear();
+		m_quadCount = 0;
+		m_circleCount = 0;
+	}
+
+	void StaticBatch2D::AddQuad(const glm::mat4& transform, const glm::vec4& color, int entityID)
+	{
+		constexpr glm::vec2 textureCoords[] = { { 0.0f, 0.0f }, { 1.0f, 0.0f }, { 1.0f, 1.0f }, { 0.0f, 1.0f } };
+		AddQuad(transform, color, textureCoords, nullptr, 1.0f, entityID);
+	}
+
+	void StaticBatch2D::AddQuad(const glm::mat4& transform, const Ref<Texture2D>& texture, float tilingFactor, const glm::vec4& tintColor, int entityID)
+	{
+		constexpr glm::vec2 textureCoords[] = { { 0.0f, 0.0f }, { 1.0f, 0.0f }, { 1.0f, 1.0f }, { 0.0f, 1.0f } };
+		AddQuad(transform, tintColor, textureCoords, texture, tilingFactor, entityID);
+	}
+
+	void StaticBatch2D::AddQuad(const glm::mat4& transform, const Ref<SubTexture2D>& subtexture, float tilingFactor, const glm::vec4& tintColor, int entityID)
+	{
+		AddQuad(transform, tintColor, subtexture->GetTexCoords(), subtexture->GetTexture(), tilingFactor, entityID);
+	}
+
+	void StaticBatch2D::AddQuad(const glm::mat4& transform, const glm::vec4& color, const glm::vec2* textureCoords, const Ref<Texture2D>& texture, float tilingFactor, int entityID)
+	{
+		float textureIndex = 0.0f;
+		Segment& segment = GetSegment(texture, textureIndex);
+
+		for (size_t i = 0; i < 4; i++)
+		{
+			QuadVertexFormat& vertex = segment.Vertices.emplace_back();
+			WriteQuadVertex(&vertex, transform * s_data.QuadVertexPositions[i], color, textureCoords[i], textureIndex, tilingFactor, entityID);
+		}
+
+		segment.QuadCount++;
+		segment.Dirty = true;
+		m_quadCount++;
+	}
+
+	void StaticBatch2D::AddCircle(const glm::mat4& transform, const glm::vec4& color, float thickness, float fade, int entityID)
+	{
+		if (m_circleSegments.empty() || m_circleSegments.back().CircleCount >= Renderer2DData::MaxQuads)
+			m_circleSegments.emplace_back();
+
+		CircleSegment& segment = m_circleSegments.back();
+		for (size_t i = 0; i < 4; i++)
+		{
+			CircleVertex& vertex = segment.Vertices.emplace_back();
+			vertex.WorldPosition = transform * s_data.QuadVertexPositions[i];
+			vertex.LocalPosition = s_data.QuadVertexPositions[i] * 2.0f;
+			vertex.Color = color;
+			vertex.Thickness = thickness;
+			vertex.Fade = fade;
+			vertex.EntityID = entityID;
+		}
+
+		segment.CircleCount++;
+		segment.Dirty = true;
+		m_circleCount++;
+	}
+
+	StaticBatch2D::Segment& StaticBatch2D::GetSegment(const Ref<Texture2D>& texture, float& textureIndex)
+	{
+		if (!m_segments.empty())
+		{
+			Segment& segment = m_segments.back();
+
+			if (segment.QuadCount < Renderer2DData::MaxQuads)
+			{
+				if (!texture)
+					return segment;
+
+				for (uint32_t i = 1; i < segment.TextureSlotIndex; i++)
+				{
+					if (*segment.TextureSlots[i] == *texture)
+					{
+						textureIndex = (float) i;
+						return segment;
+					}
+				}
+
+				if (segment.TextureSlotIndex < Renderer2DData::MaxTextureSlots)
+				{
+					textureIndex = (float) segment.TextureSlotIndex;
+					segment.TextureSlots[segment.TextureSlotIndex++] = texture;
+					return segment;
+				}
+			}
+		}
+
+		Segment& segment = m_segments.emplace_back();
+		segment.TextureSlots[0] = s_data.WhiteTexture;
+
+		if (texture)
+		{
+			textureIndex = (float) segment.TextureSlotIndex;
+			segment.TextureSlots[segment.TextureSlotIndex++] = texture;
+		}
+
+		return segment;
+	}
+
+	void StaticBatch2D::Upload()
+	{
+		ENG_PROFILE_FUNCTION();
+
+		for (auto& segment : m_segments)
+		{
+			if (!segment.Dirty)
+				continue;
+
+			uint32_t dataSize = (uint32_t) (segment.Vertices.size() * sizeof(QuadVertexFormat));
+			Ref<VertexBuffer> vertexBuffer = VertexBuffer::Create((float*) segment.Vertices.data(), dataSize);
+			vertexBuffer->SetLayout(GetQuadVertexLayout());
+
+			segment.VertexArray = VertexArray::Create();
+			segment.VertexArray->AddVertexBuffer(vertexBuffer);
+			segment.VertexArray->SetIndexBuffer(s_data.QuadVertexArray->GetIndexBuffer());
+
+			std::vector<QuadVertexFormat>().swap(segment.Vertices);
+			segment.Dirty = false;
+		}
+
+		for (auto& segment : m_circleSegments)
+		{
+			if (!segment.Dirty)
+				continue;
+
+			uint32_t dataSize = (uint32_t) (segment.Vertices.size() * sizeof(CircleVertex));
+			Ref<VertexBuffer> vertexBuffer = VertexBuffer::Create((float*) segment.Vertices.data(), dataSize);
+			vertexBuffer->SetLayout(s_data.CircleVertexBuffer->GetLayout());
+
+			segment.VertexArray = VertexArray::Create();
+			segment.VertexArray->AddVertexBuffer(vertexBuffer);
+			segment.VertexArray->SetIndexBuffer(s_data.QuadVertexArray->GetIndexBuffer());
+
+			std::vector<CircleVertex>().swap(segment.Vertices);
+			segment.Dirty = false;
+		}
+	}
 }
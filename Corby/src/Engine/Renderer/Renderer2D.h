@@ -2,6 +2,7 @@
 
 #include "Engine/Renderer/Camera.h"
 #include "Engine/Renderer/EditorCamera.h"
+#include "Engine/Renderer/Font.h"
 #include "Engine/Renderer/OrthographicCamera.h"
 #include "Engine/Renderer/SubTexture2D.h"
 #include "Engine/Renderer/Texture.h"
@@ -9,6 +10,43 @@
 
 namespace Engine
 {
+	// Quads and circles that are baked once into persistent GPU buffers and redrawn without any per-frame vertex work.
+	// Quads are split into segments whenever the quad or texture slot limit of a single draw call is reached.
+	class StaticBatch2D
+	{
+	public:
+		StaticBatch2D();
+		~StaticBatch2D();
+
+		void Clear();
+
+		void AddQuad(const glm::mat4& transform, const glm::vec4& color, int entityID = -1);
+		void AddQuad(const glm::mat4& transform, const Ref<Texture2D>& texture, float tilingFactor = 1.0f, const glm::vec4& tintColor = glm::vec4(1.0f), int entityID = -1);
+		void AddQuad(const glm::mat4& transform, const Ref<SubTexture2D>& subtexture, float tilingFactor = 1.0f, const glm::vec4& tintColor = glm::vec4(1.0f), int entityID = -1);
+		void AddCircle(const glm::mat4& transform, const glm::vec4& color, float thickness = 1.0f, float fade = 0.005f, int entityID = -1);
+
+		// Uploads the geometry added since the last call and releases its CPU copy
+		void Upload();
+
+		uint32_t GetQuadCount() const { return m_quadCount; }
+		uint32_t GetCircleCount() const { return m_circleCount; }
+		uint32_t GetSegmentCount() const { return (uint32_t) (m_segments.size() + m_circleSegments.size()); }
+
+	private:
+		struct Segment;
+		struct CircleSegment;
+		Segment& GetSegment(const Ref<Texture2D>& texture, float& textureIndex);
+		void AddQuad(const glm::mat4& transform, const glm::vec4& color, const glm::vec2* textureCoords, const Ref<Texture2D>& texture, float tilingFactor, int entityID);
+
+	private:
+		std::vector<Segment> m_segments;
+		std::vector<CircleSegment> m_circleSegments;
+		uint32_t m_quadCount = 0;
+		uint32_t m_circleCount = 0;
+
+		friend class Renderer2D;
+	};
+
 	class Renderer2D
 	{
 	public:
@@ -20,6 +58,9 @@ namespace Engine
 		static void BeginScene(const OrthographicCamera& camera);
 		static void EndScene();
 		static void Flush();
+		// Draws what was batched so far and starts a new batch. Drawing outside the batch, such as static
+		// batches or GPU particles, calls it first so those end up on top of what was submitted before them.
+		static void NextBatch();
 
 		// Draw calls
 		static void DrawQuad(const glm::vec2& position, const glm::vec2& size, const glm::vec4& color);
@@ -44,6 +85,11 @@ namespace Engine
 		static void DrawRect(const glm::vec3& position, const glm::vec2& size, const glm::vec4& color, int entityID = -1);
 		static void DrawRect(const glm::mat4& transform, const glm::vec4& color, int entityID = -1);
 		static void DrawSprite(const glm::mat4& transform, SpriteRendererComponent& src, int entityID);
+		static void DrawStaticBatch(const StaticBatch2D& batch);
+		static void DrawTilemap(const glm::mat4& transform, TilemapComponent& tilemap, int entityID);
+
+		static void DrawString(const std::string& text, const Ref<Font>& font, const glm::mat4& transform, const glm::vec4& color, float kerning = 0.0f, float lineSpacing = 0.0f, int entityID = -1);
+		static void DrawString(const glm::mat4& transform, const TextComponent& component, int entityID);
 
 		static float GetLineWidth();
 		static void SetLineWidth(float width);
@@ -63,6 +109,5 @@ namespace Engine
 
 	private:
 		static void StartBatch();
-		static void NextBatch();
 	};
 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "Engine/Renderer/StorageBuffer.h"
 #include "Engine/Renderer/VertexArray.h"
 
 #include <glm/glm.hpp>
@@ -23,6 +24,12 @@ namespace Engine
 		virtual void Clear() = 0;
 		virtual void DrawIndexed(const Ref<VertexArray>& vertexArray, uint32_t indexCount) = 0;
 		virtual void DrawLines(const Ref<VertexArray>& vertexArray, uint32_t vertexCount) = 0;
+		virtual void DrawIndexedIndirect(const Ref<VertexArray>& vertexArray, const Ref<StorageBuffer>& argumentBuffer, uint32_t offset) = 0;
+
+		virtual void DispatchCompute(uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ) = 0;
+		virtual void DispatchComputeIndirect(const Ref<StorageBuffer>& argumentBuffer, uint32_t offset) = 0;
+		// Makes storage buffer writes visible to following shader reads and indirect commands
+		virtual void StorageBufferBarrier() = 0;
 
 		virtual void SetLineWidth(float width) = 0;
 
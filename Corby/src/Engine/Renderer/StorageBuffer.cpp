@@ -0,0 +1,28 @@
+#include "engpch.h"
+#include "StorageBuffer.h"
+
+#include "Engine/Renderer/Renderer.h"
+#include "Platform/OpenGL/OpenGLStorageBuffer.h"
+
+namespace Engine
+{
+	Ref<StorageBuffer> StorageBuffer::Create(uint32_t size, const void* data)
+	{
+		switch (Renderer::GetAPI())
+		{
+			case RendererAPI::API::None:
+			{
+				ENG_CORE_ASSERT(false, "RendererAPI::None is currently not supported!");
+				return nullptr;
+			}
+
+			case RendererAPI::API::OpenGL:
+			{
+				return CreateRef<OpenGLStorageBuffer>(size, data);
+			}
+		}
+
+		ENG_CORE_ASSERT(false, "Unknown RendererAPI!");
+		return nullptr;
+	}
+}
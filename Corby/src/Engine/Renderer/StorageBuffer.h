@@ -0,0 +1,21 @@
+#pragma once
+
+#include "Engine/Core/Base.h"
+
+namespace Engine
+{
+	// Shader storage buffer, readable and writable from compute and graphics shaders. Unlike uniform
+	// buffers these are bound right before use, so several buffers can share a binding point.
+	class StorageBuffer
+	{
+	public:
+		virtual ~StorageBuffer() {}
+		virtual void SetData(const void* data, uint32_t size, uint32_t offset = 0) = 0;
+		virtual void Bind(uint32_t binding) const = 0;
+
+		virtual uint32_t GetSize() const = 0;
+		virtual uint32_t GetRendererID() const = 0;
+
+		static Ref<StorageBuffer> Create(uint32_t size, const void* data = nullptr);
+	};
+}
@@ -14,8 +14,11 @@ namespace Engine
 		virtual uint32_t GetWidth() const = 0;
 		virtual uint32_t GetHeight() const = 0;
 		virtual uint32_t GetRendererID() const = 0;
+		virtual const std::string& GetPath() const = 0;
 
 		virtual void SetData(void* data, uint32_t size) = 0;
+		// Uploads a region, the data is tightly packed and in the format of the texture
+		virtual void SetData(void* data, uint32_t x, uint32_t y, uint32_t width, uint32_t height) = 0;
 
 		virtual void Bind(uint32_t slot = 0) const = 0;
 
@@ -0,0 +1,585 @@
+#pragma once
+
+#include "Engine/Core/Base.h"
+#include "Engine/Scene/Components.h"
+
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+namespace Engine
+{
+	enum ComponentFlags
+	{
+		ComponentFlagsNone = 0,
+		ComponentNotSerialized = BIT(0), // Not written to scene files
+		ComponentNotAddable = BIT(1), // Not offered by the add component menu of the editor
+		ComponentNotListed = BIT(2), // Not offered as a filter of the scene hierarchy
+		ComponentNotInspected = BIT(3) // Not drawn in the properties panel
+	};
+
+	enum FieldFlags
+	{
+		FieldFlagsNone = 0,
+		FieldColor = BIT(0), // Edited with a color picker
+		FieldHex = BIT(1), // Shown as a hexadecimal number
+		FieldSlider = BIT(2), // Edited with a slider between Min and Max, loaded values are clamped to the range
+		FieldMultiline = BIT(3), // Text with more than one line
+		FieldPacked = BIT(4), // Written to scene files as packed binary instead of a list, for long arrays
+		FieldNotInspected = BIT(5) // Only serialized, the properties panel draws it with its own widgets
+	};
+
+	template<typename Object, typename Value>
+	struct MemberAccess
+	{
+		Value Object::* Member;
+
+		const Value& Get(const Object& object) const { return object.*Member; }
+		void Set(Object& object, const Value& value) const { object.*Member = value; }
+	};
+
+	// A member of a struct member, for settings that are grouped in a struct of their own
+	template<typename Object, typename Outer, typename Value>
+	struct NestedMemberAccess
+	{
+		Outer Object::* Parent;
+		Value Outer::* Member;
+
+		const Value& Get(const Object& object) const { return object.*Parent.*Member; }
+		void Set(Object& object, const Value& value) const { object.*Parent.*Member = value; }
+	};
+
+	// A getter and setter pair, for state that has to be kept consistent by the object itself
+	template<typename Object, typename Value, typename Getter, typename Setter>
+	struct PropertyAccess
+	{
+		Getter GetFunction;
+		Setter SetFunction;
+
+		// Getters that return a reference are not copied from
+		decltype(auto) Get(const Object& object) const { return (object.*GetFunction)(); }
+		void Set(Object& object, const Value& value) const { (object.*SetFunction)(value); }
+	};
+
+	// Describes one field of a reflected type. The name is the key in scene files, the label in the
+	// properties panel is made from it unless one is given.
+	template<typename Object, typename Value, typename Access>
+	struct Field
+	{
+		using ObjectType = Object;
+		using ValueType = Value;
+
+		const char* Name;
+		Access Accessor;
+		uint32_t Flags = FieldFlagsNone;
+		const char* Label = nullptr;
+
+		// Widget settings, a range of 0 to 0 is unbounded
+		float Speed = 1.0f;
+		float Min = 0.0f;
+		float Max = 0.0f;
+
+		decltype(auto) Get(const Object& object) const { return Accessor.Get(object); }
+		void Set(Object& object, const Value& value) const { Accessor.Set(object, value); }
+
+		Field WithLabel(const char* label) const
+		{
+			Field field = *this;
+			field.Label = label;
+			return field;
+		}
+
+		Field WithRange(float speed, float min = 0.0f, float max = 0.0f) const
+		{
+			Field field = *this;
+			field.Speed = speed;
+			field.Min = min;
+			field.Max = max;
+			return field;
+		}
+	};
+
+	template<typename Object, typename Value>
+	auto MakeField(const char* name, Value Object::* member, uint32_t flags = FieldFlagsNone)
+	{
+		using Access = MemberAccess<Object, Value>;
+		return Field<Object, Value, Access>{ name, Access{ member }, flags };
+	}
+
+	template<typename Object, typename Outer, typename Value>
+	auto MakeField(const char* name, Outer Object::* parent, Value Outer::* member, uint32_t flags = FieldFlagsNone)
+	{
+		using Access = NestedMemberAccess<Object, Outer, Value>;
+		return Field<Object, Value, Access>{ name, Access{ parent, member }, flags };
+	}
+
+	template<typename Object, typename Result, typename Argument>
+	auto MakeProperty(const char* name, Result (Object::* getter)() const, void (Object::* setter)(Argument), uint32_t flags = FieldFlagsNone)
+	{
+		using Value = std::decay_t<Result>;
+		using Access = PropertyAccess<Object, Value, Result (Object::*)() const, void (Object::*)(Argument)>;
+		return Field<Object, Value, Access>{ name, Access{ getter, setter }, flags };
+	}
+
+	// Enums with names are written to scene files and shown in the editor by name, the others as numbers
+	template<typename Enum>
+	struct EnumInfo
+	{
+		static constexpr bool Named = false;
+	};
+
+	template<>
+	struct EnumInfo<Rigidbody2DComponent::BodyType>
+	{
+		static constexpr bool Named = true;
+		static constexpr const char* Names[] = { "Static", "Dynamic", "Kinematic" };
+	};
+
+	// Compile time description of a type: its fields and, for components, how the editor and the scene files
+	// treat it. Every component in AllComponents has a specialization, a new component only has to be added
+	// to that list and described here to be copied, serialized, inspected and undone like the others.
+	template<typename T>
+	struct Reflection
+	{
+		static constexpr bool Reflected = false;
+	};
+
+	template<typename T, typename Func>
+	void ForEachField(Func&& func)
+	{
+		std::apply([&] (const auto&... fields) { (func(fields), ...); }, Reflection<T>::Fields());
+	}
+
+	template<typename T>
+	struct IsVector : std::false_type {};
+
+	template<typename T, typename Allocator>
+	struct IsVector<std::vector<T, Allocator>> : std::true_type {};
+
+	template<typename T>
+	bool ReflectedEqual(const T& a, const T& b);
+
+	template<typename Value>
+	bool ValuesEqual(const Value& a, const Value& b)
+	{
+		if constexpr (Reflection<Value>::Reflected)
+		{
+			return ReflectedEqual(a, b);
+		} else if constexpr (IsVector<Value>::value)
+		{
+			if (a.size() != b.size())
+				return false;
+
+			for (size_t i = 0; i < a.size(); i++)
+			{
+				if (!ValuesEqual(a[i], b[i]))
+					return false;
+			}
+
+			return true;
+		} else
+		{
+			return a == b;
+		}
+	}
+
+	// Compares the reflected fields, runtime storage is not part of them
+	template<typename T>
+	bool ReflectedEqual(const T& a, const T& b)
+	{
+		bool equal = true;
+		ForEachField<T>([&] (const auto& field) {
+			equal = equal && ValuesEqual(field.Get(a), field.Get(b));
+			});
+
+		return equal;
+	}
+
+	// -----------------------------------------
+	//
+	//    Nested types
+	//
+	// -----------------------------------------
+
+	template<>
+	struct Reflection<SceneCamera>
+	{
+		static constexpr bool Reflected = true;
+
+		static auto Fields()
+		{
+			using T = SceneCamera;
+			return std::make_tuple(
+				MakeProperty("ProjectionType", &T::GetProjectionType, &T::SetProjectionType),
+				MakeProperty("PerspectiveFOV", &T::GetPerspectiveVerticalFOV, &T::SetPerspectiveVerticalFOV),
+				MakeProperty("PerspectiveNear", &T::GetPerspectiveNearClip, &T::SetPerspectiveNearClip),
+				MakeProperty("PerspectiveFar", &T::GetPerspectiveFarClip, &T::SetPerspectiveFarClip),
+				MakeProperty("OrthographicSize", &T::GetOrthographicSize, &T::SetOrthographicSize),
+				MakeProperty("OrthographicNear", &T::GetOrthographicNearClip, &T::SetOrthographicNearClip),
+				MakeProperty("OrthographicFar", &T::GetOrthographicFarClip, &T::SetOrthographicFarClip)
+			);
+		}
+	};
+
+	template<>
+	struct Reflection<ChainCollider2DComponent::Chain>
+	{
+		static constexpr bool Reflected = true;
+
+		static auto Fields()
+		{
+			using T = ChainCollider2DComponent::Chain;
+			return std::make_tuple(
+				MakeField("Loop", &T::Loop),
+				// Baked chains can get long, vertices are stored as packed floats like the tiles of a tilemap
+				MakeField("Vertices", &T::Vertices, FieldPacked)
+			);
+		}
+	};
+
+	// Surface and collision filter settings every collider has
+	template<typename Collider>
+	auto MakeCollider2DFields()
+	{
+		return std::make_tuple(
+			MakeField("Friction", &Collider::Friction).WithRange(0.01f, 0.0f, 1.0f),
+			MakeField("Restitution", &Collider::Restitution).WithRange(0.01f, 0.0f, 1.0f),
+			MakeField("RestitutionThreshold", &Collider::RestitutionThreshold).WithRange(0.01f, 0.0f),
+			MakeField("Layer", &Collider::Layer, FieldSlider).WithRange(1.0f, 0.0f, 15.0f),
+			MakeField("LayerMask", &Collider::LayerMask, FieldHex)
+		);
+	}
+
+	// -----------------------------------------
+	//
+	//    Components
+	//
+	// -----------------------------------------
+
+	template<>
+	struct Reflection<IDComponent>
+	{
+		static constexpr bool Reflected = true;
+		static constexpr const char* Name = "IDComponent";
+		static constexpr const char* DisplayName = "ID";
+		// Written as the key of the entity
+		static constexpr uint32_t Flags = ComponentNotSerialized | ComponentNotAddable | ComponentNotListed | ComponentNotInspected;
+
+		static auto Fields() { return std::make_tuple(); }
+	};
+
+	template<>
+	struct Reflection<TagComponent>
+	{
+		static constexpr bool Reflected = true;
+		static constexpr const char* Name = "TagComponent";
+		static constexpr const char* DisplayName = "Tag";
+		// Drawn above the components
+		static constexpr uint32_t Flags = ComponentNotAddable | ComponentNotListed | ComponentNotInspected;
+
+		static auto Fields()
+		{
+			return std::make_tuple(MakeField("Tag", &TagComponent::Tag));
+		}
+	};
+
+	template<>
+	struct Reflection<PrefabInstanceComponent>
+	{
+		static constexpr bool Reflected = true;
+		static constexpr const char* Name = "PrefabInstanceComponent";
+		static constexpr const char* DisplayName = "Prefab instance";
+		// Written as the Prefab key of the entity, instances are made with Scene::InstantiatePrefab
+		static constexpr uint32_t Flags = ComponentNotSerialized | ComponentNotAddable;
+
+		static auto Fields()
+		{
+			return std::make_tuple(MakeField("Prefab", &PrefabInstanceComponent::Source));
+		}
+	};
+
+	template<>
+	struct Reflection<TransformComponent>
+	{
+		static constexpr bool Reflected = true;
+		static constexpr const char* Name = "TransformComponent";
+		static constexpr const char* DisplayName = "Transform";
+		static constexpr uint32_t Flags = ComponentNotAddable | ComponentNotListed;
+
+		static auto Fields()
+		{
+			using T = TransformComponent;
+			return std::make_tuple(
+				MakeField("Translation", &T::Translation),
+				MakeField("Rotation", &T::Rotation),
+				MakeField("Scale", &T::Scale)
+			);
+		}
+	};
+
+	template<>
+	struct Reflection<CameraComponent>
+	{
+		static constexpr bool Reflected = true;
+		static constexpr const char* Name = "CameraComponent";
+		static constexpr const char* DisplayName = "Camera";
+		static constexpr uint32_t Flags = ComponentFlagsNone;
+
+		static auto Fields()
+		{
+			using T = CameraComponent;
+			return std::make_tuple(
+				MakeField("Camera", &T::Camera),
+				MakeField("Primary", &T::Primary),
+				MakeField("FixedAspectRatio", &T::FixedAspectRatio)
+			);
+		}
+	};
+
+	template<>
+	struct Reflection<SpriteRendererComponent>
+	{
+		static constexpr bool Reflected = true;
+		static constexpr const char* Name = "SpriteRendererComponent";
+		static constexpr const char* DisplayName = "Sprite renderer";
+		static constexpr uint32_t Flags = ComponentFlagsNone;
+
+		static auto Fields()
+		{
+			using T = SpriteRendererComponent;
+			return std::make_tuple(
+				MakeField("Color", &T::Color, FieldColor),
+				MakeField("TexturePath", &T::Texture).WithLabel("Texture"),
+				MakeField("TilingFactor", &T::TilingFactor).WithRange(0.1f, 0.0f, 100.0f)
+			);
+		}
+	};
+
+	template<>
+	struct Reflection<CircleRendererComponent>
+	{
+		static constexpr bool Reflected = true;
+		static constexpr const char* Name = "CircleRendererComponent";
+		static constexpr const char* DisplayName = "Circle renderer";
+		static constexpr uint32_t Flags = ComponentFlagsNone;
+
+		static auto Fields()
+		{
+			using T = CircleRendererComponent;
+			return std::make_tuple(
+				MakeField("Color", &T::Color, FieldColor),
+				MakeField("Thickness", &T::Thickness).WithRange(0.025f, 0.0f, 1.0f),
+				MakeField("Fade", &T::Fade).WithRange(0.00025f, 0.0f, 1.0f)
+			);
+		}
+	};
+
+	template<>
+	struct Reflection<TextComponent>
+	{
+		static constexpr bool Reflected = true;
+		static constexpr const char* Name = "TextComponent";
+		static constexpr const char* DisplayName = "Text";
+		static constexpr uint32_t Flags = ComponentFlagsNone;
+
+		static auto Fields()
+		{
+			using T = TextComponent;
+			return std::make_tuple(
+				MakeField("TextString", &T::TextString, FieldMultiline).WithLabel("Text"),
+				MakeField("FontPath", &T::FontAsset).WithLabel("Font"),
+				MakeField("Color", &T::Color, FieldColor),
+				MakeField("Kerning", &T::Kerning).WithRange(0.025f),
+				MakeField("LineSpacing", &T::LineSpacing).WithRange(0.025f)
+			);
+		}
+	};
+
+	template<>
+	struct Reflection<StaticComponent>
+	{
+		static constexpr bool Reflected = true;
+		static constexpr const char* Name = "StaticComponent";
+		static constexpr const char* DisplayName = "Static";
+		static constexpr uint32_t Flags = ComponentFlagsNone;
+
+		static auto Fields() { return std::make_tuple(); }
+	};
+
+	template<>
+	struct Reflection<ParticleEmitterComponent>
+	{
+		static constexpr bool Reflected = true;
+		static constexpr const char* Name = "ParticleEmitterComponent";
+		static constexpr const char* DisplayName = "Particle emitter";
+		static constexpr uint32_t Flags = ComponentFlagsNone;
+
+		static auto Fields()
+		{
+			using T = ParticleEmitterComponent;
+			using P = ParticleProps;
+			return std::make_tuple(
+				MakeField("MaxParticles", &T::Props, &P::MaxParticles).WithRange(1000.0f, 1.0f, 4000000.0f),
+				MakeField("EmissionRate", &T::Props, &P::EmissionRate).WithRange(10.0f, 0.0f, 10000000.0f),
+				MakeField("LifeTime", &T::Props, &P::LifeTime).WithRange(0.01f, 0.01f, 100.0f),
+				MakeField("Velocity", &T::Props, &P::Velocity).WithRange(0.1f),
+				MakeField("VelocityVariation", &T::Props, &P::VelocityVariation).WithRange(0.1f, 0.0f, 100.0f),
+				MakeField("Gravity", &T::Props, &P::Gravity).WithRange(0.1f),
+				MakeField("ColorBegin", &T::Props, &P::ColorBegin, FieldColor),
+				MakeField("ColorEnd", &T::Props, &P::ColorEnd, FieldColor),
+				MakeField("SizeBegin", &T::Props, &P::SizeBegin).WithRange(0.005f, 0.0f, 100.0f),
+				MakeField("SizeEnd", &T::Props, &P::SizeEnd).WithRange(0.005f, 0.0f, 100.0f)
+			);
+		}
+	};
+
+	template<>
+	struct Reflection<TilemapComponent>
+	{
+		static constexpr bool Reflected = true;
+		static constexpr const char* Name = "TilemapComponent";
+		static constexpr const char* DisplayName = "Tilemap";
+		static constexpr uint32_t Flags = ComponentFlagsNone;
+
+		static auto Fields()
+		{
+			using T = TilemapComponent;
+			// The tiles come last, the map has to be resized before they are set
+			return std::make_tuple(
+				MakeField("SpritesheetPath", &T::Spritesheet).WithLabel("Spritesheet"),
+				MakeField("CellSize", &T::CellSize).WithRange(1.0f, 1.0f, 4096.0f),
+				MakeProperty("Width", &T::GetWidth, &T::SetWidth),
+				MakeProperty("Height", &T::GetHeight, &T::SetHeight),
+				MakeProperty("Tiles", &T::GetTiles, &T::SetTiles, FieldPacked | FieldNotInspected)
+			);
+		}
+	};
+
+	template<>
+	struct Reflection<NativeScriptComponent>
+	{
+		static constexpr bool Reflected = true;
+		static constexpr const char* Name = "NativeScriptComponent";
+		static constexpr const char* DisplayName = "Native script";
+		// Bound from code
+		static constexpr uint32_t Flags = ComponentNotSerialized | ComponentNotAddable | ComponentNotInspected;
+
+		static auto Fields() { return std::make_tuple(); }
+	};
+
+	template<>
+	struct Reflection<Rigidbody2DComponent>
+	{
+		static constexpr bool Reflected = true;
+		static constexpr const char* Name = "Rigidbody2DComponent";
+		static constexpr const char* DisplayName = "Rigidbody 2D";
+		static constexpr uint32_t Flags = ComponentFlagsNone;
+
+		static auto Fields()
+		{
+			using T = Rigidbody2DComponent;
+			return std::make_tuple(
+				MakeField("BodyType", &T::Type),
+				MakeField("FixedRotation", &T::FixedRotation)
+			);
+		}
+	};
+
+	template<>
+	struct Reflection<BoxCollider2DComponent>
+	{
+		static constexpr bool Reflected = true;
+		static constexpr const char* Name = "BoxCollider2DComponent";
+		static constexpr const char* DisplayName = "Box Collider 2D";
+		static constexpr uint32_t Flags = ComponentFlagsNone;
+
+		static auto Fields()
+		{
+			using T = BoxCollider2DComponent;
+			return std::tuple_cat(std::make_tuple(
+				MakeField("Offset", &T::Offset),
+				MakeField("Size", &T::Size),
+				MakeField("Density", &T::Density).WithRange(0.01f, 0.0f, 1.0f)
+			), MakeCollider2DFields<T>());
+		}
+	};
+
+	template<>
+	struct Reflection<CircleCollider2DComponent>
+	{
+		static constexpr bool Reflected = true;
+		static constexpr const char* Name = "CircleCollider2DComponent";
+		static constexpr const char* DisplayName = "Circle Collider 2D";
+		static constexpr uint32_t Flags = ComponentFlagsNone;
+
+		static auto Fields()
+		{
+			using T = CircleCollider2DComponent;
+			return std::tuple_cat(std::make_tuple(
+				MakeField("Offset", &T::Offset),
+				MakeField("Radius", &T::Radius),
+				MakeField("Density", &T::Density).WithRange(0.01f, 0.0f, 1.0f)
+			), MakeCollider2DFields<T>());
+		}
+	};
+
+	template<>
+	struct Reflection<PolygonCollider2DComponent>
+	{
+		static constexpr bool Reflected = true;
+		static constexpr const char* Name = "PolygonCollider2DComponent";
+		static constexpr const char* DisplayName = "Polygon Collider 2D";
+		static constexpr uint32_t Flags = ComponentFlagsNone;
+
+		static auto Fields()
+		{
+			using T = PolygonCollider2DComponent;
+			return std::tuple_cat(std::make_tuple(
+				MakeField("Vertices", &T::Vertices, FieldNotInspected),
+				MakeField("Density", &T::Density).WithRange(0.01f, 0.0f, 1.0f)
+			), MakeCollider2DFields<T>());
+		}
+	};
+
+	template<>
+	struct Reflection<CapsuleCollider2DComponent>
+	{
+		static constexpr bool Reflected = true;
+		static constexpr const char* Name = "CapsuleCollider2DComponent";
+		static constexpr const char* DisplayName = "Capsule Collider 2D";
+		static constexpr uint32_t Flags = ComponentFlagsNone;
+
+		static auto Fields()
+		{
+			using T = CapsuleCollider2DComponent;
+			return std::tuple_cat(std::make_tuple(
+				MakeField("Offset", &T::Offset),
+				MakeField("Radius", &T::Radius).WithRange(0.01f, 0.0f),
+				MakeField("Height", &T::Height).WithRange(0.01f, 0.0f),
+				MakeField("Density", &T::Density).WithRange(0.01f, 0.0f, 1.0f)
+			), MakeCollider2DFields<T>());
+		}
+	};
+
+	template<>
+	struct Reflection<ChainCollider2DComponent>
+	{
+		static constexpr bool Reflected = true;
+		static constexpr const char* Name = "ChainCollider2DComponent";
+		static constexpr const char* DisplayName = "Chain Collider 2D";
+		static constexpr uint32_t Flags = ComponentFlagsNone;
+
+		static auto Fields()
+		{
+			using T = ChainCollider2DComponent;
+			return std::tuple_cat(std::make_tuple(
+				MakeField("Chains", &T::Chains, FieldNotInspected)
+			), MakeCollider2DFields<T>());
+		}
+	};
+
+	// Adding a component to AllComponents without describing it is caught here instead of in every system
+	template<typename... Component>
+	constexpr bool AllReflected(ComponentGroup<Component...>) { return (Reflection<Component>::Reflected && ...); }
+	static_assert(AllReflected(AllComponents{}), "Every component needs a Reflection specialization!");
+}
@@ -1,6 +1,10 @@
 #pragma once
 
+#include "Engine/Core/InternedString.h"
 #include "Engine/Core/UUID.h"
+#include "Engine/Renderer/Font.h"
+#include "Engine/Renderer/ParticleSystem.h"
+#include "Engine/Renderer/SubTexture2D.h"
 #include "Engine/Renderer/Texture.h"
 #include "Engine/Scene/SceneCamera.h"
 
@@ -20,9 +24,10 @@ namespace Engine
 		IDComponent(const IDComponent&) = default;
 	};
 
+	// Names repeat a lot across entities, so they are interned instead of each entity owning a copy
 	struct TagComponent
 	{
-		std::string Tag;
+		InternedString Tag;
 
 		TagComponent() = default;
 		TagComponent(const TagComponent&) = default;
@@ -30,10 +35,22 @@ namespace Engine
 			: Tag(tag)
 		{}
 
-		operator std::string& () { return Tag; }
 		operator const std::string& () const { return Tag; }
 	};
 
+	// Links an instance to the prefab it was made from
+	class Prefab;
+	struct PrefabInstanceComponent
+	{
+		Ref<Prefab> Source;
+
+		PrefabInstanceComponent() = default;
+		PrefabInstanceComponent(const PrefabInstanceComponent&) = default;
+		PrefabInstanceComponent(const Ref<Prefab>& source)
+			: Source(source)
+		{}
+	};
+
 	struct TransformComponent
 	{
 		glm::vec3 Translation = { 0.0f, 0.0f, 0.0f };
@@ -56,6 +73,17 @@ namespace Engine
 		}
 	};
 
+	// Sprites and circles of static entities are baked into persistent buffers instead of being rebuilt every
+	// frame. Components edited in place have to be patched (Entity::PatchComponent) to rebake them.
+	struct StaticComponent
+	{
+		// Storage for runtime
+		uint32_t RuntimeGroup = std::numeric_limits<uint32_t>::max();
+
+		StaticComponent() = default;
+		StaticComponent(const StaticComponent&) = default;
+	};
+
 	struct SpriteRendererComponent
 	{
 		glm::vec4 Color{ 1.0f, 1.0f, 1.0f, 1.0f };
@@ -79,6 +107,180 @@ namespace Engine
 		CircleRendererComponent(const CircleRendererComponent&) = default;
 	};
 
+	struct TextComponent
+	{
+		std::string TextString;
+		Ref<Font> FontAsset;
+		glm::vec4 Color{ 1.0f, 1.0f, 1.0f, 1.0f };
+		float Kerning = 0.0f;
+		float LineSpacing = 0.0f;
+
+		TextComponent() = default;
+		TextComponent(const TextComponent&) = default;
+	};
+
+	struct ParticleEmitterComponent
+	{
+		ParticleProps Props;
+
+		// Storage for runtime
+		Ref<ParticleSystem> RuntimeSystem;
+
+		ParticleEmitterComponent() = default;
+
+		// Copies only carry the settings, every emitter simulates its own particles
+		ParticleEmitterComponent(const ParticleEmitterComponent& other)
+			: Props(other.Props)
+		{}
+
+		ParticleEmitterComponent& operator=(const ParticleEmitterComponent& other)
+		{
+			Props = other.Props;
+			RuntimeSystem = nullptr;
+			return *this;
+		}
+	};
+
+	class StaticBatch2D;
+	struct TilemapComponent
+	{
+		static constexpr uint32_t ChunkSize = 128;
+		static constexpr int32_t EmptyTile = -1;
+
+		// A square of ChunkSize * ChunkSize tiles that is baked into one static batch
+		struct Chunk
+		{
+			// Storage for runtime
+			Ref<StaticBatch2D> Batch;
+			bool Dirty = true;
+
+			Chunk() = default;
+			Chunk(Chunk&&) = default;
+			Chunk& operator=(Chunk&&) = default;
+
+			// Copies bake their own geometry
+			Chunk(const Chunk& other) {}
+
+			Chunk& operator=(const Chunk& other)
+			{
+				Batch = nullptr;
+				Dirty = true;
+				return *this;
+			}
+		};
+
+		Ref<Texture2D> Spritesheet;
+		glm::vec2 CellSize = { 128.0f, 128.0f }; // Size of a single tile in the spritesheet, in pixels
+
+		// Storage for runtime
+		glm::mat4 BakedTransform = glm::mat4(0.0f);
+		std::vector<Ref<SubTexture2D>> TileTextures;
+
+		TilemapComponent() = default;
+		TilemapComponent(const TilemapComponent&) = default;
+
+		uint32_t GetWidth() const { return m_width; }
+		uint32_t GetHeight() const { return m_height; }
+		uint32_t GetChunkCountX() const { return (m_width + ChunkSize - 1) / ChunkSize; }
+		uint32_t GetChunkCountY() const { return (m_height + ChunkSize - 1) / ChunkSize; }
+
+		std::vector<Chunk>& GetChunks() { return m_chunks; }
+		const std::vector<Chunk>& GetChunks() const { return m_chunks; }
+
+		void SetWidth(uint32_t width) { Resize(width, m_height); }
+		void SetHeight(uint32_t height) { Resize(m_width, height); }
+
+		void Resize(uint32_t width, uint32_t height)
+		{
+			std::vector<int32_t> tiles((size_t) width * height, EmptyTile);
+			for (uint32_t y = 0; y < std::min(height, m_height); y++)
+			{
+				for (uint32_t x = 0; x < std::min(width, m_width); x++)
+					tiles[(size_t) y * width + x] = GetTile(x, y);
+			}
+
+			m_width = width;
+			m_height = height;
+			m_tiles = std::move(tiles);
+			m_chunks.clear();
+			m_chunks.resize((size_t) GetChunkCountX() * GetChunkCountY());
+		}
+
+		int32_t GetTile(uint32_t x, uint32_t y) const
+		{
+			if (x >= m_width || y >= m_height)
+				return EmptyTile;
+
+			return m_tiles[(size_t) y * m_width + x];
+		}
+
+		void SetTile(uint32_t x, uint32_t y, int32_t tile)
+		{
+			if (x >= m_width || y >= m_height)
+				return;
+
+			int32_t& current = m_tiles[(size_t) y * m_width + x];
+			if (current != tile)
+			{
+				current = tile;
+				m_chunks[(y / ChunkSize) * GetChunkCountX() + x / ChunkSize].Dirty = true;
+			}
+		}
+
+		// Tiles of the whole map in row-major order, so the layout does not depend on the chunk size
+		const std::vector<int32_t>& GetTiles() const { return m_tiles; }
+
+		void SetTiles(const std::vector<int32_t>& tiles)
+		{
+			size_t count = std::min(tiles.size(), (size_t) m_width * m_height);
+			for (size_t i = 0; i < count; i++)
+				SetTile((uint32_t) (i % m_width), (uint32_t) (i / m_width), tiles[i]);
+		}
+
+		void Fill(int32_t tile)
+		{
+			for (uint32_t y = 0; y < m_height; y++)
+			{
+				for (uint32_t x = 0; x < m_width; x++)
+					SetTile(x, y, tile);
+			}
+		}
+
+		// Forces every chunk to be rebuilt, call this after changing the spritesheet or cell size
+		void Invalidate()
+		{
+			TileTextures.clear();
+			for (auto& chunk : m_chunks)
+				chunk.Dirty = true;
+		}
+
+		const Ref<SubTexture2D>& GetTileTexture(int32_t tile)
+		{
+			static const Ref<SubTexture2D> s_empty;
+
+			uint32_t columns = Spritesheet ? (uint32_t) (Spritesheet->GetWidth() / CellSize.x) : 0;
+			uint32_t rows = Spritesheet ? (uint32_t) (Spritesheet->GetHeight() / CellSize.y) : 0;
+			if (tile < 0 || (uint32_t) tile >= columns * rows)
+				return s_empty;
+
+			if (TileTextures.empty())
+				TileTextures.resize((size_t) columns * rows);
+
+			// Tile ids start at the top left of the spritesheet
+			Ref<SubTexture2D>& subtexture = TileTextures[tile];
+			if (!subtexture)
+				subtexture = SubTexture2D::CreateFromCoords(Spritesheet, glm::vec2((float) (tile % columns), (float) (rows - 1 - tile / columns)), CellSize);
+
+			return subtexture;
+		}
+
+	private:
+		uint32_t m_width = 0;
+		uint32_t m_height = 0;
+		std::vector<int32_t> m_tiles;
+		std::vector<Chunk> m_chunks;
+	};
+
 	struct CameraComponent
 	{
 		SceneCamera Camera;
@@ -97,6 +299,33 @@ namespace Engine
 		ScriptableEntity* (*InstantiateScript)();
 		void (*DestroyScript)(NativeScriptComponent*);
 
+		// The instance belongs to one entity and is destroyed with it, copies create their own when the scene runs.
+		// Moves hand it over, the registry moves components around when others are removed.
+		NativeScriptComponent() = default;
+		NativeScriptComponent(const NativeScriptComponent& other)
+			: InstantiateScript(other.InstantiateScript), DestroyScript(other.DestroyScript)
+		{}
+		NativeScriptComponent(NativeScriptComponent&& other) noexcept
+			: Instance(other.Instance), InstantiateScript(other.InstantiateScript), DestroyScript(other.DestroyScript)
+		{
+			other.Instance = nullptr;
+		}
+
+		NativeScriptComponent& operator=(const NativeScriptComponent& other)
+		{
+			InstantiateScript = other.InstantiateScript;
+			DestroyScript = other.DestroyScript;
+			return *this;
+		}
+
+		NativeScriptComponent& operator=(NativeScriptComponent&& other) noexcept
+		{
+			std::swap(Instance, other.Instance);
+			InstantiateScript = other.InstantiateScript;
+			DestroyScript = other.DestroyScript;
+			return *this;
+		}
+
 		template<typename T>
 		void bind()
 		{
@@ -140,6 +369,9 @@ namespace Engine
 		float Restitution = 0.0f;
 		float RestitutionThreshold = 0.5f;
 
+		uint32_t Layer = 0; // Collision layer, 0 to 15
+		uint16_t LayerMask = 0xFFFF; // Layers this collider collides with
+
 		// Storage for runtime
 		void* RuntimeFixture = nullptr;
 
@@ -157,10 +389,113 @@ namespace Engine
 		float Restitution = 0.0f;
 		float RestitutionThreshold = 0.5f;
 
+		uint32_t Layer = 0; // Collision layer, 0 to 15
+		uint16_t LayerMask = 0xFFFF; // Layers this collider collides with
+
 		// Storage for runtime
 		void* RuntimeFixture = nullptr;
 
 		CircleCollider2DComponent() = default;
 		CircleCollider2DComponent(const CircleCollider2DComponent&) = default;
 	};
+
+	// Convex polygon, Box2D takes the hull of at most 8 vertices
+	struct PolygonCollider2DComponent
+	{
+		static constexpr uint32_t MaxVertices = 8;
+
+		std::vector<glm::vec2> Vertices = { { -0.5f, -0.5f }, { 0.5f, -0.5f }, { 0.5f, 0.5f }, { -0.5f, 0.5f } };
+
+		float Density = 1.0f;
+		float Friction = 0.5f;
+		float Restitution = 0.0f;
+		float RestitutionThreshold = 0.5f;
+
+		uint32_t Layer = 0; // Collision layer, 0 to 15
+		uint16_t LayerMask = 0xFFFF; // Layers this collider collides with
+
+		// Storage for runtime
+		void* RuntimeFixture = nullptr;
+
+		PolygonCollider2DComponent() = default;
+		PolygonCollider2DComponent(const PolygonCollider2DComponent&) = default;
+	};
+
+	// Two circles joined by a box, Box2D has no capsule shape of its own
+	struct CapsuleCollider2DComponent
+	{
+		glm::vec2 Offset = { 0.0f, 0.0f };
+		float Radius = 0.25f;
+		float Height = 0.5f; // Distance between the centers of the two caps
+
+		float Density = 1.0f;
+		float Friction = 0.5f;
+		float Restitution = 0.0f;
+		float RestitutionThreshold = 0.5f;
+
+		uint32_t Layer = 0; // Collision layer, 0 to 15
+		uint16_t LayerMask = 0xFFFF; // Layers this collider collides with
+
+		// Storage for runtime
+		std::vector<void*> RuntimeFixtures;
+
+		CapsuleCollider2DComponent() = default;
+		CapsuleCollider2DComponent(const CapsuleCollider2DComponent&) = default;
+	};
+
+	// One-sided edge chains for level geometry. The solid side is on the left when walking along a chain,
+	// so loops around solid ground go counterclockwise. Chains have no mass, use them on static bodies.
+	struct ChainCollider2DComponent
+	{
+		struct Chain
+		{
+			std::vector<glm::vec2> Vertices;
+			bool Loop = true;
+		};
+
+		std::vector<Chain> Chains;
+
+		float Friction = 0.5f;
+		float Restitution = 0.0f;
+		float RestitutionThreshold = 0.5f;
+
+		uint32_t Layer = 0; // Collision layer, 0 to 15
+		uint16_t LayerMask = 0xFFFF; // Layers this collider collides with
+
+		// Storage for runtime
+		std::vector<void*> RuntimeFixtures;
+
+		ChainCollider2DComponent() = default;
+		ChainCollider2DComponent(const ChainCollider2DComponent&) = default;
+	};
+
+	template<typename T>
+	struct ComponentType
+	{
+		using Type = T;
+	};
+
+	// A list of component types, the systems that have to handle every component loop over AllComponents
+	// instead of naming each type
+	template<typename... Component>
+	struct ComponentGroup
+	{
+		template<typename T>
+		static constexpr bool Contains = (std::is_same_v<T, Component> || ...);
+
+		static constexpr size_t Count = sizeof...(Component);
+
+		// Calls func with a ComponentType<T> for every component, in the order of the list
+		template<typename Func>
+		static void Each(Func&& func)
+		{
+			(func(ComponentType<Component>{}), ...);
+		}
+	};
+
+	// Every component, in the order they are shown in the editor and written to scene files
+	using AllComponents = ComponentGroup<IDComponent, TagComponent, PrefabInstanceComponent, TransformComponent,
+		CameraComponent, SpriteRendererComponent, CircleRendererComponent, TextComponent, StaticComponent, ParticleEmitterComponent,
+		TilemapComponent, NativeScriptComponent, Rigidbody2DComponent, BoxCollider2DComponent,
+		CircleCollider2DComponent, PolygonCollider2DComponent, CapsuleCollider2DComponent, ChainCollider2DComponent>;
 }
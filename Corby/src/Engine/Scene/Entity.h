@@ -17,6 +17,7 @@ namespace Engine
 		template<typename T, typename... Args>
 		T& AddComponent(Args&&... args)
 		{
+			static_assert(AllComponents::Contains<T>, "Component is missing from AllComponents!");
 			ENG_CORE_ASSERT(!HasComponent<T>(), "Entity already has component!");
 			T& component = m_scene->m_registry.emplace<T>(m_entityHandle, std::forward<Args>(args)...);
 			m_scene->OnComponentAdded<T>(*this, component);
@@ -26,11 +27,20 @@ namespace Engine
 		template<typename T, typename... Args>
 		T& AddOrReplaceComponent(Args&&... args)
 		{
+			static_assert(AllComponents::Contains<T>, "Component is missing from AllComponents!");
 			T& component = m_scene->m_registry.emplace_or_replace<T>(m_entityHandle, std::forward<Args>(args)...);
 			m_scene->OnComponentAdded<T>(*this, component);
 			return component;
 		}
 
+		// Notifies the scene that a component was modified in place
+		template<typename T>
+		void PatchComponent()
+		{
+			ENG_CORE_ASSERT(HasComponent<T>(), "Entity does not have component!");
+			m_scene->m_registry.patch<T>(m_entityHandle);
+		}
+
 		template<typename T>
 		T& GetComponent()
 		{
@@ -56,7 +66,7 @@ namespace Engine
 		operator uint32_t() const { return (uint32_t) m_entityHandle; }
 
 		UUID GetUUID() { return GetComponent<IDComponent>().ID; }
-		const std::string& GetName() { return GetComponent<TagComponent>().Tag; }
+		const std::string& GetName() { return GetComponent<TagComponent>().Tag.Get(); }
 
 		bool operator==(const Entity& other) const
 		{
@@ -71,5 +81,8 @@ namespace Engine
 	private:
 		entt::entity m_entityHandle{ entt::null };
 		Scene* m_scene = nullptr;
+
+		friend class Prefab;
+		friend class ScriptableEntity;
 	};
 }
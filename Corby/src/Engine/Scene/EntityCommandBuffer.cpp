@@ -0,0 +1,129 @@
+#include "engpch.h"
+#include "EntityCommandBuffer.h"
+
+#include "Engine/Scene/Components.h"
+
+namespace Engine
+{
+	EntityCommandBuffer::~EntityCommandBuffer()
+	{
+		Clear();
+	}
+
+	DeferredEntity EntityCommandBuffer::CreateEntity(InternedString name)
+	{
+		m_createdNames.push_back(name);
+		return { (uint32_t) m_createdNames.size() - 1 };
+	}
+
+	void EntityCommandBuffer::Playback(Scene& scene)
+	{
+		ENG_PROFILE_FUNCTION();
+
+		// Playing back can record new commands, scripts that are destroyed record into the buffer of their thread
+		// from OnDestroy. The recorded lists are moved out first, so new commands land in the emptied buffer and
+		// are played back in the next round. Their data is allocated behind that of the round being played back.
+		while (!IsEmpty())
+		{
+			std::swap(m_createdNames, m_playbackNames);
+			std::swap(m_commands, m_playbackCommands);
+			std::swap(m_destroyed, m_playbackDestroyed);
+
+			PlaybackRound(scene);
+
+			for (const Command& command : m_playbackCommands)
+			{
+				if (command.Destroy)
+					command.Destroy(command.Data);
+			}
+
+			m_playbackNames.clear();
+			m_playbackCommands.clear();
+			m_playbackDestroyed.clear();
+		}
+
+		m_blockIndex = 0;
+		m_blockOffset = 0;
+	}
+
+	void EntityCommandBuffer::PlaybackRound(Scene& scene)
+	{
+		std::vector<Entity> created = scene.CreateEntities(m_playbackNames.size());
+		for (size_t i = 0; i < created.size(); i++)
+		{
+			if (!m_playbackNames[i].empty())
+			{
+				created[i].GetComponent<TagComponent>().Tag = m_playbackNames[i];
+				created[i].PatchComponent<TagComponent>();
+			}
+		}
+
+		auto resolve = [&] (const CommandTarget& target) {
+			return target.Created == NotCreated ? target.Handle : (entt::entity) created[target.Created];
+		};
+
+		for (const Command& command : m_playbackCommands)
+		{
+			entt::entity entity = resolve(command.Target);
+			if (scene.m_registry.valid(entity))
+				command.Apply(scene, entity, command.Data);
+		}
+
+		// An entity can be destroyed by more than one command, the registry must only see it once
+		std::vector<entt::entity> handles;
+		handles.reserve(m_playbackDestroyed.size());
+		for (const CommandTarget& target : m_playbackDestroyed)
+		{
+			entt::entity entity = resolve(target);
+			if (scene.m_registry.valid(entity))
+				handles.push_back(entity);
+		}
+
+		std::sort(handles.begin(), handles.end());
+		handles.erase(std::unique(handles.begin(), handles.end()), handles.end());
+
+		std::vector<Entity> destroyed;
+		destroyed.reserve(handles.size());
+		for (auto handle : handles)
+			destroyed.emplace_back(handle, &scene);
+
+		scene.DestroyEntities(destroyed);
+	}
+
+	void EntityCommandBuffer::Clear()
+	{
+		for (const Command& command : m_commands)
+		{
+			if (command.Destroy)
+				command.Destroy(command.Data);
+		}
+
+		m_createdNames.clear();
+		m_commands.clear();
+		m_destroyed.clear();
+		m_blockIndex = 0;
+		m_blockOffset = 0;
+	}
+
+	void* EntityCommandBuffer::Allocate(size_t size, size_t alignment)
+	{
+		ENG_CORE_ASSERT(size + alignment <= BlockSize, "Component is too large for a command buffer!");
+
+		while (true)
+		{
+			if (m_blockIndex == m_blocks.size())
+				m_blocks.push_back(Scope<uint8_t[]>(new uint8_t[BlockSize]));
+
+			uintptr_t base = (uintptr_t) m_blocks[m_blockIndex].get();
+			uintptr_t aligned = (base + m_blockOffset + alignment - 1) & ~(uintptr_t) (alignment - 1);
+			if (aligned + size <= base + BlockSize)
+			{
+				m_blockOffset = aligned + size - base;
+				return (void*) aligned;
+			}
+
+			m_blockIndex++;
+			m_blockOffset = 0;
+		}
+	}
+}
@@ -0,0 +1,148 @@
+#pragma once
+
+#include "Engine/Core/Base.h"
+#include "Engine/Core/InternedString.h"
+#include "Engine/Scene/Entity.h"
+
+#include <entt.hpp>
+#include <vector>
+
+namespace Engine
+{
+	// An entity created through an EntityCommandBuffer, it only exists once the buffer has been played back.
+	// Until then it can be used as the target of other commands of the same buffer.
+	struct DeferredEntity
+	{
+		uint32_t Index;
+	};
+
+	// Records structural changes to a scene, creating and destroying entities and adding and removing components,
+	// so they can be made while views are being walked. Scripts and systems record into the buffer of their thread
+	// (Scene::GetCommandBuffer) and the scene plays the buffers back at its sync points.
+	//
+	// Playback creates all entities in one batch, then runs the component commands in the order they were
+	// recorded and destroys the entities last, again in one batch. Commands on entities that are gone by then
+	// are skipped. Commands recorded during playback follow in another round.
+	class EntityCommandBuffer
+	{
+	public:
+		EntityCommandBuffer() = default;
+		EntityCommandBuffer(const EntityCommandBuffer&) = delete;
+		EntityCommandBuffer& operator=(const EntityCommandBuffer&) = delete;
+		~EntityCommandBuffer();
+
+		// The name is interned when the command is recorded, playback only copies it
+		DeferredEntity CreateEntity(InternedString name = InternedString());
+
+		void DestroyEntity(Entity entity) { m_destroyed.push_back(MakeTarget(entity)); }
+		void DestroyEntity(DeferredEntity entity) { m_destroyed.push_back(MakeTarget(entity)); }
+
+		template<typename T, typename... Args>
+		void AddComponent(Entity entity, Args&&... args) { RecordAdd<T>(MakeTarget(entity), std::forward<Args>(args)...); }
+		template<typename T, typename... Args>
+		void AddComponent(DeferredEntity entity, Args&&... args) { RecordAdd<T>(MakeTarget(entity), std::forward<Args>(args)...); }
+
+		template<typename T>
+		void RemoveComponent(Entity entity) { RecordRemove<T>(MakeTarget(entity)); }
+		template<typename T>
+		void RemoveComponent(DeferredEntity entity) { RecordRemove<T>(MakeTarget(entity)); }
+
+		bool IsEmpty() const { return m_createdNames.empty() && m_commands.empty() && m_destroyed.empty(); }
+
+		// Applies the commands to the scene and clears the buffer, commands recorded meanwhile are applied as well
+		void Playback(Scene& scene);
+		void Clear();
+
+	private:
+		// Either an entity that already exists or the index of one created by this buffer
+		struct CommandTarget
+		{
+			entt::entity Handle;
+			uint32_t Created;
+		};
+
+		static constexpr uint32_t NotCreated = ~0u;
+
+		struct Command
+		{
+			CommandTarget Target;
+			void (*Apply)(Scene& scene, entt::entity entity, void* data);
+			void (*Destroy)(void* data); // Null for components that don't need their destructor called
+			void* Data;
+		};
+
+		static CommandTarget MakeTarget(Entity entity) { return { (entt::entity) entity, NotCreated }; }
+		static CommandTarget MakeTarget(DeferredEntity entity) { return { entt::null, entity.Index }; }
+
+		template<typename T, typename... Args>
+		void RecordAdd(CommandTarget target, Args&&... args)
+		{
+			void* data = Allocate(sizeof(T), alignof(T));
+			if constexpr (std::is_aggregate_v<T>)
+				new (data) T{ std::forward<Args>(args)... };
+			else
+				new (data) T(std::forward<Args>(args)...);
+
+			Command command;
+			command.Target = target;
+			command.Apply = &ApplyAdd<T>;
+			command.Destroy = std::is_trivially_destructible_v<T> ? nullptr : &DestroyData<T>;
+			command.Data = data;
+			m_commands.push_back(command);
+		}
+
+		template<typename T>
+		void RecordRemove(CommandTarget target)
+		{
+			m_commands.push_back({ target, &ApplyRemove<T>, nullptr, nullptr });
+		}
+
+		template<typename T>
+		static void ApplyAdd(Scene& scene, entt::entity entity, void* data)
+		{
+			T& recorded = *(T*) data;
+			if constexpr (std::is_empty_v<T>)
+			{
+				scene.m_registry.emplace_or_replace<T>(entity);
+			} else
+			{
+				T& component = scene.m_registry.emplace_or_replace<T>(entity, std::move(recorded));
+				scene.OnComponentAdded<T>(Entity{ entity, &scene }, component);
+			}
+		}
+
+		template<typename T>
+		static void ApplyRemove(Scene& scene, entt::entity entity, void* data)
+		{
+			scene.m_registry.remove<T>(entity);
+		}
+
+		template<typename T>
+		static void DestroyData(void* data)
+		{
+			((T*) data)->~T();
+		}
+
+		void PlaybackRound(Scene& scene);
+
+		// Component data is kept in blocks that are reused after playback, recording only allocates while
+		// a buffer grows past what earlier frames needed
+		void* Allocate(size_t size, size_t alignment);
+
+	private:
+		static constexpr size_t BlockSize = 16 * 1024;
+
+		std::vector<InternedString> m_createdNames;
+		std::vector<Command> m_commands;
+		std::vector<CommandTarget> m_destroyed;
+
+		// The lists being played back, kept to reuse their capacity
+		std::vector<InternedString> m_playbackNames;
+		std::vector<Command> m_playbackCommands;
+		std::vector<CommandTarget> m_playbackDestroyed;
+
+		std::vector<Scope<uint8_t[]>> m_blocks;
+		size_t m_blockIndex = 0;
+		size_t m_blockOffset = 0;
+	};
+}
@@ -0,0 +1,291 @@
+#pragma once
+
+#include "Engine/Core/InternedString.h"
+#include "Engine/Renderer/Font.h"
+#include "Engine/Renderer/Texture.h"
+#include "Engine/Scene/ComponentReflection.h"
+
+#include <algorithm>
+#include <glm/glm.hpp>
+#include <yaml-cpp/yaml.h>
+
+// Writes reflected types to scene files and reads them back. Used by the scene serializer and by the script
+// states of script systems, which are reflected in the code of the application.
+
+namespace YAML
+{
+	template<>
+	struct convert<glm::vec2>
+	{
+		static Node encode(const glm::vec2& rhs)
+		{
+			Node node;
+			node.push_back(rhs.x);
+			node.push_back(rhs.y);
+			node.SetStyle(EmitterStyle::Flow);
+
+			return node;
+		}
+
+		static bool decode(const Node& node, glm::vec2& rhs)
+		{
+			if (!node.IsSequence() || node.size() != 2)
+				return false;
+
+			rhs.x = node[0].as<float>();
+			rhs.y = node[1].as<float>();
+
+			return true;
+		}
+	};
+
+	template<>
+	struct convert<glm::vec3>
+	{
+		static Node encode(const glm::vec3& rhs)
+		{
+			Node node;
+			node.push_back(rhs.x);
+			node.push_back(rhs.y);
+			node.push_back(rhs.z);
+			node.SetStyle(EmitterStyle::Flow);
+
+			return node;
+		}
+
+		static bool decode(const Node& node, glm::vec3& rhs)
+		{
+			if (!node.IsSequence() || node.size() != 3)
+				return false;
+
+			rhs.x = node[0].as<float>();
+			rhs.y = node[1].as<float>();
+			rhs.z = node[2].as<float>();
+
+			return true;
+		}
+	};
+
+	template<>
+	struct convert<glm::vec4>
+	{
+		static Node encode(const glm::vec4& rhs)
+		{
+			Node node;
+			node.push_back(rhs.x);
+			node.push_back(rhs.y);
+			node.push_back(rhs.z);
+			node.push_back(rhs.w);
+			node.SetStyle(EmitterStyle::Flow);
+
+			return node;
+		}
+
+		static bool decode(const Node& node, glm::vec4& rhs)
+		{
+			if (!node.IsSequence() || node.size() != 4)
+				return false;
+
+			rhs.x = node[0].as<float>();
+			rhs.y = node[1].as<float>();
+			rhs.z = node[2].as<float>();
+			rhs.w = node[3].as<float>();
+
+			return true;
+		}
+	};
+}
+
+namespace Engine
+{
+	inline YAML::Emitter& operator<<(YAML::Emitter& out, const glm::vec2& v)
+	{
+		out << YAML::Flow;
+		out << YAML::BeginSeq << v.x << v.y << YAML::EndSeq;
+
+		return out;
+	}
+
+	inline YAML::Emitter& operator<<(YAML::Emitter& out, const glm::vec3& v)
+	{
+		out << YAML::Flow;
+		out << YAML::BeginSeq << v.x << v.y << v.z << YAML::EndSeq;
+
+		return out;
+	}
+
+	inline YAML::Emitter& operator<<(YAML::Emitter& out, const glm::vec4& v)
+	{
+		out << YAML::Flow;
+		out << YAML::BeginSeq << v.x << v.y << v.z << v.w << YAML::EndSeq;
+
+		return out;
+	}
+
+	template<typename T>
+	struct IsRef : std::false_type {};
+
+	template<typename T>
+	struct IsRef<Ref<T>> : std::true_type {};
+
+	// Vectors of plain values can be written as packed binary
+	template<typename T>
+	struct IsPackable : std::false_type {};
+
+	template<typename T, typename Allocator>
+	struct IsPackable<std::vector<T, Allocator>> : std::bool_constant<std::is_trivially_copyable_v<T>> {};
+
+	template<typename T>
+	void SerializeValue(YAML::Emitter& out, const T& value);
+
+	// Writes the fields of a reflected type as a map, with a base only the fields that differ from it
+	template<typename T>
+	void SerializeFields(YAML::Emitter& out, const T& object, const T* base = nullptr)
+	{
+		out << YAML::BeginMap;
+		ForEachField<T>([&] (const auto& field) {
+			using Value = typename std::decay_t<decltype(field)>::ValueType;
+			decltype(auto) value = field.Get(object);
+
+			if (base && ValuesEqual(value, field.Get(*base)))
+				return;
+
+			// Assets that are not set are left out
+			if constexpr (IsRef<Value>::value)
+			{
+				if (!value)
+					return;
+			}
+
+			out << YAML::Key << field.Name << YAML::Value;
+			if constexpr (IsPackable<Value>::value)
+			{
+				if (field.Flags & FieldPacked)
+				{
+					out << YAML::Binary((const unsigned char*) value.data(), value.size() * sizeof(typename Value::value_type));
+					return;
+				}
+			}
+
+			SerializeValue(out, value);
+			});
+		out << YAML::EndMap;
+	}
+
+	template<typename T>
+	void SerializeValue(YAML::Emitter& out, const T& value)
+	{
+		if constexpr (Reflection<T>::Reflected)
+		{
+			SerializeFields(out, value);
+		} else if constexpr (std::is_enum_v<T>)
+		{
+			if constexpr (EnumInfo<T>::Named)
+				out << EnumInfo<T>::Names[(int) value];
+			else
+				out << (int) value;
+		} else if constexpr (IsVector<T>::value)
+		{
+			out << YAML::BeginSeq;
+			for (const auto& element : value)
+				SerializeValue(out, element);
+			out << YAML::EndSeq;
+		} else if constexpr (std::is_same_v<T, Ref<Texture2D>>)
+		{
+			out << value->GetPath();
+		} else if constexpr (std::is_same_v<T, Ref<Font>>)
+		{
+			out << value->GetPath().string();
+		} else if constexpr (std::is_same_v<T, InternedString>)
+		{
+			out << value.Get();
+		} else
+		{
+			out << value;
+		}
+	}
+
+	template<typename T>
+	void DeserializeValue(const YAML::Node& node, T& value);
+
+	// Keys that are missing keep the current value, so files written before a field existed still load
+	template<typename T>
+	void DeserializeFields(const YAML::Node& node, T& object)
+	{
+		ForEachField<T>([&] (const auto& field) {
+			using Value = typename std::decay_t<decltype(field)>::ValueType;
+
+			YAML::Node fieldNode = node[field.Name];
+			if (!fieldNode)
+				return;
+
+			Value value = field.Get(object);
+			if constexpr (IsPackable<Value>::value)
+			{
+				if (field.Flags & FieldPacked)
+				{
+					using Element = typename Value::value_type;
+					YAML::Binary binary = fieldNode.as<YAML::Binary>();
+					const Element* elements = (const Element*) binary.data();
+					value.assign(elements, elements + binary.size() / sizeof(Element));
+					field.Set(object, value);
+					return;
+				}
+			}
+
+			DeserializeValue(fieldNode, value);
+			if constexpr (std::is_arithmetic_v<Value>)
+			{
+				if (field.Flags & FieldSlider)
+					value = (Value) std::clamp((float) value, field.Min, field.Max);
+			}
+
+			field.Set(object, value);
+			});
+	}
+
+	template<typename T>
+	void DeserializeValue(const YAML::Node& node, T& value)
+	{
+		if constexpr (Reflection<T>::Reflected)
+		{
+			DeserializeFields(node, value);
+		} else if constexpr (std::is_enum_v<T>)
+		{
+			if constexpr (EnumInfo<T>::Named)
+			{
+				std::string name = node.as<std::string>();
+				for (size_t i = 0; i < std::size(EnumInfo<T>::Names); i++)
+				{
+					if (name == EnumInfo<T>::Names[i])
+					{
+						value = (T) i;
+						return;
+					}
+				}
+
+				ENG_CORE_ASSERT(false, "Unknown enum value!");
+			} else
+			{
+				value = (T) node.as<int>();
+			}
+		} else if constexpr (IsVector<T>::value)
+		{
+			value.clear();
+			for (auto elementNode : node)
+				DeserializeValue(elementNode, value.emplace_back());
+		} else if constexpr (std::is_same_v<T, Ref<Texture2D>>)
+		{
+			value = Texture2D::Create(node.as<std::string>());
+		} else if constexpr (std::is_same_v<T, Ref<Font>>)
+		{
+			value = Font::Load(node.as<std::string>());
+		} else if constexpr (std::is_same_v<T, InternedString>)
+		{
+			value = node.as<std::string>();
+		} else
+		{
+			value = node.as<T>();
+		}
+	}
+}
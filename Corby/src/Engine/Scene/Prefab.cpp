@@ -0,0 +1,88 @@
+#include "engpch.h"
+#include "Prefab.h"
+
+#include "Engine/Scene/Components.h"
+#include "Engine/Scene/SceneSerializer.h"
+#include "Engine/Scene/ScriptSystem.h"
+
+namespace Engine
+{
+	static std::unordered_map<std::string, Ref<Prefab>> s_prefabCache;
+
+	Prefab::Prefab(const std::filesystem::path& path)
+		: m_path(path), m_entity(m_registry.create())
+	{}
+
+	void Prefab::CopyTo(Entity entity) const
+	{
+		AllComponents::Each([&] (auto type) {
+			using Component = typename decltype(type)::Type;
+			if constexpr (!std::is_same_v<Component, IDComponent>)
+			{
+				if (const Component* component = TryGetComponent<Component>())
+					entity.AddOrReplaceComponent<Component>(*component);
+			}
+			});
+
+		for (const auto& stateType : ScriptSystemRegistry::GetStateTypes())
+			stateType->Copy(entity.m_scene->m_registry, entity, m_registry, m_entity);
+	}
+
+	void Prefab::Save() const
+	{
+		SceneSerializer::SerializePrefab(*this, m_path.string());
+	}
+
+	Ref<Prefab> Prefab::Create(Entity entity, const std::filesystem::path& path)
+	{
+		// Instances keep the prefab they were made from, a new one under the same path would leave them behind
+		auto it = s_prefabCache.find(path.string());
+		if (it != s_prefabCache.end() && it->second.use_count() > 1)
+		{
+			ENG_CORE_ERROR("Prefab '{0}' still has instances, it is not overwritten", path.string());
+			return nullptr;
+		}
+
+		Ref<Prefab> prefab = CreateRef<Prefab>(path);
+
+		// Prefabs don't nest, a prefab made from an instance stands on its own
+		AllComponents::Each([&] (auto type) {
+			using Component = typename decltype(type)::Type;
+			if constexpr (!std::is_same_v<Component, IDComponent> && !std::is_same_v<Component, PrefabInstanceComponent>)
+			{
+				if (entity.HasComponent<Component>())
+					prefab->m_registry.emplace<Component>(prefab->m_entity, entity.GetComponent<Component>());
+			}
+			});
+
+		for (const auto& stateType : ScriptSystemRegistry::GetStateTypes())
+			stateType->Copy(prefab->m_registry, prefab->m_entity, entity.m_scene->m_registry, entity);
+
+		prefab->Save();
+		s_prefabCache[path.string()] = prefab;
+		return prefab;
+	}
+
+	Ref<Prefab> Prefab::Load(const std::filesystem::path& path)
+	{
+		std::string key = path.string();
+		auto it = s_prefabCache.find(key);
+		if (it != s_prefabCache.end())
+			return it->second;
+
+		Ref<Prefab> prefab = CreateRef<Prefab>(path);
+		if (!SceneSerializer::DeserializePrefab(*prefab, key))
+		{
+			ENG_CORE_ERROR("Could not load prefab '{0}'", key);
+			return nullptr;
+		}
+
+		s_prefabCache[key] = prefab;
+		return prefab;
+	}
+
+	void Prefab::ClearCache()
+	{
+		s_prefabCache.clear();
+	}
+}
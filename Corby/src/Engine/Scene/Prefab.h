@@ -0,0 +1,51 @@
+#pragma once
+
+#include "Engine/Core/Base.h"
+#include "Engine/Scene/Entity.h"
+
+#include <entt.hpp>
+#include <filesystem>
+
+namespace Engine
+{
+	// An entity stored as an asset of its own. Instances start out as a copy of its components and link back to
+	// it through a PrefabInstanceComponent, scene files then only keep the fields an instance changed.
+	class Prefab
+	{
+	public:
+		Prefab(const std::filesystem::path& path);
+
+		const std::filesystem::path& GetPath() const { return m_path; }
+
+		entt::registry& GetRegistry() { return m_registry; }
+		const entt::registry& GetRegistry() const { return m_registry; }
+		entt::entity GetEntity() const { return m_entity; }
+
+		template<typename T>
+		const T* TryGetComponent() const
+		{
+			return m_registry.try_get<T>(m_entity);
+		}
+
+		// Gives the entity a copy of every component of the prefab, except for the identifier
+		void CopyTo(Entity entity) const;
+
+		// Writes the prefab to its file
+		void Save() const;
+
+		// Copies the components of the entity into a new prefab and saves it, the entity is left as it is. Returns
+		// null if a loaded prefab with instances has the same path.
+		static Ref<Prefab> Create(Entity entity, const std::filesystem::path& path);
+
+		// Instances share the prefab, loading the same file again returns the prefab that is already loaded
+		static Ref<Prefab> Load(const std::filesystem::path& path);
+
+		// Drops the loaded prefabs, instances that are still around keep theirs
+		static void ClearCache();
+
+	private:
+		std::filesystem::path m_path;
+		entt::registry m_registry;
+		entt::entity m_entity;
+	};
+}
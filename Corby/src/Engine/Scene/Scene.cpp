@@ -1,13 +1,20 @@
 #include "engpch.h"
 #include "Scene.h"
 
+#include "Engine/Physics/Physics2D.h"
 #include "Engine/Renderer/Renderer2D.h"
 #include "Engine/Scene/Components.h"
 #include "Engine/Scene/Entity.h"
+#include "Engine/Scene/EntityCommandBuffer.h"
+#include "Engine/Scene/Prefab.h"
 #include "Engine/Scene/ScriptableEntity.h"
+#include "Engine/Scene/ScriptSystem.h"
 
 #include <box2d/b2_body.h>
+#include <box2d/b2_chain_shape.h>
 #include <box2d/b2_circle_shape.h>
+#include <box2d/b2_collision.h>
+#include <box2d/b2_contact.h>
 #include <box2d/b2_fixture.h>
 #include <box2d/b2_polygon_shape.h>
 #include <box2d/b2_world.h>
@@ -28,11 +35,221 @@ namespace Engine
 		return b2_staticBody;
 	}
 
+	// Every collider component that adds fixtures to the rigidbody on its entity
+	template<typename... Collider>
+	struct Collider2DComponents
+	{
+		template<typename Func>
+		static void Each(entt::registry& registry, entt::entity entity, Func func)
+		{
+			([&] () {
+				if (auto* collider = registry.try_get<Collider>(entity))
+					func(*collider);
+			}(), ...);
+		}
+	};
+
+	using AllCollider2DComponents = Collider2DComponents<BoxCollider2DComponent, CircleCollider2DComponent,
+		PolygonCollider2DComponent, CapsuleCollider2DComponent, ChainCollider2DComponent>;
+
+	template<typename Collider>
+	static b2Fixture* CreateFixture(b2Body* body, const b2Shape& shape, const Collider& collider)
+	{
+		b2FixtureDef fixtureDef;
+		fixtureDef.shape = &shape;
+		fixtureDef.density = collider.Density;
+		fixtureDef.friction = collider.Friction;
+		fixtureDef.restitution = collider.Restitution;
+		fixtureDef.restitutionThreshold = collider.RestitutionThreshold;
+		fixtureDef.filter.categoryBits = (uint16) (1 << collider.Layer);
+		fixtureDef.filter.maskBits = collider.LayerMask;
+		return body->CreateFixture(&fixtureDef);
+	}
+
+	// Fixtures are created in body space, scaled by the transform of the entity
+	static void AttachCollider(b2Body* body, const TransformComponent& transform, BoxCollider2DComponent& boxCollider)
+	{
+		b2PolygonShape boxShape;
+		boxShape.SetAsBox(boxCollider.Size.x * transform.Scale.x, boxCollider.Size.y * transform.Scale.y);
+		boxCollider.RuntimeFixture = CreateFixture(body, boxShape, boxCollider);
+	}
+
+	static void AttachCollider(b2Body* body, const TransformComponent& transform, CircleCollider2DComponent& circleCollider)
+	{
+		b2CircleShape circleShape;
+		circleShape.m_p.Set(circleCollider.Offset.x, circleCollider.Offset.y);
+		circleShape.m_radius = transform.Scale.x * circleCollider.Radius;
+		circleCollider.RuntimeFixture = CreateFixture(body, circleShape, circleCollider);
+	}
+
+	static void AttachCollider(b2Body* body, const TransformComponent& transform, PolygonCollider2DComponent& polygonCollider)
+	{
+		uint32_t count = (uint32_t) polygonCollider.Vertices.size();
+		if (count < 3 || count > PolygonCollider2DComponent::MaxVertices)
+		{
+			ENG_CORE_ERROR("Polygon collider needs 3 to {0} vertices, got {1}", PolygonCollider2DComponent::MaxVertices, count);
+			return;
+		}
+
+		b2Vec2 vertices[PolygonCollider2DComponent::MaxVertices];
+		for (uint32_t i = 0; i < count; i++)
+			vertices[i].Set(polygonCollider.Vertices[i].x * transform.Scale.x, polygonCollider.Vertices[i].y * transform.Scale.y);
+
+		b2PolygonShape polygonShape;
+		polygonShape.Set(vertices, (int32) count);
+		polygonCollider.RuntimeFixture = CreateFixture(body, polygonShape, polygonCollider);
+	}
+
+	static void AttachCollider(b2Body* body, const TransformComponent& transform, CapsuleCollider2DComponent& capsuleCollider)
+	{
+		glm::vec2 center = capsuleCollider.Offset * glm::vec2(transform.Scale);
+		float radius = capsuleCollider.Radius * transform.Scale.x;
+		float halfHeight = capsuleCollider.Height * 0.5f * transform.Scale.y;
+
+		b2PolygonShape boxShape;
+		boxShape.SetAsBox(radius, halfHeight, b2Vec2(center.x, center.y), 0.0f);
+		capsuleCollider.RuntimeFixtures.push_back(CreateFixture(body, boxShape, capsuleCollider));
+
+		b2CircleShape circleShape;
+		circleShape.m_radius = radius;
+		for (float side : { -1.0f, 1.0f })
+		{
+			circleShape.m_p.Set(center.x, center.y + side * halfHeight);
+			capsuleCollider.RuntimeFixtures.push_back(CreateFixture(body, circleShape, capsuleCollider));
+		}
+	}
+
+	static void AttachCollider(b2Body* body, const TransformComponent& transform, ChainCollider2DComponent& chainCollider)
+	{
+		std::vector<b2Vec2> vertices;
+		for (const auto& chain : chainCollider.Chains)
+		{
+			uint32_t minVertices = chain.Loop ? 3 : 2;
+			if (chain.Vertices.size() < minVertices)
+				continue;
+
+			vertices.clear();
+			for (const auto& vertex : chain.Vertices)
+				vertices.emplace_back(vertex.x * transform.Scale.x, vertex.y * transform.Scale.y);
+
+			b2ChainShape chainShape;
+			if (chain.Loop)
+				chainShape.CreateLoop(vertices.data(), (int32) vertices.size());
+			else
+				chainShape.CreateChain(vertices.data(), (int32) vertices.size(), vertices.front(), vertices.back());
+
+			b2FixtureDef fixtureDef;
+			fixtureDef.shape = &chainShape;
+			fixtureDef.friction = chainCollider.Friction;
+			fixtureDef.restitution = chainCollider.Restitution;
+			fixtureDef.restitutionThreshold = chainCollider.RestitutionThreshold;
+			fixtureDef.filter.categoryBits = (uint16) (1 << chainCollider.Layer);
+			fixtureDef.filter.maskBits = chainCollider.LayerMask;
+			chainCollider.RuntimeFixtures.push_back(body->CreateFixture(&fixtureDef));
+		}
+	}
+
+	// Without a body the fixtures are already gone and only the handles are reset
+	static void DetachFixture(b2Body* body, void*& fixture)
+	{
+		if (body && fixture)
+			body->DestroyFixture((b2Fixture*) fixture);
+
+		fixture = nullptr;
+	}
+
+	static void DetachFixtures(b2Body* body, std::vector<void*>& fixtures)
+	{
+		for (void*& fixture : fixtures)
+			DetachFixture(body, fixture);
+
+		fixtures.clear();
+	}
+
+	static void DetachCollider(b2Body* body, BoxCollider2DComponent& boxCollider) { DetachFixture(body, boxCollider.RuntimeFixture); }
+	static void DetachCollider(b2Body* body, CircleCollider2DComponent& circleCollider) { DetachFixture(body, circleCollider.RuntimeFixture); }
+	static void DetachCollider(b2Body* body, PolygonCollider2DComponent& polygonCollider) { DetachFixture(body, polygonCollider.RuntimeFixture); }
+	static void DetachCollider(b2Body* body, CapsuleCollider2DComponent& capsuleCollider) { DetachFixtures(body, capsuleCollider.RuntimeFixtures); }
+	static void DetachCollider(b2Body* body, ChainCollider2DComponent& chainCollider) { DetachFixtures(body, chainCollider.RuntimeFixtures); }
+
+	static bool IsColliderAttached(const BoxCollider2DComponent& boxCollider) { return boxCollider.RuntimeFixture != nullptr; }
+	static bool IsColliderAttached(const CircleCollider2DComponent& circleCollider) { return circleCollider.RuntimeFixture != nullptr; }
+	static bool IsColliderAttached(const PolygonCollider2DComponent& polygonCollider) { return polygonCollider.RuntimeFixture != nullptr; }
+	static bool IsColliderAttached(const CapsuleCollider2DComponent& capsuleCollider) { return !capsuleCollider.RuntimeFixtures.empty(); }
+	static bool IsColliderAttached(const ChainCollider2DComponent& chainCollider) { return !chainCollider.RuntimeFixtures.empty(); }
+
+	static const size_t StaticGroupSize = 4096;
+
+	class Scene::ContactListener : public b2ContactListener
+	{
+	public:
+		ContactListener(std::vector<ContactEvent>& events)
+			: m_events(events)
+		{}
+
+		void BeginContact(b2Contact* contact) override { Record(contact, true); }
+		void EndContact(b2Contact* contact) override { Record(contact, false); }
+
+	private:
+		void Record(b2Contact* contact, bool begin)
+		{
+			auto* bodyDataA = (PhysicsBodyData*) contact->GetFixtureA()->GetBody()->GetUserData().pointer;
+			auto* bodyDataB = (PhysicsBodyData*) contact->GetFixtureB()->GetBody()->GetUserData().pointer;
+			m_events.push_back({ bodyDataA->Entity, bodyDataB->Entity, begin });
+		}
+
+	private:
+		std::vector<ContactEvent>& m_events;
+	};
+
 	Scene::Scene()
-	{}
+	{
+		for (uint32_t i = 0; i <= JobSystem::GetWorkerCount(); i++)
+			m_commandBuffers.push_back(CreateScope<EntityCommandBuffer>());
+
+		m_scriptSystems = ScriptSystemRegistry::CreateSystems();
+
+		m_registry.on_construct<IDComponent>().connect<&Scene::OnIDComponentConstruct>(*this);
+		m_registry.on_update<IDComponent>().connect<&Scene::OnIDComponentUpdate>(*this);
+		m_registry.on_destroy<IDComponent>().connect<&Scene::OnIDComponentDestroy>(*this);
+		m_registry.on_construct<TagComponent>().connect<&Scene::OnTagComponentConstruct>(*this);
+		m_registry.on_update<TagComponent>().connect<&Scene::OnTagComponentConstruct>(*this);
+		m_registry.on_destroy<TagComponent>().connect<&Scene::OnTagComponentDestroy>(*this);
+		m_registry.on_destroy<NativeScriptComponent>().connect<&Scene::OnNativeScriptComponentDestroy>(*this);
+
+		m_registry.on_construct<StaticComponent>().connect<&Scene::OnStaticComponentConstruct>(*this);
+		m_registry.on_destroy<StaticComponent>().connect<&Scene::OnStaticComponentDestroy>(*this);
+
+		m_registry.on_update<TransformComponent>().connect<&Scene::OnStaticGeometryChanged>(*this);
+		m_registry.on_construct<SpriteRendererComponent>().connect<&Scene::OnStaticGeometryChanged>(*this);
+		m_registry.on_update<SpriteRendererComponent>().connect<&Scene::OnStaticGeometryChanged>(*this);
+		m_registry.on_destroy<SpriteRendererComponent>().connect<&Scene::OnStaticGeometryChanged>(*this);
+		m_registry.on_construct<CircleRendererComponent>().connect<&Scene::OnStaticGeometryChanged>(*this);
+		m_registry.on_update<CircleRendererComponent>().connect<&Scene::OnStaticGeometryChanged>(*this);
+		m_registry.on_destroy<CircleRendererComponent>().connect<&Scene::OnStaticGeometryChanged>(*this);
+
+		m_registry.on_construct<Rigidbody2DComponent>().connect<&Scene::OnRigidbody2DConstruct>(*this);
+		m_registry.on_destroy<Rigidbody2DComponent>().connect<&Scene::OnRigidbody2DDestroy>(*this);
+		m_registry.on_construct<BoxCollider2DComponent>().connect<&Scene::OnCollider2DConstruct<BoxCollider2DComponent>>(*this);
+		m_registry.on_destroy<BoxCollider2DComponent>().connect<&Scene::OnCollider2DDestroy<BoxCollider2DComponent>>(*this);
+		m_registry.on_construct<CircleCollider2DComponent>().connect<&Scene::OnCollider2DConstruct<CircleCollider2DComponent>>(*this);
+		m_registry.on_destroy<CircleCollider2DComponent>().connect<&Scene::OnCollider2DDestroy<CircleCollider2DComponent>>(*this);
+		m_registry.on_construct<PolygonCollider2DComponent>().connect<&Scene::OnCollider2DConstruct<PolygonCollider2DComponent>>(*this);
+		m_registry.on_destroy<PolygonCollider2DComponent>().connect<&Scene::OnCollider2DDestroy<PolygonCollider2DComponent>>(*this);
+		m_registry.on_construct<CapsuleCollider2DComponent>().connect<&Scene::OnCollider2DConstruct<CapsuleCollider2DComponent>>(*this);
+		m_registry.on_destroy<CapsuleCollider2DComponent>().connect<&Scene::OnCollider2DDestroy<CapsuleCollider2DComponent>>(*this);
+		m_registry.on_construct<ChainCollider2DComponent>().connect<&Scene::OnCollider2DConstruct<ChainCollider2DComponent>>(*this);
+		m_registry.on_destroy<ChainCollider2DComponent>().connect<&Scene::OnCollider2DDestroy<ChainCollider2DComponent>>(*this);
+	}
 
 	Scene::~Scene()
-	{}
+	{
+		// A step that is still running on a worker writes into the scene
+		JobSystem::Wait(m_physicsJob);
+
+		delete m_physicsWorld;
+		m_physicsWorld = nullptr;
+	}
 
 	Entity Scene::CreateEntity(const std::string& name)
 	{
@@ -45,8 +262,8 @@ namespace Engine
 		entity.AddComponent<IDComponent>(uuid);
 		entity.AddComponent<TransformComponent>();
 
-		auto& tag = entity.AddComponent<TagComponent>();
-		tag.Tag = name.empty() ? "Entity" : name;
+		// Given to the constructor, the name index is filled when the component is constructed
+		entity.AddComponent<TagComponent>(name.empty() ? "Entity" : name);
 
 		return entity;
 	}
@@ -56,32 +273,176 @@ namespace Engine
 		m_registry.destroy(entity);
 	}
 
-	void Scene::DuplicateEntity(Entity entity)
+	static std::vector<Entity> ToEntities(const std::vector<entt::entity>& handles, Scene* scene)
+	{
+		std::vector<Entity> entities;
+		entities.reserve(handles.size());
+		for (auto handle : handles)
+			entities.emplace_back(handle, scene);
+
+		return entities;
+	}
+
+	std::vector<Entity> Scene::CreateEntities(size_t count, const std::string& name)
+	{
+		// Default constructed identifiers are random
+		std::vector<IDComponent> ids(count);
+		return CreateEntities(ids, name);
+	}
+
+	std::vector<Entity> Scene::CreateEntitiesWithUUIDs(const std::vector<UUID>& uuids, const std::string& name)
+	{
+		std::vector<IDComponent> ids;
+		ids.reserve(uuids.size());
+		for (UUID uuid : uuids)
+			ids.push_back(IDComponent{ uuid });
+
+		return CreateEntities(ids, name);
+	}
+
+	std::vector<Entity> Scene::CreateEntities(const std::vector<IDComponent>& ids, const std::string& name)
+	{
+		ENG_PROFILE_FUNCTION();
+
+		std::vector<entt::entity> handles = CreateEntityHandles(ids);
+		m_registry.insert<TransformComponent>(handles.begin(), handles.end());
+		m_registry.insert<TagComponent>(handles.begin(), handles.end(), TagComponent(name.empty() ? "Entity" : name));
+
+		return ToEntities(handles, this);
+	}
+
+	std::vector<entt::entity> Scene::CreateEntityHandles(const std::vector<IDComponent>& ids)
+	{
+		std::vector<entt::entity> handles(ids.size());
+		m_registry.create(handles.begin(), handles.end());
+		m_registry.insert<IDComponent>(handles.begin(), handles.end(), ids.begin());
+
+		return handles;
+	}
+
+	void Scene::DestroyEntities(const std::vector<Entity>& entities)
+	{
+		ENG_PROFILE_FUNCTION();
+
+		std::vector<entt::entity> handles(entities.begin(), entities.end());
+		m_registry.destroy(handles.begin(), handles.end());
+	}
+
+	EntityCommandBuffer& Scene::GetCommandBuffer()
+	{
+		uint32_t index = JobSystem::GetThreadIndex();
+		ENG_CORE_ASSERT(index < m_commandBuffers.size(), "Scene was created before the job system!");
+		return *m_commandBuffers[index];
+	}
+
+	// Sync point, the main thread buffer goes first and the worker buffers follow in order. Playing back a worker
+	// buffer can record into the main thread buffer again, scripts destroyed by it do, so it is repeated until
+	// all of them are empty.
+	void Scene::PlaybackCommandBuffers()
+	{
+		bool playedBack = true;
+		while (playedBack)
+		{
+			playedBack = false;
+			for (auto& buffer : m_commandBuffers)
+			{
+				if (!buffer->IsEmpty())
+				{
+					buffer->Playback(*this);
+					playedBack = true;
+				}
+			}
+		}
+	}
+
+	Entity Scene::FindEntityByUUID(UUID uuid)
+	{
+		auto it = m_entitiesByUUID.find(uuid);
+		if (it == m_entitiesByUUID.end())
+			return {};
+
+		return { it->second, this };
+	}
+
+	Entity Scene::FindEntityByName(const std::string& name)
+	{
+		// A name that was never interned can't be the tag of any entity
+		InternedString key;
+		if (!InternedString::Find(name, key))
+			return {};
+
+		auto it = m_entitiesByName.find(key);
+		if (it == m_entitiesByName.end())
+			return {};
+
+		return { it->second, this };
+	}
+
+	std::vector<Entity> Scene::FindEntitiesByName(const std::string& name)
+	{
+		std::vector<Entity> entities;
+		InternedString key;
+		if (!InternedString::Find(name, key))
+			return entities;
+
+		auto [begin, end] = m_entitiesByName.equal_range(key);
+		for (auto it = begin; it != end; it++)
+			entities.emplace_back(it->second, this);
+
+		return entities;
+	}
+
+	Entity Scene::DuplicateEntity(Entity entity)
 	{
 		std::string name = entity.GetName();
 		Entity newEntity = CreateEntity(name);
 
-		CopyComponentIfExists<TransformComponent>(newEntity, entity);
-		CopyComponentIfExists<SpriteRendererComponent>(newEntity, entity);
-		CopyComponentIfExists<CircleRendererComponent>(newEntity, entity);
-		CopyComponentIfExists<CameraComponent>(newEntity, entity);
-		CopyComponentIfExists<NativeScriptComponent>(newEntity, entity);
-		CopyComponentIfExists<Rigidbody2DComponent>(newEntity, entity);
-		CopyComponentIfExists<BoxCollider2DComponent>(newEntity, entity);
-		CopyComponentIfExists<CircleCollider2DComponent>(newEntity, entity);
+		// The copy has an identifier of its own and already got the tag
+		AllComponents::Each([&] (auto type) {
+			using Component = typename decltype(type)::Type;
+			if constexpr (!std::is_same_v<Component, IDComponent> && !std::is_same_v<Component, TagComponent>)
+				CopyComponentIfExists<Component>(newEntity, entity);
+			});
+
+		for (const auto& stateType : ScriptSystemRegistry::GetStateTypes())
+			stateType->Copy(m_registry, newEntity, m_registry, entity);
+
+		return newEntity;
 	}
 
-	template<typename Component>
-	static void Scene::CopyComponent(entt::registry& dst, entt::registry& src, const std::unordered_map<UUID, entt::entity>& enttMap)
+	std::vector<Entity> Scene::InstantiatePrefab(const Ref<Prefab>& prefab, size_t count)
 	{
-		auto view = src.view<Component>();
-		for (auto srcEntity : view)
+		ENG_PROFILE_FUNCTION();
+
+		std::vector<IDComponent> ids(count);
+		std::vector<entt::entity> handles = CreateEntityHandles(ids);
+		m_registry.insert<PrefabInstanceComponent>(handles.begin(), handles.end(), PrefabInstanceComponent(prefab));
+
+		AllComponents::Each([&] (auto type) {
+			using Component = typename decltype(type)::Type;
+			if constexpr (!std::is_same_v<Component, IDComponent> && !std::is_same_v<Component, PrefabInstanceComponent>)
+			{
+				if (const Component* component = prefab->TryGetComponent<Component>())
+					m_registry.insert<Component>(handles.begin(), handles.end(), *component);
+			}
+			});
+
+		std::vector<Entity> entities = ToEntities(handles, this);
+		for (Entity entity : entities)
 		{
-			entt::entity dstEntity = enttMap.at(src.get<IDComponent>(srcEntity).ID);
+			if (auto* camera = m_registry.try_get<CameraComponent>(entity))
+				OnComponentAdded<CameraComponent>(entity, *camera);
 
-			auto& srcComponent = src.get<Component>(srcEntity);
-			dst.emplace_or_replace<Component>(dstEntity, srcComponent);
+			for (const auto& stateType : ScriptSystemRegistry::GetStateTypes())
+				stateType->Copy(m_registry, entity, prefab->GetRegistry(), prefab->GetEntity());
 		}
+
+		return entities;
+	}
+
+	Entity Scene::InstantiatePrefab(const Ref<Prefab>& prefab)
+	{
+		return InstantiatePrefab(prefab, 1).front();
 	}
 
 	template<typename Component>
@@ -96,30 +457,21 @@ namespace Engine
 		Ref<Scene> newScene = CreateRef<Scene>();
 		newScene->m_viewportWidth = scene->m_viewportWidth;
 		newScene->m_viewportHeight = scene->m_viewportHeight;
+		newScene->m_physicsSettings = scene->m_physicsSettings;
 
-		std::unordered_map<UUID, entt::entity> enttMap;
-
-		// Create entities in new scene
+		// The copy gets the same entity identifiers and free list, so the component pools can be copied in bulk
+		// without looking entities up by UUID
 		auto& srcSceneRegistry = scene->m_registry;
 		auto& dstSceneRegistry = newScene->m_registry;
-		auto idView = srcSceneRegistry.view<IDComponent>();
-		for (auto e : idView)
-		{
-			auto uuid = srcSceneRegistry.get<IDComponent>(e).ID;
-			const auto& name = srcSceneRegistry.get<TagComponent>(e).Tag;
-			Entity newEntity = newScene->CreateEntityWithUUID(uuid, name);
-			enttMap[uuid] = newEntity;
-		}
+		dstSceneRegistry.assign(srcSceneRegistry.data(), srcSceneRegistry.data() + srcSceneRegistry.size(), srcSceneRegistry.released());
+
+		AllComponents::Each([&] (auto type) {
+			CopyComponent<typename decltype(type)::Type>(dstSceneRegistry, srcSceneRegistry);
+			});
 
-		// Copy components
-		CopyComponent<TransformComponent>(dstSceneRegistry, srcSceneRegistry, enttMap);
-		CopyComponent<SpriteRendererComponent>(dstSceneRegistry, srcSceneRegistry, enttMap);
-		CopyComponent<CircleRendererComponent>(dstSceneRegistry, srcSceneRegistry, enttMap);
-		CopyComponent<CameraComponent>(dstSceneRegistry, srcSceneRegistry, enttMap);
-		CopyComponent<NativeScriptComponent>(dstSceneRegistry, srcSceneRegistry, enttMap);
-		CopyComponent<Rigidbody2DComponent>(dstSceneRegistry, srcSceneRegistry, enttMap);
-		CopyComponent<BoxCollider2DComponent>(dstSceneRegistry, srcSceneRegistry, enttMap);
-		CopyComponent<CircleCollider2DComponent>(dstSceneRegistry, srcSceneRegistry, enttMap);
+		// The copy made script systems of its own, only the states are copied
+		for (const auto& stateType : ScriptSystemRegistry::GetStateTypes())
+			stateType->CopyAll(dstSceneRegistry, srcSceneRegistry);
 
 		return newScene;
 	}
@@ -127,64 +479,40 @@ namespace Engine
 	void Scene::OnRuntimeStart()
 	{
 		m_physicsWorld = new b2World({ 0.0f, -9.8f });
+		m_physicsAccumulator = 0.0f;
+
+		m_contactListener = CreateScope<ContactListener>(m_contactEvents);
+		m_physicsWorld->SetContactListener(m_contactListener.get());
 
+		// Bodies of entities spawned from here on are queued by the component hooks
+		m_pendingPhysicsBodies.clear();
 		auto view = m_registry.view<Rigidbody2DComponent>();
 		for (auto e : view)
-		{
-			Entity entity = { e, this };
-			auto& transform = entity.GetComponent<TransformComponent>();
-			auto& rigidbody = entity.GetComponent<Rigidbody2DComponent>();
-
-			b2BodyDef bodyDef;
-			bodyDef.type = CorbyRigidbody2DTypeToBox2DBodyType(rigidbody.Type);
-			bodyDef.position.Set(transform.Translation.x, transform.Translation.y);
-			bodyDef.angle = transform.Rotation.z;
-
-			b2Body* body = m_physicsWorld->CreateBody(&bodyDef);
-			body->SetFixedRotation(rigidbody.FixedRotation);
-			rigidbody.RuntimeBody = body;
-
-			if (entity.HasComponent<BoxCollider2DComponent>())
-			{
-				auto& boxCollider = entity.GetComponent<BoxCollider2DComponent>();
-				b2PolygonShape boxShape;
-				boxShape.SetAsBox(boxCollider.Size.x * transform.Scale.x, boxCollider.Size.y * transform.Scale.y);
-
-				b2FixtureDef fixtureDef;
-				fixtureDef.shape = &boxShape;
-				fixtureDef.density = boxCollider.Density;
-				fixtureDef.friction = boxCollider.Friction;
-				fixtureDef.restitution = boxCollider.Restitution;
-				fixtureDef.restitutionThreshold = boxCollider.RestitutionThreshold;
-				body->CreateFixture(&fixtureDef);
-			}
-
-			if (entity.HasComponent<CircleCollider2DComponent>())
-			{
-				auto& circleCollider = entity.GetComponent<CircleCollider2DComponent>();
-				b2CircleShape circleShape;
-				circleShape.m_p.Set(circleCollider.Offset.x, circleCollider.Offset.y);
-				circleShape.m_radius = transform.Scale.x * circleCollider.Radius;
-
-				b2FixtureDef fixtureDef;
-				fixtureDef.shape = &circleShape;
-				fixtureDef.density = circleCollider.Density;
-				fixtureDef.friction = circleCollider.Friction;
-				fixtureDef.restitution = circleCollider.Restitution;
-				fixtureDef.restitutionThreshold = circleCollider.RestitutionThreshold;
-				body->CreateFixture(&fixtureDef);
-			}
-		}
+			CreatePhysicsBody(e);
 	}
 
 	void Scene::OnRuntimeStop()
 	{
+		JobSystem::Wait(m_physicsJob);
+		m_physicsJobPending = false;
+
+		// Deleting the world frees all bodies at once, no need to go through them one by one
 		delete m_physicsWorld;
 		m_physicsWorld = nullptr;
+		m_physicsBodyData.clear();
+		m_freePhysicsBodyData.clear();
+		m_pendingPhysicsBodies.clear();
+		m_contactListener = nullptr;
+		m_contactEvents.clear();
 	}
 
 	void Scene::OnUpdateRuntime(Timestep ts)
 	{
+		// Finish the step that ran during the previous frame before scripts get to see any body state
+		SyncPhysics();
+		DispatchContactEvents();
+		PlaybackCommandBuffers();
+
 		// Update scripts
 		{
 			m_registry.view<NativeScriptComponent>().each([=] (auto entity, auto& nsc) {
@@ -200,27 +528,35 @@ namespace Engine
 				});
 		}
 
-		// Physics
-		const int32_t velocityIterations = 6;
-		const int32_t positionIterations = 2;
-		m_physicsWorld->Step(ts, velocityIterations, positionIterations);
+		PlaybackCommandBuffers();
 
+		// Update script systems
 		{
-			auto view = m_registry.view<Rigidbody2DComponent>();
-			for (auto e : view)
-			{
-				Entity entity = { e, this };
-				auto& transform = entity.GetComponent<TransformComponent>();
-				auto& rigidbody = entity.GetComponent<Rigidbody2DComponent>();
-
-				b2Body* body = (b2Body*) rigidbody.RuntimeBody;
-				const auto& position = body->GetPosition();
-				transform.Translation.x = position.x;
-				transform.Translation.y = position.y;
-				transform.Rotation.z = body->GetAngle();
-			}
+			ENG_PROFILE_SCOPE("Scene::OnUpdateRuntime - Script systems");
+
+			for (auto& system : m_scriptSystems)
+				system->Update(*this, ts);
+		}
+
+		PlaybackCommandBuffers();
+		CreatePendingPhysicsBodies();
+
+		// Physics
+		if (m_physicsSettings.RunOnWorkerThread)
+		{
+			// The world is only touched by the worker until the next sync, the registry only by this thread
+			JobSystem::Schedule([this, ts, settings = m_physicsSettings] () { StepPhysics(ts, settings); }, &m_physicsJob, nullptr, "Scene::StepPhysics");
+			m_physicsJobPending = true;
+		} else
+		{
+			StepPhysics(ts, m_physicsSettings);
+			ApplyPhysicsSnapshot();
+			DispatchContactEvents();
+			PlaybackCommandBuffers();
 		}
 
+		UpdateParticles(ts);
+
 		// Render 2D
 		Camera* mainCamera = nullptr;
 		glm::mat4 cameraTransform;
@@ -246,9 +582,22 @@ namespace Engine
 		{
 			Renderer2D::BeginScene(*mainCamera, cameraTransform);
 
+			// Draw tilemaps
+			{
+				auto view = m_registry.view<TransformComponent, TilemapComponent>();
+
+				for (auto entity : view)
+				{
+					auto [transform, tilemap] = view.get<TransformComponent, TilemapComponent>(entity);
+					Renderer2D::DrawTilemap(transform.GetTransform(), tilemap, (int) entity);
+				}
+			}
+
+			DrawStaticGeometry();
+
 			// Draw sprites
 			{
-				auto group = m_registry.group<TransformComponent>(entt::get<SpriteRendererComponent>);
+				auto group = m_registry.group<TransformComponent>(entt::get<SpriteRendererComponent>, entt::exclude<StaticComponent>);
 
 				for (auto entity : group)
 				{
@@ -259,7 +608,7 @@ namespace Engine
 
 			// Draw circles
 			{
-				auto view = m_registry.view<TransformComponent, CircleRendererComponent>();
+				auto view = m_registry.view<TransformComponent, CircleRendererComponent>(entt::exclude<StaticComponent>);
 
 				for (auto entity : view)
 				{
@@ -268,17 +617,55 @@ namespace Engine
 				}
 			}
 
+			// Draw particles
+			{
+				auto view = m_registry.view<ParticleEmitterComponent>();
+
+				for (auto entity : view)
+				{
+					auto& emitter = view.get<ParticleEmitterComponent>(entity);
+					if (emitter.RuntimeSystem)
+						emitter.RuntimeSystem->OnRender(emitter.Props, (int) entity);
+				}
+			}
+
+			// Draw text
+			{
+				auto view = m_registry.view<TransformComponent, TextComponent>();
+
+				for (auto entity : view)
+				{
+					auto [transform, text] = view.get<TransformComponent, TextComponent>(entity);
+					Renderer2D::DrawString(transform.GetTransform(), text, (int) entity);
+				}
+			}
+
 			Renderer2D::EndScene();
 		}
 	}
 
 	void Scene::OnUpdateEditor(Timestep ts, EditorCamera& camera)
 	{
+		UpdateParticles(ts);
+
 		Renderer2D::BeginScene(camera);
 
+		// Draw tilemaps
+		{
+			auto view = m_registry.view<TransformComponent, TilemapComponent>();
+
+			for (auto entity : view)
+			{
+				auto [transform, tilemap] = view.get<TransformComponent, TilemapComponent>(entity);
+				Renderer2D::DrawTilemap(transform.GetTransform(), tilemap, (int) entity);
+			}
+		}
+
+		DrawStaticGeometry();
+
 		// Draw sprites
 		{
-			auto group = m_registry.group<TransformComponent>(entt::get<SpriteRendererComponent>);
+			auto group = m_registry.group<TransformComponent>(entt::get<SpriteRendererComponent>, entt::exclude<StaticComponent>);
 			for (auto entity : group)
 			{
 				auto [transform, sprite] = group.get<TransformComponent, SpriteRendererComponent>(entity);
@@ -288,7 +675,7 @@ namespace Engine
 
 		// Draw circles
 		{
-			auto view = m_registry.view<TransformComponent, CircleRendererComponent>();
+			auto view = m_registry.view<TransformComponent, CircleRendererComponent>(entt::exclude<StaticComponent>);
 
 			for (auto entity : view)
 			{
@@ -297,101 +684,745 @@ namespace Engine
 			}
 		}
 
+		// Draw particles
+		{
+			auto view = m_registry.view<ParticleEmitterComponent>();
+
+			for (auto entity : view)
+			{
+				auto& emitter = view.get<ParticleEmitterComponent>(entity);
+				if (emitter.RuntimeSystem)
+					emitter.RuntimeSystem->OnRender(emitter.Props, (int) entity);
+			}
+		}
+
+		// Draw text
+		{
+			auto view = m_registry.view<TransformComponent, TextComponent>();
+
+			for (auto entity : view)
+			{
+				auto [transform, text] = view.get<TransformComponent, TextComponent>(entity);
+				Renderer2D::DrawString(transform.GetTransform(), text, (int) entity);
+			}
+		}
+
 		Renderer2D::EndScene();
 	}
 
-	void Scene::OnViewportResize(uint32_t width, uint32_t height)
+	void Scene::StepPhysics(Timestep ts, const PhysicsSettings& settings)
 	{
-		m_viewportWidth = width;
-		m_viewportHeight = height;
+		ENG_PROFILE_FUNCTION();
 
-		auto view = m_registry.view<CameraComponent>();
+		m_physicsAccumulator += ts;
 
-		for (auto entity : view)
+		uint32_t stepCount = (uint32_t) (m_physicsAccumulator / settings.FixedTimestep);
+		if (stepCount > settings.MaxSubsteps)
 		{
-			auto& cameraComponent = view.get<CameraComponent>(entity);
+			// Drop the time we cannot catch up on, otherwise every slow frame makes the next one slower
+			stepCount = settings.MaxSubsteps;
+			m_physicsAccumulator = stepCount * settings.FixedTimestep;
+		}
 
-			if (!cameraComponent.FixedAspectRatio)
-				cameraComponent.Camera.SetViewportSize(width, height);
+		for (uint32_t i = 0; i < stepCount; i++)
+		{
+			// Interpolation only needs the state before the last step
+			if (i == stepCount - 1)
+			{
+				for (b2Body* body = m_physicsWorld->GetBodyList(); body; body = body->GetNext())
+				{
+					if (body->GetType() == b2_staticBody || !body->IsAwake())
+						continue;
+
+					PhysicsBodyData* bodyData = (PhysicsBodyData*) body->GetUserData().pointer;
+					bodyData->PreviousPosition = { body->GetPosition().x, body->GetPosition().y };
+					bodyData->PreviousAngle = body->GetAngle();
+				}
+			}
+
+			m_physicsWorld->Step(settings.FixedTimestep, settings.VelocityIterations, settings.PositionIterations);
+			m_physicsAccumulator -= settings.FixedTimestep;
+		}
+
+		// Static and sleeping bodies do not move, so only awake bodies end up in the snapshot
+		m_physicsSnapshot.clear();
+		float alpha = settings.Interpolate ? m_physicsAccumulator / settings.FixedTimestep : 1.0f;
+		for (b2Body* body = m_physicsWorld->GetBodyList(); body; body = body->GetNext())
+		{
+			if (body->GetType() == b2_staticBody)
+				continue;
+
+			// A body that fell asleep is written once more at the pose it came to rest at. The interpolated
+			// pose lags behind it and would otherwise stay until the body wakes up.
+			PhysicsBodyData* bodyData = (PhysicsBodyData*) body->GetUserData().pointer;
+			bool awake = body->IsAwake();
+			if (!awake && !bodyData->Awake)
+				continue;
+
+			bodyData->Awake = awake;
+			float bodyAlpha = awake ? alpha : 1.0f;
+			const b2Vec2& position = body->GetPosition();
+
+			PhysicsTransform& state = m_physicsSnapshot.emplace_back();
+			state.Entity = bodyData->Entity;
+			state.Body = body;
+			state.Position = glm::mix(bodyData->PreviousPosition, glm::vec2(position.x, position.y), bodyAlpha);
+			state.Angle = glm::mix(bodyData->PreviousAngle, body->GetAngle(), bodyAlpha);
 		}
 	}
 
-	Entity Scene::GetPrimaryCameraEntity()
+	void Scene::SyncPhysics()
 	{
-		auto view = m_registry.view<CameraComponent>();
-		for (auto entity : view)
+		if (m_physicsJobPending)
 		{
-			const auto& camera = view.get<CameraComponent>(entity);
-			if (camera.Primary)
-				return Entity{ entity, this };
+			ENG_PROFILE_FUNCTION();
+
+			JobSystem::Wait(m_physicsJob);
+			m_physicsJobPending = false;
+			ApplyPhysicsSnapshot();
 		}
-		return {};
+
+		CreatePendingPhysicsBodies();
 	}
 
-	template<typename T>
-	void Scene::OnComponentAdded(Entity entity, T& component)
+	void Scene::WaitForPhysicsStep()
 	{
-		static_assert(false);
+		// The job stays pending, its snapshot is applied by the next sync. Called from registry signals, other jobs
+		// must not run in the middle of the change.
+		if (m_physicsJobPending)
+			JobSystem::WaitWithoutRunning(m_physicsJob);
 	}
 
-	template<>
-	void Scene::OnComponentAdded<IDComponent>(Entity entity, IDComponent& component)
+	void Scene::ApplyPhysicsSnapshot()
 	{
+		ENG_PROFILE_FUNCTION();
 
+		for (const auto& state : m_physicsSnapshot)
+		{
+			// Destroyed or without its body since the step was scheduled. A rigidbody added again in the meantime
+			// does not have its new body yet, those are created after the snapshot is applied.
+			if (!m_registry.valid(state.Entity))
+				continue;
+
+			auto* rigidbody = m_registry.try_get<Rigidbody2DComponent>(state.Entity);
+			if (!rigidbody || rigidbody->RuntimeBody != state.Body)
+				continue;
+
+			auto& transform = m_registry.get<TransformComponent>(state.Entity);
+			transform.Translation.x = state.Position.x;
+			transform.Translation.y = state.Position.y;
+			transform.Rotation.z = state.Angle;
+
+			// Lets downstream caches such as the static batches know the transform moved
+			m_registry.patch<TransformComponent>(state.Entity);
+		}
 	}
 
-	template<>
-	void Scene::OnComponentAdded<TransformComponent>(Entity entity, TransformComponent& component)
+	bool Scene::Raycast(const glm::vec2& start, const glm::vec2& end, RaycastHit2D& hit, uint16_t mask)
 	{
+		if (!m_physicsWorld || start == end)
+			return false;
+
+		ENG_PROFILE_FUNCTION();
+
+		// The world belongs to the worker until its step is done
+		SyncPhysics();
+
+		struct ClosestHitCallback : b2RayCastCallback
+		{
+			uint16_t Mask;
+			b2Fixture* Fixture = nullptr;
+			b2Vec2 Point, Normal;
+			float Fraction = 1.0f;
+
+			float ReportFixture(b2Fixture* fixture, const b2Vec2& point, const b2Vec2& normal, float fraction) override
+			{
+				if (!(fixture->GetFilterData().categoryBits & Mask))
+					return -1.0f;
 
+				Fixture = fixture;
+				Point = point;
+				Normal = normal;
+				Fraction = fraction;
+
+				// Clip the ray, only closer fixtures are reported from here on
+				return fraction;
+			}
+		} callback;
+		callback.Mask = mask;
+
+		m_physicsWorld->RayCast(&callback, b2Vec2(start.x, start.y), b2Vec2(end.x, end.y));
+		if (!callback.Fixture)
+			return false;
+
+		hit.HitEntity = { ((PhysicsBodyData*) callback.Fixture->GetBody()->GetUserData().pointer)->Entity, this };
+		hit.Point = { callback.Point.x, callback.Point.y };
+		hit.Normal = { callback.Normal.x, callback.Normal.y };
+		hit.Fraction = callback.Fraction;
+		return true;
 	}
 
-	template<>
-	void Scene::OnComponentAdded<CameraComponent>(Entity entity, CameraComponent& component)
+	uint32_t Scene::RaycastAll(const glm::vec2& start, const glm::vec2& end, RaycastHit2D* hits, uint32_t maxHits, uint16_t mask)
 	{
-		if (m_viewportWidth > 0 && m_viewportHeight > 0)
-			component.Camera.SetViewportSize(m_viewportWidth, m_viewportHeight);
+		if (!m_physicsWorld || start == end || maxHits == 0)
+			return 0;
+
+		ENG_PROFILE_FUNCTION();
+
+		SyncPhysics();
+
+		struct AllHitsCallback : b2RayCastCallback
+		{
+			Scene* Context;
+			RaycastHit2D* Hits;
+			uint32_t MaxHits;
+			uint16_t Mask;
+			uint32_t HitCount = 0;
+
+			float ReportFixture(b2Fixture* fixture, const b2Vec2& point, const b2Vec2& normal, float fraction) override
+			{
+				if (!(fixture->GetFilterData().categoryBits & Mask))
+					return -1.0f;
+
+				// Once the buffer is full it is a max heap on the fraction, a nearer hit replaces the farthest one
+				bool full = HitCount == MaxHits;
+				if (full)
+				{
+					if (fraction >= Hits[0].Fraction)
+						return Hits[0].Fraction;
+
+					std::pop_heap(Hits, Hits + HitCount, CompareFraction);
+					HitCount--;
+				}
+
+				RaycastHit2D& hit = Hits[HitCount++];
+				hit.HitEntity = { ((PhysicsBodyData*) fixture->GetBody()->GetUserData().pointer)->Entity, Context };
+				hit.Point = { point.x, point.y };
+				hit.Normal = { normal.x, normal.y };
+				hit.Fraction = fraction;
+
+				if (HitCount < MaxHits)
+					return 1.0f;
+
+				// Clip the ray to the farthest kept hit, fixtures behind it can't make it into the buffer
+				if (full)
+					std::push_heap(Hits, Hits + HitCount, CompareFraction);
+				else
+					std::make_heap(Hits, Hits + HitCount, CompareFraction);
+
+				return Hits[0].Fraction;
+			}
+
+			static bool CompareFraction(const RaycastHit2D& a, const RaycastHit2D& b) { return a.Fraction < b.Fraction; }
+		} callback;
+		callback.Context = this;
+		callback.Hits = hits;
+		callback.MaxHits = maxHits;
+		callback.Mask = mask;
+
+		m_physicsWorld->RayCast(&callback, b2Vec2(start.x, start.y), b2Vec2(end.x, end.y));
+
+		// Box2D reports fixtures in tree order
+		std::sort(hits, hits + callback.HitCount, [] (const RaycastHit2D& a, const RaycastHit2D& b) { return a.Fraction < b.Fraction; });
+		return callback.HitCount;
+	}
+
+	uint32_t Scene::QueryAABB(const glm::vec2& min, const glm::vec2& max, Entity* entities, uint32_t maxEntities, uint16_t mask)
+	{
+		if (!m_physicsWorld || maxEntities == 0)
+			return 0;
+
+		ENG_PROFILE_FUNCTION();
+
+		SyncPhysics();
+
+		struct AABBCallback : b2QueryCallback
+		{
+			Scene* Context;
+			Entity* Entities;
+			uint32_t MaxEntities;
+			uint16_t Mask;
+			uint32_t EntityCount = 0;
+
+			bool ReportFixture(b2Fixture* fixture) override
+			{
+				if (!(fixture->GetFilterData().categoryBits & Mask))
+					return true;
+
+				// Bodies with several fixtures, and chains with a proxy per edge, are reported more than once
+				Entity entity = { ((PhysicsBodyData*) fixture->GetBody()->GetUserData().pointer)->Entity, Context };
+				if (std::find(Entities, Entities + EntityCount, entity) == Entities + EntityCount)
+					Entities[EntityCount++] = entity;
+
+				return EntityCount < MaxEntities;
+			}
+		} callback;
+		callback.Context = this;
+		callback.Entities = entities;
+		callback.MaxEntities = maxEntities;
+		callback.Mask = mask;
+
+		b2AABB aabb;
+		aabb.lowerBound.Set(min.x, min.y);
+		aabb.upperBound.Set(max.x, max.y);
+		m_physicsWorld->QueryAABB(&callback, aabb);
+
+		return callback.EntityCount;
+	}
+
+	uint32_t Scene::OverlapCircle(const glm::vec2& center, float radius, Entity* entities, uint32_t maxEntities, uint16_t mask)
+	{
+		b2CircleShape circleShape;
+		circleShape.m_radius = radius;
+
+		b2Transform transform;
+		transform.Set(b2Vec2(center.x, center.y), 0.0f);
+
+		return OverlapShape(circleShape, transform, entities, maxEntities, mask);
+	}
+
+	uint32_t Scene::OverlapBox(const glm::vec2& center, const glm::vec2& halfExtents, float angle, Entity* entities, uint32_t maxEntities, uint16_t mask)
+	{
+		b2PolygonShape boxShape;
+		boxShape.SetAsBox(halfExtents.x, halfExtents.y);
+
+		b2Transform transform;
+		transform.Set(b2Vec2(center.x, center.y), angle);
+
+		return OverlapShape(boxShape, transform, entities, maxEntities, mask);
+	}
+
+	uint32_t Scene::OverlapShape(const b2Shape& shape, const b2Transform& transform, Entity* entities, uint32_t maxEntities, uint16_t mask)
+	{
+		if (!m_physicsWorld || maxEntities == 0)
+			return 0;
+
+		ENG_PROFILE_FUNCTION();
+
+		SyncPhysics();
+
+		// The broadphase only knows bounding boxes, every candidate is tested against the exact shape
+		struct OverlapCallback : b2QueryCallback
+		{
+			Scene* Context;
+			const b2Shape* Shape;
+			const b2Transform* Transform;
+			Entity* Entities;
+			uint32_t MaxEntities;
+			uint16_t Mask;
+			uint32_t EntityCount = 0;
+
+			bool ReportFixture(b2Fixture* fixture) override
+			{
+				if (!(fixture->GetFilterData().categoryBits & Mask))
+					return true;
+
+				Entity entity = { ((PhysicsBodyData*) fixture->GetBody()->GetUserData().pointer)->Entity, Context };
+				if (std::find(Entities, Entities + EntityCount, entity) != Entities + EntityCount)
+					return true;
+
+				const b2Shape* fixtureShape = fixture->GetShape();
+				for (int32 child = 0; child < fixtureShape->GetChildCount(); child++)
+				{
+					if (b2TestOverlap(Shape, 0, fixtureShape, child, *Transform, fixture->GetBody()->GetTransform()))
+					{
+						Entities[EntityCount++] = entity;
+						break;
+					}
+				}
+
+				return EntityCount < MaxEntities;
+			}
+		} callback;
+		callback.Context = this;
+		callback.Shape = &shape;
+		callback.Transform = &transform;
+		callback.Entities = entities;
+		callback.MaxEntities = maxEntities;
+		callback.Mask = mask;
+
+		b2AABB aabb;
+		shape.ComputeAABB(&aabb, transform, 0);
+		m_physicsWorld->QueryAABB(&callback, aabb);
+
+		return callback.EntityCount;
+	}
+
+	void Scene::DispatchContactEvents()
+	{
+		if (m_contactEvents.empty())
+			return;
+
+		ENG_PROFILE_FUNCTION();
+
+		auto dispatch = [this] (entt::entity self, entt::entity other, bool begin) {
+			if (!m_registry.valid(self))
+				return;
+
+			auto* nsc = m_registry.try_get<NativeScriptComponent>(self);
+			if (nsc && nsc->Instance)
+			{
+				Entity otherEntity = m_registry.valid(other) ? Entity{ other, this } : Entity{};
+				if (begin)
+					nsc->Instance->OnCollisionBegin(otherEntity);
+				else
+					nsc->Instance->OnCollisionEnd(otherEntity);
+			}
+
+			// Script systems check for their state themselves
+			for (auto& system : m_scriptSystems)
+			{
+				if (m_registry.valid(self))
+					system->Contact(*this, self, other, begin);
+			}
+		};
+
+		// Scripts destroying entities add end events while we walk the buffer, those are sent in the same pass
+		for (size_t i = 0; i < m_contactEvents.size(); i++)
+		{
+			ContactEvent event = m_contactEvents[i];
+			dispatch(event.A, event.B, event.Begin);
+			dispatch(event.B, event.A, event.Begin);
+		}
+
+		m_contactEvents.clear();
+	}
+
+	void Scene::CreatePhysicsBody(entt::entity entity)
+	{
+		auto& transform = m_registry.get<TransformComponent>(entity);
+		auto& rigidbody = m_registry.get<Rigidbody2DComponent>(entity);
+
+		b2BodyDef bodyDef;
+		bodyDef.type = CorbyRigidbody2DTypeToBox2DBodyType(rigidbody.Type);
+		bodyDef.position.Set(transform.Translation.x, transform.Translation.y);
+		bodyDef.angle = transform.Rotation.z;
+
+		// Body data is recycled, entities that are spawned and destroyed all the time do not allocate
+		PhysicsBodyData* bodyData;
+		if (!m_freePhysicsBodyData.empty())
+		{
+			bodyData = m_freePhysicsBodyData.back();
+			m_freePhysicsBodyData.pop_back();
+		} else
+		{
+			bodyData = &m_physicsBodyData.emplace_back();
+		}
+
+		bodyData->Entity = entity;
+		bodyData->PreviousPosition = { bodyDef.position.x, bodyDef.position.y };
+		bodyData->PreviousAngle = bodyDef.angle;
+		bodyData->Awake = true;
+		bodyDef.userData.pointer = (uintptr_t) bodyData;
+
+		b2Body* body = m_physicsWorld->CreateBody(&bodyDef);
+		body->SetFixedRotation(rigidbody.FixedRotation);
+		rigidbody.RuntimeBody = body;
+
+		AllCollider2DComponents::Each(m_registry, entity, [&] (auto& collider) {
+			AttachCollider(body, transform, collider);
+			});
 	}
 
-	template<>
-	void Scene::OnComponentAdded<SpriteRendererComponent>(Entity entity, SpriteRendererComponent& component)
+	void Scene::DestroyPhysicsBody(entt::entity entity)
 	{
+		auto& rigidbody = m_registry.get<Rigidbody2DComponent>(entity);
+		b2Body* body = (b2Body*) rigidbody.RuntimeBody;
+		if (!body)
+			return;
+
+		m_freePhysicsBodyData.push_back((PhysicsBodyData*) body->GetUserData().pointer);
+		m_physicsWorld->DestroyBody(body);
+		rigidbody.RuntimeBody = nullptr;
+
+		// The fixtures went with the body
+		AllCollider2DComponents::Each(m_registry, entity, [] (auto& collider) {
+			DetachCollider(nullptr, collider);
+			});
+	}
+
+	void Scene::CreatePendingPhysicsBodies()
+	{
+		if (m_pendingPhysicsBodies.empty())
+			return;
+
+		ENG_PROFILE_FUNCTION();
+
+		for (auto entity : m_pendingPhysicsBodies)
+		{
+			if (!m_registry.valid(entity))
+				continue;
+
+			auto* rigidbody = m_registry.try_get<Rigidbody2DComponent>(entity);
+			if (!rigidbody)
+				continue;
+
+			if (!rigidbody->RuntimeBody)
+			{
+				CreatePhysicsBody(entity);
+				continue;
+			}
+
+			// Colliders added to a body that already exists
+			auto& transform = m_registry.get<TransformComponent>(entity);
+			AllCollider2DComponents::Each(m_registry, entity, [&] (auto& collider) {
+				if (!IsColliderAttached(collider))
+					AttachCollider((b2Body*) rigidbody->RuntimeBody, transform, collider);
+				});
+		}
+
+		m_pendingPhysicsBodies.clear();
+	}
+
+	void Scene::OnRigidbody2DConstruct(entt::registry& registry, entt::entity entity)
+	{
+		// Copies carry the body of their source
+		registry.get<Rigidbody2DComponent>(entity).RuntimeBody = nullptr;
+
+		// The caller sets up the component after the signal, the body is made from it at the next sync
+		if (m_physicsWorld)
+			m_pendingPhysicsBodies.push_back(entity);
+	}
+
+	void Scene::OnRigidbody2DDestroy(entt::registry& registry, entt::entity entity)
+	{
+		if (!m_physicsWorld)
+			return;
+
+		// The world belongs to the worker until its step is done
+		WaitForPhysicsStep();
+		DestroyPhysicsBody(entity);
+	}
+
+	template<typename Collider>
+	void Scene::OnCollider2DConstruct(entt::registry& registry, entt::entity entity)
+	{
+		// Copies carry the fixture handles of their source
+		auto& collider = registry.get<Collider>(entity);
+		DetachCollider(nullptr, collider);
+
+		// Without a body the collider is attached along with it
+		auto* rigidbody = registry.try_get<Rigidbody2DComponent>(entity);
+		if (m_physicsWorld && rigidbody && rigidbody->RuntimeBody)
+			m_pendingPhysicsBodies.push_back(entity);
+	}
+
+	template<typename Collider>
+	void Scene::OnCollider2DDestroy(entt::registry& registry, entt::entity entity)
+	{
+		auto& collider = registry.get<Collider>(entity);
+
+		auto* rigidbody = registry.try_get<Rigidbody2DComponent>(entity);
+		if (!m_physicsWorld || !rigidbody || !rigidbody->RuntimeBody)
+			return;
+
+		WaitForPhysicsStep();
+		DetachCollider((b2Body*) rigidbody->RuntimeBody, collider);
+	}
+
+	void Scene::UpdateParticles(Timestep ts)
+	{
+		ENG_PROFILE_FUNCTION();
+
+		auto view = m_registry.view<TransformComponent, ParticleEmitterComponent>();
+		for (auto entity : view)
+		{
+			auto [transform, emitter] = view.get<TransformComponent, ParticleEmitterComponent>(entity);
+
+			if (!emitter.RuntimeSystem || emitter.RuntimeSystem->GetMaxParticles() != emitter.Props.MaxParticles)
+				emitter.RuntimeSystem = ParticleSystem::Create(emitter.Props.MaxParticles);
+
+			emitter.RuntimeSystem->OnUpdate(ts, transform.GetTransform(), emitter.Props);
+		}
+	}
+
+	void Scene::OnIDComponentConstruct(entt::registry& registry, entt::entity entity)
+	{
+		UUID uuid = registry.get<IDComponent>(entity).ID;
+		m_entitiesByUUID[uuid] = entity;
+		m_indexedUUIDs[entity] = uuid;
+	}
+
+	// The component already holds the new UUID, the old one is taken from the reverse map
+	void Scene::OnIDComponentUpdate(entt::registry& registry, entt::entity entity)
+	{
+		OnIDComponentDestroy(registry, entity);
+		OnIDComponentConstruct(registry, entity);
+	}
+
+	void Scene::OnIDComponentDestroy(entt::registry& registry, entt::entity entity)
+	{
+		auto indexed = m_indexedUUIDs.find(entity);
+		if (indexed == m_indexedUUIDs.end())
+			return;
+
+		auto it = m_entitiesByUUID.find(indexed->second);
+		if (it != m_entitiesByUUID.end() && it->second == entity)
+			m_entitiesByUUID.erase(it);
+
+		m_indexedUUIDs.erase(indexed);
+	}
+
+	// Also called on updates, the entity is moved from the bucket of its old name to the new one
+	void Scene::OnTagComponentConstruct(entt::registry& registry, entt::entity entity)
+	{
+		OnTagComponentDestroy(registry, entity);
 
+		InternedString name = registry.get<TagComponent>(entity).Tag;
+		m_entitiesByName.emplace(name, entity);
+		m_indexedNames[entity] = name;
 	}
 
-	template<>
-	void Scene::OnComponentAdded<CircleRendererComponent>(Entity entity, CircleRendererComponent& component)
+	void Scene::OnTagComponentDestroy(entt::registry& registry, entt::entity entity)
 	{
+		auto indexed = m_indexedNames.find(entity);
+		if (indexed == m_indexedNames.end())
+			return;
 
+		auto [begin, end] = m_entitiesByName.equal_range(indexed->second);
+		for (auto it = begin; it != end; it++)
+		{
+			if (it->second == entity)
+			{
+				m_entitiesByName.erase(it);
+				break;
+			}
+		}
+
+		m_indexedNames.erase(indexed);
 	}
 
-	template<>
-	void Scene::OnComponentAdded<TagComponent>(Entity entity, TagComponent& component)
+	// Entities and components removed by command buffers or the editor take their script instance with them. Scripts
+	// see the entity one last time in OnDestroy, changes they make to the scene have to go through a command buffer.
+	void Scene::OnNativeScriptComponentDestroy(entt::registry& registry, entt::entity entity)
 	{
+		NativeScriptComponent& nsc = registry.get<NativeScriptComponent>(entity);
+		if (!nsc.Instance)
+			return;
 
+		nsc.Instance->OnDestroy();
+		nsc.DestroyScript(&nsc);
 	}
 
-	template<>
-	void Scene::OnComponentAdded<NativeScriptComponent>(Entity entity, NativeScriptComponent& component)
+	void Scene::OnStaticComponentConstruct(entt::registry& registry, entt::entity entity)
 	{
+		uint32_t groupIndex = 0;
+		while (groupIndex < m_staticGroups.size() && m_staticGroups[groupIndex].Entities.size() >= StaticGroupSize)
+			groupIndex++;
+
+		if (groupIndex == m_staticGroups.size())
+			m_staticGroups.emplace_back();
+
+		StaticGroup& group = m_staticGroups[groupIndex];
+		group.Entities.push_back(entity);
+		group.Dirty = true;
+
+		registry.get<StaticComponent>(entity).RuntimeGroup = groupIndex;
+	}
+
+	void Scene::OnStaticComponentDestroy(entt::registry& registry, entt::entity entity)
+	{
+		uint32_t groupIndex = registry.get<StaticComponent>(entity).RuntimeGroup;
+		if (groupIndex >= m_staticGroups.size())
+			return;
+
+		StaticGroup& group = m_staticGroups[groupIndex];
+		auto it = std::find(group.Entities.begin(), group.Entities.end(), entity);
+		if (it != group.Entities.end())
+		{
+			*it = group.Entities.back();
+			group.Entities.pop_back();
+			group.Dirty = true;
+		}
+	}
 
+	void Scene::OnStaticGeometryChanged(entt::registry& registry, entt::entity entity)
+	{
+		if (auto* staticComponent = registry.try_get<StaticComponent>(entity))
+		{
+			if (staticComponent->RuntimeGroup < m_staticGroups.size())
+				m_staticGroups[staticComponent->RuntimeGroup].Dirty = true;
+		}
 	}
 
-	template<>
-	void Scene::OnComponentAdded<Rigidbody2DComponent>(Entity entity, Rigidbody2DComponent& component)
+	void Scene::DrawStaticGeometry()
 	{
+		ENG_PROFILE_FUNCTION();
+
+		for (auto& group : m_staticGroups)
+		{
+			if (group.Dirty)
+			{
+				ENG_PROFILE_SCOPE("Scene::DrawStaticGeometry - Rebuild group");
+
+				if (!group.Batch)
+					group.Batch = CreateRef<StaticBatch2D>();
+				group.Batch->Clear();
+
+				// Entities that share a texture end up next to each other, which keeps the number of texture sets down
+				std::sort(group.Entities.begin(), group.Entities.end(), [&] (entt::entity a, entt::entity b) {
+					auto* spriteA = m_registry.try_get<SpriteRendererComponent>(a);
+					auto* spriteB = m_registry.try_get<SpriteRendererComponent>(b);
+					Texture2D* textureA = spriteA ? spriteA->Texture.get() : nullptr;
+					Texture2D* textureB = spriteB ? spriteB->Texture.get() : nullptr;
+					return textureA < textureB;
+					});
+
+				for (auto entity : group.Entities)
+				{
+					glm::mat4 transform = m_registry.get<TransformComponent>(entity).GetTransform();
+
+					if (auto* sprite = m_registry.try_get<SpriteRendererComponent>(entity))
+					{
+						if (sprite->Texture)
+							group.Batch->AddQuad(transform, sprite->Texture, sprite->TilingFactor, sprite->Color, (int) entity);
+						else
+							group.Batch->AddQuad(transform, sprite->Color, (int) entity);
+					}
+
+					if (auto* circle = m_registry.try_get<CircleRendererComponent>(entity))
+						group.Batch->AddCircle(transform, circle->Color, circle->Thickness, circle->Fade, (int) entity);
+				}
+
+				group.Batch->Upload();
+				group.Dirty = false;
+			}
 
+			Renderer2D::DrawStaticBatch(*group.Batch);
+		}
 	}
 
-	template<>
-	void Scene::OnComponentAdded<BoxCollider2DComponent>(Entity entity, BoxCollider2DComponent& component)
+	void Scene::OnViewportResize(uint32_t width, uint32_t height)
 	{
+		m_viewportWidth = width;
+		m_viewportHeight = height;
 
+		auto view = m_registry.view<CameraComponent>();
+
+		for (auto entity : view)
+		{
+			auto& cameraComponent = view.get<CameraComponent>(entity);
+
+			if (!cameraComponent.FixedAspectRatio)
+				cameraComponent.Camera.SetViewportSize(width, height);
+		}
 	}
 
-	template<>
-	void Scene::OnComponentAdded<CircleCollider2DComponent>(Entity entity, CircleCollider2DComponent& component)
+	Entity Scene::GetPrimaryCameraEntity()
 	{
+		auto view = m_registry.view<CameraComponent>();
+		for (auto entity : view)
+		{
+			const auto& camera = view.get<CameraComponent>(entity);
+			if (camera.Primary)
+				return Entity{ entity, this };
+		}
+		return {};
+	}
 
+	void Scene::OnCameraComponentAdded(CameraComponent& component)
+	{
+		if (m_viewportWidth > 0 && m_viewportHeight > 0)
+			component.Camera.SetViewportSize(m_viewportWidth, m_viewportHeight);
 	}
 }
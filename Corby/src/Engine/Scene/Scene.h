@@ -1,16 +1,40 @@
 #pragma once
 
+#include "Engine/Core/InternedString.h"
+#include "Engine/Core/JobSystem.h"
 #include "Engine/Core/Timestep.h"
 #include "Engine/Core/UUID.h"
 #include "Engine/Renderer/EditorCamera.h"
 
+#include <deque>
 #include <entt.hpp>
+#include <glm/glm.hpp>
 
+class b2Body;
+class b2Shape;
 class b2World;
+struct b2Transform;
 
 namespace Engine
 {
 	class Entity;
+	class EntityCommandBuffer;
+	class Prefab;
+	class ScriptSystemBase;
+	struct CameraComponent;
+	struct IDComponent;
+	class StaticBatch2D;
+	struct RaycastHit2D;
+
+	struct PhysicsSettings
+	{
+		float FixedTimestep = 1.0f / 60.0f;
+		uint32_t MaxSubsteps = 8; // Steps allowed per frame before the remaining time is dropped
+		int32_t VelocityIterations = 6;
+		int32_t PositionIterations = 2;
+		bool Interpolate = true; // Blend rendered transforms between the last two physics states
+		bool RunOnWorkerThread = false; // Step while the frame renders, results show up one frame later
+	};
 
 	class Scene
 	{
@@ -21,10 +45,43 @@ namespace Engine
 		Entity CreateEntity(const std::string& name = std::string());
 		Entity CreateEntityWithUUID(UUID uuid, const std::string& name = std::string());
 		void DestroyEntity(Entity entity);
-		void DuplicateEntity(Entity entity);
+		Entity DuplicateEntity(Entity entity);
+
+		// Batched versions of the above, every component pool is filled or emptied with one call instead of once
+		// per entity. The entities share the tag.
+		std::vector<Entity> CreateEntities(size_t count, const std::string& name = std::string());
+		std::vector<Entity> CreateEntitiesWithUUIDs(const std::vector<UUID>& uuids, const std::string& name = std::string());
+		void DestroyEntities(const std::vector<Entity>& entities);
+
+		// Lookups through an index the scene keeps up to date, an empty entity when nothing matches
+		Entity FindEntityByUUID(UUID uuid);
+		// Names don't have to be unique, any of the entities with the name may be returned
+		Entity FindEntityByName(const std::string& name);
+		std::vector<Entity> FindEntitiesByName(const std::string& name);
 
+		// Every instance gets its own identifier, the components are copied with one insert per pool
+		std::vector<Entity> InstantiatePrefab(const Ref<Prefab>& prefab, size_t count);
+		Entity InstantiatePrefab(const Ref<Prefab>& prefab);
+
+		// Copies the whole pool of a component into a registry that has the same entities, see Copy
 		template<typename Component>
-		static void CopyComponent(entt::registry& dst, entt::registry& src, const std::unordered_map<UUID, entt::entity>& enttMap);
+		static void CopyComponent(entt::registry& dst, const entt::registry& src)
+		{
+			// Entity identifiers match, so the packed arrays are inserted as they are. Components are stored in pages.
+			auto view = src.view<const Component>();
+			if constexpr (std::is_empty_v<Component>)
+			{
+				dst.insert<Component>(view.data(), view.data() + view.size());
+			} else
+			{
+				auto pages = view.raw();
+				for (size_t offset = 0; offset < view.size(); offset += ENTT_PACKED_PAGE)
+				{
+					size_t count = std::min<size_t>(ENTT_PACKED_PAGE, view.size() - offset);
+					dst.insert<Component>(view.data() + offset, view.data() + offset + count, pages[offset / ENTT_PACKED_PAGE]);
+				}
+			}
+		}
 		template<typename Component>
 		static void CopyComponentIfExists(Entity dst, Entity src);
 		static Ref<Scene> Copy(Ref<Scene> scene);
@@ -38,23 +95,165 @@ namespace Engine
 
 		Entity GetPrimaryCameraEntity();
 
+		PhysicsSettings& GetPhysicsSettings() { return m_physicsSettings; }
+		const PhysicsSettings& GetPhysicsSettings() const { return m_physicsSettings; }
+
+		// Physics queries, these only find something while the runtime is running. The mask selects the collision
+		// layers to look at, results go into buffers owned by the caller and the number of results is returned.
+		// Include "Engine/Physics/Physics2D.h" for the result types.
+		bool Raycast(const glm::vec2& start, const glm::vec2& end, RaycastHit2D& hit, uint16_t mask = 0xFFFF);
+		uint32_t RaycastAll(const glm::vec2& start, const glm::vec2& end, RaycastHit2D* hits, uint32_t maxHits, uint16_t mask = 0xFFFF);
+		uint32_t QueryAABB(const glm::vec2& min, const glm::vec2& max, Entity* entities, uint32_t maxEntities, uint16_t mask = 0xFFFF);
+		uint32_t OverlapCircle(const glm::vec2& center, float radius, Entity* entities, uint32_t maxEntities, uint16_t mask = 0xFFFF);
+		uint32_t OverlapBox(const glm::vec2& center, const glm::vec2& halfExtents, float angle, Entity* entities, uint32_t maxEntities, uint16_t mask = 0xFFFF);
+
+		// Buffer of the calling thread for structural changes during the update, such as scripts spawning or
+		// destroying entities. The buffers are played back after the contact callbacks, the native scripts and
+		// the script systems.
+		EntityCommandBuffer& GetCommandBuffer();
+
+		// Per-entity state of a script system, see ScriptSystem. The systems themselves are registered with
+		// ScriptSystemRegistry and run after the native scripts, in the order they were registered.
+		template<typename State, typename... Args>
+		State& AddScriptState(entt::entity entity, Args&&... args)
+		{
+			return m_registry.emplace<State>(entity, std::forward<Args>(args)...);
+		}
+
+		template<typename State>
+		void RemoveScriptState(entt::entity entity)
+		{
+			m_registry.remove<State>(entity);
+		}
+
 		template<typename... Components>
 		auto GetAllEntitiesWith()
 		{
 			return m_registry.view<Components...>();
 		}
 	private:
+		// Creates an entity for each identifier, without any other component
+		std::vector<entt::entity> CreateEntityHandles(const std::vector<IDComponent>& ids);
+		std::vector<Entity> CreateEntities(const std::vector<IDComponent>& ids, const std::string& name);
+
+		// Only components that depend on the scene need to react to being added
 		template<typename T>
-		void OnComponentAdded(Entity entity, T& component);
+		void OnComponentAdded(Entity entity, T& component)
+		{
+			if constexpr (std::is_same_v<T, CameraComponent>)
+				OnCameraComponentAdded(component);
+		}
+
+		void OnCameraComponentAdded(CameraComponent& component);
+
+		void UpdateParticles(Timestep ts);
+		void StepPhysics(Timestep ts, const PhysicsSettings& settings);
+		void SyncPhysics();
+		void WaitForPhysicsStep(); // Waits without touching the registry, for the registry signals
+		void ApplyPhysicsSnapshot();
+		uint32_t OverlapShape(const b2Shape& shape, const b2Transform& transform, Entity* entities, uint32_t maxEntities, uint16_t mask);
+		void DispatchContactEvents();
+
+		void CreatePhysicsBody(entt::entity entity);
+		void DestroyPhysicsBody(entt::entity entity);
+		void CreatePendingPhysicsBodies();
+		void OnRigidbody2DConstruct(entt::registry& registry, entt::entity entity);
+		void OnRigidbody2DDestroy(entt::registry& registry, entt::entity entity);
+		template<typename Collider>
+		void OnCollider2DConstruct(entt::registry& registry, entt::entity entity);
+		template<typename Collider>
+		void OnCollider2DDestroy(entt::registry& registry, entt::entity entity);
+
+		void PlaybackCommandBuffers();
+
+		void OnIDComponentConstruct(entt::registry& registry, entt::entity entity);
+		void OnIDComponentUpdate(entt::registry& registry, entt::entity entity);
+		void OnIDComponentDestroy(entt::registry& registry, entt::entity entity);
+		void OnTagComponentConstruct(entt::registry& registry, entt::entity entity);
+		void OnTagComponentDestroy(entt::registry& registry, entt::entity entity);
+		void OnNativeScriptComponentDestroy(entt::registry& registry, entt::entity entity);
+
+		void OnStaticComponentConstruct(entt::registry& registry, entt::entity entity);
+		void OnStaticComponentDestroy(entt::registry& registry, entt::entity entity);
+		void OnStaticGeometryChanged(entt::registry& registry, entt::entity entity);
+		void DrawStaticGeometry();
+
+	private:
+		// Static entities are baked in fixed size groups, so a change only rebuilds the group it is in
+		struct StaticGroup
+		{
+			std::vector<entt::entity> Entities;
+			Ref<StaticBatch2D> Batch;
+			bool Dirty = true;
+		};
+
+		// Attached to every body through its user data, so walking the body list only needs
+		// the registry for the transform it writes to
+		struct PhysicsBodyData
+		{
+			entt::entity Entity;
+			glm::vec2 PreviousPosition;
+			float PreviousAngle;
+			bool Awake; // As of the last snapshot
+		};
+
+		// Begin and end of a contact between two fixtures, recorded during the step
+		struct ContactEvent
+		{
+			entt::entity A;
+			entt::entity B;
+			bool Begin;
+		};
+		class ContactListener;
+
+		struct PhysicsTransform
+		{
+			entt::entity Entity;
+			b2Body* Body; // Only compared, the body may be gone by the time the snapshot is applied
+			glm::vec2 Position;
+			float Angle;
+		};
 
 	private:
 		entt::registry m_registry;
 		uint32_t m_viewportWidth = 0, m_viewportHeight = 0;
 
 		b2World* m_physicsWorld = nullptr;
+		PhysicsSettings m_physicsSettings;
+		float m_physicsAccumulator = 0.0f;
+		std::deque<PhysicsBodyData> m_physicsBodyData; // Stable addresses, bodies point into it
+		std::vector<PhysicsBodyData*> m_freePhysicsBodyData;
+		std::vector<entt::entity> m_pendingPhysicsBodies; // Rigidbodies and colliders added since the last sync
+
+		// Scripts only hear about contacts once the step is done, the world is locked while it runs
+		Scope<ContactListener> m_contactListener;
+		std::vector<ContactEvent> m_contactEvents;
+
+		// Body states of the last step. Together with the transforms in the registry this forms a double
+		// buffer, the worker fills the snapshot while the frame renders from the transforms.
+		std::vector<PhysicsTransform> m_physicsSnapshot;
+		JobCounter m_physicsJob;
+		bool m_physicsJobPending = false;
+
+		// Filled through registry signals. The indexed maps keep the UUID and name each entity is indexed under,
+		// so an entity whose identifier or name changed can be found under the old one
+		std::unordered_map<UUID, entt::entity> m_entitiesByUUID;
+		std::unordered_map<entt::entity, UUID> m_indexedUUIDs;
+		std::unordered_multimap<InternedString, entt::entity> m_entitiesByName;
+		std::unordered_map<entt::entity, InternedString> m_indexedNames;
+
+		std::vector<StaticGroup> m_staticGroups;
+		std::vector<Scope<ScriptSystemBase>> m_scriptSystems; // Instances of this scene, made by ScriptSystemRegistry
+		std::vector<Scope<EntityCommandBuffer>> m_commandBuffers; // One per thread of the job system
 
 		friend class Entity;
+		friend class EntityCommandBuffer;
+		friend class Prefab;
+		template<typename State, typename... Components>
+		friend class ScriptSystem;
 		friend class SceneSerializer;
 		friend class SceneHierarchyPanel;
+		friend class UndoCommand;
+		friend class UndoHistory;
 	};
 }
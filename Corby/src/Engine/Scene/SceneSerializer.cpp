@@ -1,276 +1,68 @@
 #include "engpch.h"
 #include "SceneSerializer.h"
 
+#include "Engine/Scene/ComponentReflection.h"
 #include "Engine/Scene/Components.h"
 #include "Engine/Scene/Entity.h"
+#include "Engine/Scene/FieldSerializer.h"
+#include "Engine/Scene/Prefab.h"
+#include "Engine/Scene/ScriptSystem.h"
 
 #include <fstream>
-#include <yaml-cpp/yaml.h>
-
-namespace YAML
-{
-	template<>
-	struct convert<glm::vec2>
-	{
-		static Node encode(const glm::vec2& rhs)
-		{
-			Node node;
-			node.push_back(rhs.x);
-			node.push_back(rhs.y);
-			node.SetStyle(EmitterStyle::Flow);
-
-			return node;
-		}
-
-		static bool decode(const Node& node, glm::vec2& rhs)
-		{
-			if (!node.IsSequence() || node.size() != 2)
-				return false;
-
-			rhs.x = node[0].as<float>();
-			rhs.y = node[1].as<float>();
-
-			return true;
-		}
-	};
-
-	template<>
-	struct convert<glm::vec3>
-	{
-		static Node encode(const glm::vec3& rhs)
-		{
-			Node node;
-			node.push_back(rhs.x);
-			node.push_back(rhs.y);
-			node.push_back(rhs.z);
-			node.SetStyle(EmitterStyle::Flow);
-
-			return node;
-		}
-
-		static bool decode(const Node& node, glm::vec3& rhs)
-		{
-			if (!node.IsSequence() || node.size() != 3)
-				return false;
-
-			rhs.x = node[0].as<float>();
-			rhs.y = node[1].as<float>();
-			rhs.z = node[2].as<float>();
-
-			return true;
-		}
-	};
-
-	template<>
-	struct convert<glm::vec4>
-	{
-		static Node encode(const glm::vec4& rhs)
-		{
-			Node node;
-			node.push_back(rhs.x);
-			node.push_back(rhs.y);
-			node.push_back(rhs.z);
-			node.push_back(rhs.w);
-			node.SetStyle(EmitterStyle::Flow);
-
-			return node;
-		}
-
-		static bool decode(const Node& node, glm::vec4& rhs)
-		{
-			if (!node.IsSequence() || node.size() != 4)
-				return false;
-
-			rhs.x = node[0].as<float>();
-			rhs.y = node[1].as<float>();
-			rhs.z = node[2].as<float>();
-			rhs.w = node[3].as<float>();
-
-			return true;
-		}
-	};
-}
 
 namespace Engine
 {
-	YAML::Emitter& operator<<(YAML::Emitter& out, const glm::vec2& v)
-	{
-		out << YAML::Flow;
-		out << YAML::BeginSeq << v.x << v.y << YAML::EndSeq;
-
-		return out;
-	}
-
-	YAML::Emitter& operator<<(YAML::Emitter& out, const glm::vec3& v)
-	{
-		out << YAML::Flow;
-		out << YAML::BeginSeq << v.x << v.y << v.z << YAML::EndSeq;
-
-		return out;
-	}
-
-	YAML::Emitter& operator<<(YAML::Emitter& out, const glm::vec4& v)
-	{
-		out << YAML::Flow;
-		out << YAML::BeginSeq << v.x << v.y << v.z << v.w << YAML::EndSeq;
-
-		return out;
-	}
-
-	static std::string Rigidbody2DBodyTypeToString(Rigidbody2DComponent::BodyType bodyType)
-	{
-		switch (bodyType)
-		{
-			case Rigidbody2DComponent::BodyType::Static:	return "Static";
-			case Rigidbody2DComponent::BodyType::Dynamic:	return "Dynamic";
-			case Rigidbody2DComponent::BodyType::Kinematic: return "Kinematic";
-		}
-
-		ENG_CORE_ASSERT(false, "Unknown body type!");
-		return {};
-	}
-
-	static Rigidbody2DComponent::BodyType Rigidbody2DBodyTypeFromString(const std::string& bodyTypeString)
-	{
-		if (bodyTypeString == "Static") return Rigidbody2DComponent::BodyType::Static;
-		if (bodyTypeString == "Dynamic") return Rigidbody2DComponent::BodyType::Dynamic;
-		if (bodyTypeString == "Kinematic") return Rigidbody2DComponent::BodyType::Kinematic;
-
-		ENG_CORE_ASSERT(false, "Unkown body type!");
-		return Rigidbody2DComponent::BodyType::Static;
-	}
-
 	SceneSerializer::SceneSerializer(const Ref<Scene>& scene)
 		: m_scene(scene)
 	{}
 
-	static void SerializeEntity(YAML::Emitter& out, Entity entity)
+	// Instances of a prefab only write the components and fields they changed, components of the prefab the
+	// instance removed are written as null
+	static void SerializeComponents(YAML::Emitter& out, const entt::registry& registry, entt::entity entity, const Prefab* prefab = nullptr)
 	{
-		ENG_CORE_ASSERT(entity.HasComponent<IDComponent>());
-
-		out << YAML::BeginMap;
-		out << YAML::Key << "Entity" << YAML::Value << entity.GetUUID();
-
-		if (entity.HasComponent<TagComponent>())
-		{
-			out << YAML::Key << "TagComponent";
-			out << YAML::BeginMap;
-
-			std::string& tag = entity.GetComponent<TagComponent>();
-			out << YAML::Key << "Tag" << YAML::Value << tag;
-
-			out << YAML::EndMap;
-		}
-
-		if (entity.HasComponent<TransformComponent>())
-		{
-			out << YAML::Key << "TransformComponent";
-			out << YAML::BeginMap;
-
-			auto& tc = entity.GetComponent<TransformComponent>();
-			out << YAML::Key << "Translation" << YAML::Value << tc.Translation;
-			out << YAML::Key << "Rotation" << YAML::Value << tc.Rotation;
-			out << YAML::Key << "Scale" << YAML::Value << tc.Scale;
-
-			out << YAML::EndMap;
-		}
-
-		if (entity.HasComponent<CameraComponent>())
-		{
-			out << YAML::Key << "CameraComponent";
-			out << YAML::BeginMap;
-
-			auto& cameraComponent = entity.GetComponent<CameraComponent>();
-			auto& camera = cameraComponent.Camera;
-
-			out << YAML::Key << "Camera" << YAML::Value;
-			out << YAML::BeginMap;
-
-			out << YAML::Key << "ProjectionType" << YAML::Value << (int) camera.GetProjectionType();
-			out << YAML::Key << "PerspectiveFOV" << YAML::Value << camera.GetPerspectiveVerticalFOV();
-			out << YAML::Key << "PerspectiveNear" << YAML::Value << camera.GetPerspectiveNearClip();
-			out << YAML::Key << "PerspectiveFar" << YAML::Value << camera.GetPerspectiveFarClip();
-			out << YAML::Key << "OrthographicSize" << YAML::Value << camera.GetOrthographicSize();
-			out << YAML::Key << "OrthographicNear" << YAML::Value << camera.GetOrthographicNearClip();
-			out << YAML::Key << "OrthographicFar" << YAML::Value << camera.GetOrthographicFarClip();
-
-			out << YAML::EndMap;
-
-			out << YAML::Key << "Primary" << YAML::Value << cameraComponent.Primary;
-			out << YAML::Key << "FixedAspectRatio" << YAML::Value << cameraComponent.FixedAspectRatio;
-
-			out << YAML::EndMap;
-		}
-
-		if (entity.HasComponent<SpriteRendererComponent>())
-		{
-			out << YAML::Key << "SpriteRendererComponent";
-			out << YAML::BeginMap;
-
-			auto& spriteRendererComponent = entity.GetComponent<SpriteRendererComponent>();
-			out << YAML::Key << "Color" << YAML::Value << spriteRendererComponent.Color;
-
-			out << YAML::EndMap;
-		}
-
-		if (entity.HasComponent<CircleRendererComponent>())
-		{
-			out << YAML::Key << "CircleRendererComponent";
-			out << YAML::BeginMap;
+		AllComponents::Each([&] (auto type) {
+			using Component = typename decltype(type)::Type;
+			if constexpr (!(Reflection<Component>::Flags & ComponentNotSerialized))
+			{
+				const Component* component = registry.try_get<Component>(entity);
+				const Component* base = prefab ? prefab->TryGetComponent<Component>() : nullptr;
+				if (!component)
+				{
+					if (base)
+						out << YAML::Key << Reflection<Component>::Name << YAML::Value << YAML::Null;
+					return;
+				}
 
-			auto& circleRendererComponent = entity.GetComponent<CircleRendererComponent>();
-			out << YAML::Key << "Color" << YAML::Value << circleRendererComponent.Color;
-			out << YAML::Key << "Thickness" << YAML::Value << circleRendererComponent.Thickness;
-			out << YAML::Key << "Fade" << YAML::Value << circleRendererComponent.Fade;
+				if (base && ReflectedEqual(*component, *base))
+					return;
 
-			out << YAML::EndMap;
-		}
+				out << YAML::Key << Reflection<Component>::Name << YAML::Value;
+				SerializeFields(out, *component, base);
+			}
+			});
 
-		if (entity.HasComponent<Rigidbody2DComponent>())
-		{
-			out << YAML::Key << "Rigidbody2DComponent";
-			out << YAML::BeginMap;
+		// States of script systems are written whole, also for prefab instances
+		for (const auto& stateType : ScriptSystemRegistry::GetStateTypes())
+			stateType->Serialize(out, registry, entity);
+	}
 
-			auto& rigidBody = entity.GetComponent<Rigidbody2DComponent>();
-			out << YAML::Key << "BodyType" << YAML::Value << Rigidbody2DBodyTypeToString(rigidBody.Type);
-			out << YAML::Key << "FixedRotation" << YAML::Value << rigidBody.FixedRotation;
+	static void SerializeEntity(YAML::Emitter& out, const entt::registry& registry, entt::entity entity)
+	{
+		ENG_CORE_ASSERT(registry.all_of<IDComponent>(entity));
 
-			out << YAML::EndMap;
-		}
+		out << YAML::BeginMap;
+		out << YAML::Key << "Entity" << YAML::Value << (uint64_t) registry.get<IDComponent>(entity).ID;
 
-		if (entity.HasComponent<BoxCollider2DComponent>())
+		const Prefab* prefab = nullptr;
+		if (const auto* instance = registry.try_get<PrefabInstanceComponent>(entity); instance && instance->Source)
 		{
-			out << YAML::Key << "BoxCollider2DComponent";
-			out << YAML::BeginMap;
-
-			auto& boxCollider = entity.GetComponent<BoxCollider2DComponent>();
-			out << YAML::Key << "Offset" << YAML::Value << boxCollider.Offset;
-			out << YAML::Key << "Size" << YAML::Value << boxCollider.Size;
-			out << YAML::Key << "Density" << YAML::Value << boxCollider.Density;
-			out << YAML::Key << "Friction" << YAML::Value << boxCollider.Friction;
-			out << YAML::Key << "Restitution" << YAML::Value << boxCollider.Restitution;
-			out << YAML::Key << "RestitutionThreshold" << YAML::Value << boxCollider.RestitutionThreshold;
-
-			out << YAML::EndMap;
+			prefab = instance->Source.get();
+			out << YAML::Key << "Prefab" << YAML::Value << prefab->GetPath().string();
 		}
 
-		if (entity.HasComponent<CircleCollider2DComponent>())
-		{
-			out << YAML::Key << "CircleCollider2DComponent";
-			out << YAML::BeginMap;
-
-			auto& circleCollider = entity.GetComponent<CircleCollider2DComponent>();
-			out << YAML::Key << "Offset" << YAML::Value << circleCollider.Offset;
-			out << YAML::Key << "Radius" << YAML::Value << circleCollider.Radius;
-			out << YAML::Key << "Density" << YAML::Value << circleCollider.Density;
-			out << YAML::Key << "Friction" << YAML::Value << circleCollider.Friction;
-			out << YAML::Key << "Restitution" << YAML::Value << circleCollider.Restitution;
-			out << YAML::Key << "RestitutionThreshold" << YAML::Value << circleCollider.RestitutionThreshold;
-
-			out << YAML::EndMap;
-		}
+		SerializeComponents(out, registry, entity, prefab);
 
-		ENG_CORE_TRACE("Serialized entity with name = {0}", entity.GetComponent<TagComponent>().Tag);
+		ENG_CORE_TRACE("Serialized entity with name = {0}", registry.get<TagComponent>(entity).Tag.Get());
 
 		out << YAML::EndMap;
 	}
@@ -280,6 +72,17 @@ namespace Engine
 		YAML::Emitter out;
 		out << YAML::BeginMap;
 		out << YAML::Key << "Scene" << YAML::Value << "Untitled"; // TODO: Add scene name
+
+		const auto& physicsSettings = m_scene->GetPhysicsSettings();
+		out << YAML::Key << "Physics" << YAML::Value << YAML::BeginMap;
+		out << YAML::Key << "FixedTimestep" << YAML::Value << physicsSettings.FixedTimestep;
+		out << YAML::Key << "MaxSubsteps" << YAML::Value << physicsSettings.MaxSubsteps;
+		out << YAML::Key << "VelocityIterations" << YAML::Value << physicsSettings.VelocityIterations;
+		out << YAML::Key << "PositionIterations" << YAML::Value << physicsSettings.PositionIterations;
+		out << YAML::Key << "Interpolate" << YAML::Value << physicsSettings.Interpolate;
+		out << YAML::Key << "RunOnWorkerThread" << YAML::Value << physicsSettings.RunOnWorkerThread;
+		out << YAML::EndMap;
+
 		out << YAML::Key << "Entities" << YAML::Value << YAML::BeginSeq;
 
 		m_scene->m_registry.each([&] (auto entityID) {
@@ -287,7 +90,7 @@ namespace Engine
 			if (!entity)
 				return;
 
-			SerializeEntity(out, entity);
+			SerializeEntity(out, m_scene->m_registry, entityID);
 			});
 
 		out << YAML::EndSeq;
@@ -320,12 +123,34 @@ namespace Engine
 		std::string sceneName = data["Scene"].as<std::string>();
 		ENG_CORE_TRACE("Deserializing scene '{0}'", sceneName);
 
+		auto physics = data["Physics"];
+		if (physics)
+		{
+			auto& physicsSettings = m_scene->GetPhysicsSettings();
+			physicsSettings.FixedTimestep = physics["FixedTimestep"].as<float>();
+			physicsSettings.MaxSubsteps = physics["MaxSubsteps"].as<uint32_t>();
+			physicsSettings.VelocityIterations = physics["VelocityIterations"].as<int32_t>();
+			physicsSettings.PositionIterations = physics["PositionIterations"].as<int32_t>();
+			physicsSettings.Interpolate = physics["Interpolate"].as<bool>();
+			if (physics["RunOnWorkerThread"])
+				physicsSettings.RunOnWorkerThread = physics["RunOnWorkerThread"].as<bool>();
+		}
+
 		auto entities = data["Entities"];
 		if (entities)
 		{
+			// The entities are created in one batch, their tags are set with the rest of the components
+			std::vector<UUID> uuids;
+			uuids.reserve(entities.size());
+			for (auto entity : entities)
+				uuids.emplace_back(entity["Entity"].as<uint64_t>());
+
+			std::vector<Entity> deserializedEntities = m_scene->CreateEntitiesWithUUIDs(uuids);
+
+			size_t entityIndex = 0;
 			for (auto entity : entities)
 			{
-				uint64_t uuid = entity["Entity"].as<uint64_t>();
+				uint64_t uuid = uuids[entityIndex];
 
 				std::string name;
 				auto tagComponent = entity["TagComponent"];
@@ -334,82 +159,44 @@ namespace Engine
 
 				ENG_CORE_TRACE("Deserialized entity with ID = {0}, name = {1}", uuid, name);
 
-				Entity deserializedEntity = m_scene->CreateEntity(name);
+				Entity deserializedEntity = deserializedEntities[entityIndex++];
 
-				auto transformComponent = entity["TransformComponent"];
-				if (transformComponent)
+				// Instances start out as a copy of their prefab, the components below are what they changed
+				auto prefabNode = entity["Prefab"];
+				if (prefabNode)
 				{
-					auto& tc = deserializedEntity.GetComponent<TransformComponent>();
-					tc.Translation = transformComponent["Translation"].as<glm::vec3>();
-					tc.Rotation = transformComponent["Rotation"].as<glm::vec3>();
-					tc.Scale = transformComponent["Scale"].as<glm::vec3>();
+					if (Ref<Prefab> prefab = Prefab::Load(prefabNode.as<std::string>()))
+					{
+						prefab->CopyTo(deserializedEntity);
+						deserializedEntity.AddComponent<PrefabInstanceComponent>(prefab);
+					}
 				}
 
-				auto cameraComponent = entity["CameraComponent"];
-				if (cameraComponent)
-				{
-					auto& cc = deserializedEntity.AddComponent<CameraComponent>();
-					auto& cameraProperties = cameraComponent["Camera"];
-
-					cc.Camera.SetProjectionType((SceneCamera::ProjectionType) cameraProperties["ProjectionType"].as<int>());
-					cc.Camera.SetPerspectiveVerticalFOV(cameraProperties["PerspectiveFOV"].as<float>());
-					cc.Camera.SetPerspectiveNearClip(cameraProperties["PerspectiveNear"].as<float>());
-					cc.Camera.SetPerspectiveFarClip(cameraProperties["PerspectiveFar"].as<float>());
-					cc.Camera.SetOrthographicSize(cameraProperties["OrthographicSize"].as<float>());
-					cc.Camera.SetOrthographicNearClip(cameraProperties["OrthographicNear"].as<float>());
-					cc.Camera.SetOrthographicFarClip(cameraProperties["OrthographicFar"].as<float>());
-
-					cc.Primary = cameraComponent["Primary"].as<bool>();
-					cc.FixedAspectRatio = cameraComponent["FixedAspectRatio"].as<bool>();
-				}
-
-				auto spriteRendererComponent = entity["SpriteRendererComponent"];
-				if (spriteRendererComponent)
-				{
-					auto& src = deserializedEntity.AddComponent<SpriteRendererComponent>();
-					src.Color = spriteRendererComponent["Color"].as<glm::vec4>();
-				}
-
-				auto circleRendererComponent = entity["CircleRendererComponent"];
-				if (circleRendererComponent)
-				{
-					auto& crc = deserializedEntity.AddComponent<CircleRendererComponent>();
-					crc.Color = circleRendererComponent["Color"].as<glm::vec4>();
-					crc.Thickness = circleRendererComponent["Thickness"].as<float>();
-					crc.Fade = circleRendererComponent["Fade"].as<float>();
-				}
-
-				auto rigidbody2DComponent = entity["Rigidbody2DComponent"];
-				if (rigidbody2DComponent)
-				{
-					auto& rigidbody = deserializedEntity.AddComponent<Rigidbody2DComponent>();
-					rigidbody.Type = Rigidbody2DBodyTypeFromString(rigidbody2DComponent["BodyType"].as<std::string>());
-					rigidbody.FixedRotation = rigidbody2DComponent["FixedRotation"].as<bool>();
-				}
-
-				auto boxCollider2DComponent = entity["BoxCollider2DComponent"];
-				if (boxCollider2DComponent)
-				{
-					auto& boxCollider = deserializedEntity.AddComponent<BoxCollider2DComponent>();
-					boxCollider.Offset = boxCollider2DComponent["Offset"].as<glm::vec2>();
-					boxCollider.Size = boxCollider2DComponent["Size"].as<glm::vec2>();
-					boxCollider.Density = boxCollider2DComponent["Density"].as<float>();
-					boxCollider.Friction = boxCollider2DComponent["Friction"].as<float>();
-					boxCollider.Restitution = boxCollider2DComponent["Restitution"].as<float>();
-					boxCollider.RestitutionThreshold = boxCollider2DComponent["RestitutionThreshold"].as<float>();
-				}
-
-				auto circleCollider2DComponent = entity["CircleCollider2DComponent"];
-				if (circleCollider2DComponent)
-				{
-					auto& circleCollider = deserializedEntity.AddComponent<CircleCollider2DComponent>();
-					circleCollider.Offset = circleCollider2DComponent["Offset"].as<glm::vec2>();
-					circleCollider.Radius = circleCollider2DComponent["Radius"].as<float>();
-					circleCollider.Density = circleCollider2DComponent["Density"].as<float>();
-					circleCollider.Friction = circleCollider2DComponent["Friction"].as<float>();
-					circleCollider.Restitution = circleCollider2DComponent["Restitution"].as<float>();
-					circleCollider.RestitutionThreshold = circleCollider2DComponent["RestitutionThreshold"].as<float>();
-				}
+				AllComponents::Each([&] (auto type) {
+					using Component = typename decltype(type)::Type;
+					if constexpr (!(Reflection<Component>::Flags & ComponentNotSerialized))
+					{
+						auto componentNode = entity[Reflection<Component>::Name];
+						if (!componentNode)
+							return;
+
+						if (componentNode.IsNull())
+						{
+							if (deserializedEntity.HasComponent<Component>())
+								deserializedEntity.RemoveComponent<Component>();
+							return;
+						}
+
+						// Entities are created with some of the components already. The fields are read in place, the
+						// patch lets the scene index the loaded values, the tag and the UUID among them.
+						auto& component = deserializedEntity.HasComponent<Component>() ? deserializedEntity.GetComponent<Component>() : deserializedEntity.AddComponent<Component>();
+						DeserializeValue(componentNode, component);
+						deserializedEntity.PatchComponent<Component>();
+					}
+					});
+
+				for (const auto& stateType : ScriptSystemRegistry::GetStateTypes())
+					stateType->Deserialize(entity, m_scene->m_registry, deserializedEntity);
 			}
 		}
 
@@ -423,4 +210,53 @@ namespace Engine
 
 		return false;
 	}
+
+	void SceneSerializer::SerializePrefab(const Prefab& prefab, const std::string& filepath)
+	{
+		YAML::Emitter out;
+		out << YAML::BeginMap;
+		out << YAML::Key << "Prefab" << YAML::Value << prefab.GetPath().stem().string();
+		out << YAML::Key << "Components" << YAML::Value << YAML::BeginMap;
+		SerializeComponents(out, prefab.GetRegistry(), prefab.GetEntity());
+		out << YAML::EndMap;
+		out << YAML::EndMap;
+
+		std::ofstream fout(filepath);
+		fout << out.c_str();
+	}
+
+	bool SceneSerializer::DeserializePrefab(Prefab& prefab, const std::string& filepath)
+	{
+		YAML::Node data;
+		try
+		{
+			data = YAML::LoadFile(filepath);
+		} catch (const YAML::Exception& e)
+		{
+			return false;
+		}
+
+		auto components = data["Components"];
+		if (!data["Prefab"] || !components)
+			return false;
+
+		entt::registry& registry = prefab.GetRegistry();
+		AllComponents::Each([&] (auto type) {
+			using Component = typename decltype(type)::Type;
+			if constexpr (!(Reflection<Component>::Flags & ComponentNotSerialized))
+			{
+				auto componentNode = components[Reflection<Component>::Name];
+				if (!componentNode)
+					return;
+
+				DeserializeValue(componentNode, registry.get_or_emplace<Component>(prefab.GetEntity()));
+				registry.patch<Component>(prefab.GetEntity());
+			}
+			});
+
+		for (const auto& stateType : ScriptSystemRegistry::GetStateTypes())
+			stateType->Deserialize(components, registry, prefab.GetEntity());
+
+		return true;
+	}
 }
@@ -4,6 +4,8 @@
 
 namespace Engine
 {
+	class Prefab;
+
 	class SceneSerializer
 	{
 	public:
@@ -15,6 +17,9 @@ namespace Engine
 		bool Deserialize(const std::string& filepath);
 		bool DeserializeRuntime(const std::string& filepath);
 
+		static void SerializePrefab(const Prefab& prefab, const std::string& filepath);
+		static bool DeserializePrefab(Prefab& prefab, const std::string& filepath);
+
 	private:
 		Ref<Scene> m_scene;
 	};
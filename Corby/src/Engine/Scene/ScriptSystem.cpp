@@ -0,0 +1,30 @@
+#include "engpch.h"
+#include "ScriptSystem.h"
+
+namespace Engine
+{
+	static std::vector<Scope<ScriptSystemBase> (*)()> s_systemFactories;
+	static std::vector<Scope<ScriptStateType>> s_stateTypes;
+
+	std::vector<Scope<ScriptSystemBase>> ScriptSystemRegistry::CreateSystems()
+	{
+		std::vector<Scope<ScriptSystemBase>> systems;
+		systems.reserve(s_systemFactories.size());
+		for (auto create : s_systemFactories)
+			systems.push_back(create());
+
+		return systems;
+	}
+
+	const std::vector<Scope<ScriptStateType>>& ScriptSystemRegistry::GetStateTypes()
+	{
+		return s_stateTypes;
+	}
+
+	void ScriptSystemRegistry::AddSystem(Scope<ScriptSystemBase> (*create)(), Scope<ScriptStateType> stateType)
+	{
+		s_systemFactories.push_back(create);
+		if (stateType)
+			s_stateTypes.push_back(std::move(stateType));
+	}
+}
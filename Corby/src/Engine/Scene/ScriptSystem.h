@@ -0,0 +1,191 @@
+#pragma once
+
+#include "Engine/Core/Timestep.h"
+#include "Engine/Scene/ComponentReflection.h"
+#include "Engine/Scene/Entity.h"
+#include "Engine/Scene/FieldSerializer.h"
+#include "Engine/Scene/Scene.h"
+#include "Engine/Scene/UndoHistory.h"
+
+#include <entt.hpp>
+
+namespace Engine
+{
+	class ScriptSystemBase
+	{
+	public:
+		virtual ~ScriptSystemBase() = default;
+
+	private:
+		virtual void Update(Scene& scene, Timestep ts) = 0;
+		virtual void Contact(Scene& scene, entt::entity self, entt::entity other, bool begin) = 0;
+
+		friend class Scene;
+	};
+
+	// A script that updates all of its entities in one call, instead of an instance and a virtual OnUpdate per entity.
+	// The per-entity data of the script is a plain State struct stored as a component (Scene::AddScriptState), so
+	// all instances of one script live packed in the registry. The system walks a non-owning group, which keeps the
+	// matching entities packed as well. It owns no storage, so systems that share a State but need other components
+	// don't conflict.
+	//
+	// The State needs a Reflection specialization like the components of the engine, that is how it is saved with
+	// the scene, copied and undone. Systems are registered once, every scene then runs an instance of its own.
+	//
+	//     struct Patrol { float Speed = 1.0f; float Time = 0.0f; };
+	//
+	//     template<>
+	//     struct Reflection<Patrol>
+	//     {
+	//         static constexpr bool Reflected = true;
+	//         static constexpr const char* Name = "Patrol";
+	//
+	//         static auto Fields() { return std::make_tuple(MakeField("Speed", &Patrol::Speed), MakeField("Time", &Patrol::Time)); }
+	//     };
+	//
+	//     class PatrolSystem : public ScriptSystem<Patrol, TransformComponent>
+	//     {
+	//         void OnUpdate(Scene& scene, Group& group, Timestep ts) override
+	//         {
+	//             group.each([ts] (auto entity, Patrol& patrol, TransformComponent& transform) { ... });
+	//         }
+	//
+	//         void OnCollisionBegin(Scene& scene, Entity entity, Patrol& patrol, Entity other) override { ... }
+	//     };
+	//
+	//     ScriptSystemRegistry::Register<PatrolSystem>(); // In the constructor of the application
+	template<typename State, typename... Components>
+	class ScriptSystem : public ScriptSystemBase
+	{
+	public:
+		using StateType = State;
+		using Group = decltype(std::declval<entt::registry&>().group<>(entt::get<State, Components...>));
+
+		static_assert(Reflection<State>::Reflected, "The state of a script system needs a Reflection specialization!");
+
+	protected:
+		virtual void OnUpdate(Scene& scene, Group& group, Timestep ts) = 0;
+
+		// Called like ScriptableEntity::OnCollisionBegin and OnCollisionEnd, for entities with the state. The other
+		// entity is invalid when it has been destroyed. Structural changes go through the command buffer.
+		virtual void OnCollisionBegin(Scene& scene, Entity entity, State& state, Entity other) {}
+		virtual void OnCollisionEnd(Scene& scene, Entity entity, State& state, Entity other) {}
+
+	private:
+		void Update(Scene& scene, Timestep ts) override
+		{
+			auto group = scene.m_registry.group<>(entt::get<State, Components...>);
+			if (!group.empty())
+				OnUpdate(scene, group, ts);
+		}
+
+		void Contact(Scene& scene, entt::entity self, entt::entity other, bool begin) override
+		{
+			State* state = scene.m_registry.try_get<State>(self);
+			if (!state)
+				return;
+
+			Entity otherEntity = scene.m_registry.valid(other) ? Entity{ other, &scene } : Entity{};
+			if (begin)
+				OnCollisionBegin(scene, Entity{ self, &scene }, *state, otherEntity);
+			else
+				OnCollisionEnd(scene, Entity{ self, &scene }, *state, otherEntity);
+		}
+	};
+
+	// What the engine does with the states of script systems where it handles every component: scene files,
+	// prefabs, copies of scenes and entities and undo. AllComponents only knows the components of the engine,
+	// the states are reached through the registered systems.
+	class ScriptStateType
+	{
+	public:
+		virtual ~ScriptStateType() = default;
+
+		virtual void CopyAll(entt::registry& dst, const entt::registry& src) const = 0;
+		virtual void Copy(entt::registry& dstRegistry, entt::entity dst, const entt::registry& srcRegistry, entt::entity src) const = 0;
+
+		// Writes the state as a key of the entity map, if the entity has one
+		virtual void Serialize(YAML::Emitter& out, const entt::registry& registry, entt::entity entity) const = 0;
+		virtual void Deserialize(const YAML::Node& node, entt::registry& registry, entt::entity entity) const = 0;
+
+		virtual Scope<ComponentSnapshot> Snapshot(const entt::registry& registry, entt::entity entity) const = 0;
+	};
+
+	template<typename State>
+	class TypedScriptStateType : public ScriptStateType
+	{
+	public:
+		virtual void CopyAll(entt::registry& dst, const entt::registry& src) const override
+		{
+			Scene::CopyComponent<State>(dst, src);
+		}
+
+		virtual void Copy(entt::registry& dstRegistry, entt::entity dst, const entt::registry& srcRegistry, entt::entity src) const override
+		{
+			if (const State* state = srcRegistry.try_get<State>(src))
+				dstRegistry.emplace_or_replace<State>(dst, *state);
+		}
+
+		virtual void Serialize(YAML::Emitter& out, const entt::registry& registry, entt::entity entity) const override
+		{
+			if (const State* state = registry.try_get<State>(entity))
+			{
+				out << YAML::Key << Reflection<State>::Name << YAML::Value;
+				SerializeFields(out, *state);
+			}
+		}
+
+		virtual void Deserialize(const YAML::Node& node, entt::registry& registry, entt::entity entity) const override
+		{
+			auto stateNode = node[Reflection<State>::Name];
+			if (!stateNode)
+				return;
+
+			DeserializeValue(stateNode, registry.get_or_emplace<State>(entity));
+			registry.patch<State>(entity);
+		}
+
+		virtual Scope<ComponentSnapshot> Snapshot(const entt::registry& registry, entt::entity entity) const override
+		{
+			if (const State* state = registry.try_get<State>(entity))
+				return CreateScope<TypedComponentSnapshot<State>>(*state);
+
+			return nullptr;
+		}
+	};
+
+	// The script systems of the application. Register them before the first scene is created, every scene creates
+	// its own instances of the systems registered by then.
+	class ScriptSystemRegistry
+	{
+	public:
+		template<typename System>
+		static void Register()
+		{
+			using State = typename System::StateType;
+
+			// Systems can share a state, it is still only saved once
+			Scope<ScriptStateType> stateType;
+			if (!IsStateRegistered<State>())
+			{
+				stateType = CreateScope<TypedScriptStateType<State>>();
+				IsStateRegistered<State>() = true;
+			}
+
+			AddSystem([] () -> Scope<ScriptSystemBase> { return CreateScope<System>(); }, std::move(stateType));
+		}
+
+		static std::vector<Scope<ScriptSystemBase>> CreateSystems();
+		static const std::vector<Scope<ScriptStateType>>& GetStateTypes();
+
+	private:
+		template<typename State>
+		static bool& IsStateRegistered()
+		{
+			static bool registered = false;
+			return registered;
+		}
+
+		static void AddSystem(Scope<ScriptSystemBase> (*create)(), Scope<ScriptStateType> stateType);
+	};
+}
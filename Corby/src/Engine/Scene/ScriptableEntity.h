@@ -1,6 +1,8 @@
 #pragma once
 
+#include "Engine/Physics/Physics2D.h"
 #include "Engine/Scene/Entity.h"
+#include "Engine/Scene/EntityCommandBuffer.h"
 
 namespace Engine
 {
@@ -16,10 +18,21 @@ namespace Engine
 		}
 
 	protected:
+		// The scene the entity lives in, for physics queries and the like
+		Scene& GetScene() { return *m_entity.m_scene; }
+
+		// Entities can't be created or destroyed while the scripts are being updated, record it here instead
+		EntityCommandBuffer& GetCommandBuffer() { return m_entity.m_scene->GetCommandBuffer(); }
+
 		virtual void OnCreate() {}
 		virtual void OnDestroy() {}
 		virtual void OnUpdate(Timestep ts) {}
 
+		// Called after the physics step in which a collider of this entity started or stopped touching one of
+		// the other entity, once per pair of colliders. The other entity is invalid when it has been destroyed.
+		virtual void OnCollisionBegin(Entity other) {}
+		virtual void OnCollisionEnd(Entity other) {}
+
 	private:
 		Entity m_entity;
 		friend class Scene;
@@ -0,0 +1,256 @@
+#include "engpch.h"
+#include "UndoHistory.h"
+
+#include "Engine/Scene/ScriptSystem.h"
+
+namespace Engine
+{
+	static constexpr size_t DeltaRunHeaderSize = 2 * sizeof(uint16_t);
+
+	std::vector<uint8_t> UndoCommand::CreateDelta(const void* before, const void* after, size_t size)
+	{
+		ENG_CORE_ASSERT(size <= std::numeric_limits<uint16_t>::max(), "Component is too big for a delta!");
+
+		const uint8_t* a = (const uint8_t*) before;
+		const uint8_t* b = (const uint8_t*) after;
+
+		// [offset, length, old bytes, new bytes] for every run of changed bytes
+		std::vector<uint8_t> delta;
+		size_t i = 0;
+		while (i < size)
+		{
+			if (a[i] == b[i])
+			{
+				i++;
+				continue;
+			}
+
+			// The run goes on while the next changed byte is closer than the header of a new run
+			size_t begin = i;
+			size_t end = i + 1;
+			for (size_t j = end; j < size && j < end + DeltaRunHeaderSize; j++)
+			{
+				if (a[j] != b[j])
+					end = j + 1;
+			}
+
+			uint16_t header[2] = { (uint16_t) begin, (uint16_t) (end - begin) };
+			size_t offset = delta.size();
+			delta.resize(offset + DeltaRunHeaderSize + (end - begin) * 2);
+			memcpy(delta.data() + offset, header, DeltaRunHeaderSize);
+			memcpy(delta.data() + offset + DeltaRunHeaderSize, a + begin, end - begin);
+			memcpy(delta.data() + offset + DeltaRunHeaderSize + (end - begin), b + begin, end - begin);
+
+			i = end;
+		}
+
+		delta.shrink_to_fit();
+		return delta;
+	}
+
+	void UndoCommand::ApplyDelta(void* data, const std::vector<uint8_t>& delta, bool forward)
+	{
+		uint8_t* bytes = (uint8_t*) data;
+
+		size_t offset = 0;
+		while (offset < delta.size())
+		{
+			uint16_t header[2];
+			memcpy(header, delta.data() + offset, DeltaRunHeaderSize);
+
+			const uint8_t* source = delta.data() + offset + DeltaRunHeaderSize + (forward ? header[1] : 0);
+			memcpy(bytes + header[0], source, header[1]);
+
+			offset += DeltaRunHeaderSize + header[1] * 2;
+		}
+	}
+
+	entt::registry& UndoCommand::GetRegistry(Scene& scene)
+	{
+		return scene.m_registry;
+	}
+
+	// An entity that was created or destroyed. It is brought back through the scene with its components and the same
+	// UUID, so the commands before and after it still find it even though its handle changed.
+	class EntityUndoCommand : public UndoCommand
+	{
+	public:
+		EntityUndoCommand(const entt::registry& registry, entt::entity entity, bool created)
+			: m_uuid(registry.get<IDComponent>(entity).ID), m_name(registry.get<TagComponent>(entity).Tag), m_created(created)
+		{
+			// The scene gives the entity its identifier again
+			AllComponents::Each([&] (auto type) {
+				using Component = typename decltype(type)::Type;
+				if constexpr (!std::is_same_v<Component, IDComponent>)
+				{
+					if (const auto* component = registry.try_get<Component>(entity))
+						m_components.push_back(CreateScope<TypedComponentSnapshot<Component>>(*component));
+				}
+				});
+
+			for (const auto& stateType : ScriptSystemRegistry::GetStateTypes())
+			{
+				if (Scope<ComponentSnapshot> state = stateType->Snapshot(registry, entity))
+					m_components.push_back(std::move(state));
+			}
+		}
+
+		virtual void Undo(Scene& scene) override
+		{
+			if (m_created)
+				Destroy(scene);
+			else
+				Restore(scene);
+		}
+
+		virtual void Redo(Scene& scene) override
+		{
+			if (m_created)
+				Restore(scene);
+			else
+				Destroy(scene);
+		}
+
+		virtual size_t GetMemoryUsage() const override
+		{
+			size_t size = sizeof(*this) + m_components.capacity() * sizeof(Scope<ComponentSnapshot>);
+			for (const auto& component : m_components)
+				size += component->GetMemoryUsage();
+
+			return size;
+		}
+
+	private:
+		void Restore(Scene& scene)
+		{
+			Entity entity = scene.CreateEntityWithUUID(m_uuid, m_name);
+			for (const auto& component : m_components)
+				component->Restore(GetRegistry(scene), entity);
+		}
+
+		void Destroy(Scene& scene)
+		{
+			if (Entity entity = scene.FindEntityByUUID(m_uuid))
+				scene.DestroyEntity(entity);
+		}
+
+	private:
+		UUID m_uuid;
+		InternedString m_name;
+		bool m_created;
+		std::vector<Scope<ComponentSnapshot>> m_components;
+	};
+
+	UndoHistory::UndoHistory(size_t memoryLimit)
+		: m_memoryLimit(memoryLimit)
+	{}
+
+	void UndoHistory::SetContext(const Ref<Scene>& context)
+	{
+		m_context = context;
+		Clear();
+	}
+
+	void UndoHistory::Clear()
+	{
+		m_commands.clear();
+		m_position = 0;
+		m_memoryUsage = 0;
+		m_openCommand = nullptr;
+	}
+
+	void UndoHistory::RecordCreate(Entity entity)
+	{
+		Push(CreateScope<EntityUndoCommand>(m_context->m_registry, entity, true), false);
+	}
+
+	void UndoHistory::RecordDestroy(Entity entity)
+	{
+		Push(CreateScope<EntityUndoCommand>(m_context->m_registry, entity, false), false);
+	}
+
+	void UndoHistory::EndMerge()
+	{
+		if (!m_openCommand)
+			return;
+
+		m_openCommand = nullptr;
+
+		// The open command is always the last one
+		if (!m_commands.back()->Close())
+		{
+			m_commands.pop_back();
+			m_position--;
+			return;
+		}
+
+		m_memoryUsage += m_commands.back()->GetMemoryUsage();
+		Trim();
+	}
+
+	void UndoHistory::Undo()
+	{
+		ENG_PROFILE_FUNCTION();
+
+		EndMerge();
+		if (!CanUndo())
+			return;
+
+		m_position--;
+		m_commands[m_position]->Undo(*m_context);
+	}
+
+	void UndoHistory::Redo()
+	{
+		ENG_PROFILE_FUNCTION();
+
+		EndMerge();
+		if (!CanRedo())
+			return;
+
+		m_commands[m_position]->Redo(*m_context);
+		m_position++;
+	}
+
+	void UndoHistory::SetMemoryLimit(size_t memoryLimit)
+	{
+		m_memoryLimit = memoryLimit;
+		Trim();
+	}
+
+	void UndoHistory::Push(Scope<UndoCommand> command, bool mergeable)
+	{
+		EndMerge();
+
+		// A new step replaces everything that was undone
+		while (m_commands.size() > m_position)
+		{
+			m_memoryUsage -= m_commands.back()->GetMemoryUsage();
+			m_commands.pop_back();
+		}
+
+		m_commands.push_back(std::move(command));
+		m_position++;
+
+		if (mergeable)
+		{
+			m_openCommand = m_commands.back().get();
+			return;
+		}
+
+		m_commands.back()->Close();
+		m_memoryUsage += m_commands.back()->GetMemoryUsage();
+		Trim();
+	}
+
+	void UndoHistory::Trim()
+	{
+		// The newest step stays, even when it is bigger than the limit on its own
+		while (m_memoryUsage > m_memoryLimit && m_position > 0 && m_commands.size() > 1 && m_commands.front().get() != m_openCommand)
+		{
+			m_memoryUsage -= m_commands.front()->GetMemoryUsage();
+			m_commands.pop_front();
+			m_position--;
+		}
+	}
+}
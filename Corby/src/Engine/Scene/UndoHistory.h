@@ -0,0 +1,264 @@
+#pragma once
+
+#include "Engine/Scene/ComponentReflection.h"
+#include "Engine/Scene/Components.h"
+#include "Engine/Scene/Entity.h"
+#include "Engine/Scene/Scene.h"
+
+#include <deque>
+#include <optional>
+
+namespace Engine
+{
+	class UndoCommand
+	{
+	public:
+		virtual ~UndoCommand() = default;
+
+		virtual void Undo(Scene& scene) = 0;
+		virtual void Redo(Scene& scene) = 0;
+
+		// Bytes the command keeps alive, used to bound the history
+		virtual size_t GetMemoryUsage() const = 0;
+
+		// Called once nothing is merged into the command anymore. Returns false when it turned out to change nothing.
+		virtual bool Close() { return true; }
+
+	protected:
+		static entt::registry& GetRegistry(Scene& scene);
+
+		// Byte runs that differ between two versions of a component, each run stores the old and the new bytes
+		static std::vector<uint8_t> CreateDelta(const void* before, const void* after, size_t size);
+		static void ApplyDelta(void* data, const std::vector<uint8_t>& delta, bool forward);
+	};
+
+	// Bytes a copy of the component keeps alive, including what it owns on the heap
+	template<typename T>
+	size_t GetComponentMemoryUsage(const T& component)
+	{
+		size_t size = sizeof(T);
+		if constexpr (std::is_same_v<T, TextComponent>)
+		{
+			size += component.TextString.capacity();
+		} else if constexpr (std::is_same_v<T, PolygonCollider2DComponent>)
+		{
+			size += component.Vertices.capacity() * sizeof(glm::vec2);
+		} else if constexpr (std::is_same_v<T, ChainCollider2DComponent>)
+		{
+			for (const auto& chain : component.Chains)
+				size += sizeof(chain) + chain.Vertices.capacity() * sizeof(glm::vec2);
+		} else if constexpr (std::is_same_v<T, TilemapComponent>)
+		{
+			size += component.GetTiles().capacity() * sizeof(int32_t) + component.GetChunks().capacity() * sizeof(TilemapComponent::Chunk);
+		}
+
+		return size;
+	}
+
+	// A copy of a component, for entities that are brought back by undo
+	class ComponentSnapshot
+	{
+	public:
+		virtual ~ComponentSnapshot() = default;
+
+		virtual void Restore(entt::registry& registry, entt::entity entity) const = 0;
+		virtual size_t GetMemoryUsage() const = 0;
+	};
+
+	template<typename T>
+	class TypedComponentSnapshot : public ComponentSnapshot
+	{
+	public:
+		TypedComponentSnapshot(const T& component)
+			: m_component(component)
+		{}
+
+		// The scene may have given the entity some of the components already
+		virtual void Restore(entt::registry& registry, entt::entity entity) const override
+		{
+			registry.emplace_or_replace<T>(entity, m_component);
+		}
+
+		virtual size_t GetMemoryUsage() const override
+		{
+			return sizeof(*this) + GetComponentMemoryUsage(m_component) - sizeof(T);
+		}
+
+	private:
+		T m_component;
+	};
+
+	// Compares what the editor can change, so clicks that change nothing don't end up as steps
+	template<typename T>
+	bool ComponentsEqual(const T& a, const T& b)
+	{
+		if constexpr (std::is_trivially_copyable_v<T>)
+			return memcmp(&a, &b, sizeof(T)) == 0;
+		else
+			return ReflectedEqual(a, b);
+	}
+
+	// A component that was edited, added or removed. An empty state means the entity did not have the component.
+	// Components that are plain bytes only keep the bytes that changed once the command is closed, the others keep
+	// both values since they own strings, vectors or assets.
+	template<typename T>
+	class ComponentUndoCommand : public UndoCommand
+	{
+	public:
+		ComponentUndoCommand(Entity entity, std::optional<T> before, std::optional<T> after)
+			: m_uuid(entity.GetUUID()), m_before(std::move(before)), m_after(std::move(after))
+		{}
+
+		UUID GetUUID() const { return m_uuid; }
+
+		void SetAfter(const T& after) { m_after = after; }
+
+		virtual void Undo(Scene& scene) override { Apply(scene, m_before, false); }
+		virtual void Redo(Scene& scene) override { Apply(scene, m_after, true); }
+
+		virtual size_t GetMemoryUsage() const override
+		{
+			size_t size = sizeof(*this) + m_delta.capacity();
+			if (m_before)
+				size += GetComponentMemoryUsage(*m_before);
+			if (m_after)
+				size += GetComponentMemoryUsage(*m_after);
+
+			return size;
+		}
+
+		virtual bool Close() override
+		{
+			if (!m_before || !m_after)
+				return true;
+
+			if (ComponentsEqual(*m_before, *m_after))
+				return false;
+
+			if constexpr (std::is_trivially_copyable_v<T>)
+			{
+				m_delta = CreateDelta(&*m_before, &*m_after, sizeof(T));
+				m_before.reset();
+				m_after.reset();
+			}
+
+			return true;
+		}
+
+	private:
+		void Apply(Scene& scene, const std::optional<T>& state, bool forward)
+		{
+			// Found by UUID, undoing a delete brings the entity back under another handle
+			Entity entity = scene.FindEntityByUUID(m_uuid);
+			if (!entity)
+			{
+				ENG_CORE_WARN("Undo history refers to an entity that does not exist anymore");
+				return;
+			}
+
+			entt::registry& registry = GetRegistry(scene);
+			if (!m_delta.empty())
+			{
+				if (T* component = registry.try_get<T>(entity))
+				{
+					ApplyDelta(component, m_delta, forward);
+					registry.patch<T>(entity);
+				}
+			} else if (state)
+			{
+				registry.emplace_or_replace<T>(entity, *state);
+			} else if (registry.all_of<T>(entity))
+			{
+				registry.remove<T>(entity);
+			}
+		}
+
+	private:
+		UUID m_uuid;
+		std::optional<T> m_before;
+		std::optional<T> m_after;
+		std::vector<uint8_t> m_delta;
+	};
+
+	// Undo and redo for the editor. Edits are recorded as commands that only touch the entities they are about,
+	// so undoing costs the same for any size of scene. The oldest commands are dropped once the history takes
+	// up more memory than its limit.
+	class UndoHistory
+	{
+	public:
+		UndoHistory(size_t memoryLimit = DefaultMemoryLimit);
+
+		// Starts an empty history for the scene
+		void SetContext(const Ref<Scene>& context);
+		void Clear();
+
+		// Records the change from before to the current value of the component. Edits of the same component follow
+		// up the last one until EndMerge is called, so a drag becomes one step.
+		template<typename T>
+		void RecordEdit(Entity entity, const T& before)
+		{
+			const T& after = entity.GetComponent<T>();
+
+			auto* command = dynamic_cast<ComponentUndoCommand<T>*>(m_openCommand);
+			if (command && command->GetUUID() == entity.GetUUID())
+			{
+				command->SetAfter(after);
+				return;
+			}
+
+			Push(CreateScope<ComponentUndoCommand<T>>(entity, before, after), true);
+		}
+
+		// Call after the component was added
+		template<typename T>
+		void RecordAdd(Entity entity)
+		{
+			Push(CreateScope<ComponentUndoCommand<T>>(entity, std::nullopt, entity.GetComponent<T>()), false);
+		}
+
+		// Call before the component is removed
+		template<typename T>
+		void RecordRemove(Entity entity)
+		{
+			Push(CreateScope<ComponentUndoCommand<T>>(entity, entity.GetComponent<T>(), std::nullopt), false);
+		}
+
+		// Call after the entity was created, with all of its components
+		void RecordCreate(Entity entity);
+		// Call before the entity is destroyed
+		void RecordDestroy(Entity entity);
+
+		// Ends merging edits into the last step, call once the widget or gizmo that made them is released
+		void EndMerge();
+
+		bool CanUndo() const { return m_position > 0; }
+		bool CanRedo() const { return m_position < m_commands.size(); }
+
+		void Undo();
+		void Redo();
+
+		void SetMemoryLimit(size_t memoryLimit);
+		size_t GetMemoryLimit() const { return m_memoryLimit; }
+		size_t GetMemoryUsage() const { return m_memoryUsage; }
+
+	public:
+		static constexpr size_t DefaultMemoryLimit = 64 * 1024 * 1024;
+
+	private:
+		void Push(Scope<UndoCommand> command, bool mergeable);
+		void Trim();
+
+	private:
+		Ref<Scene> m_context;
+
+		// Oldest first, a ring that drops from the front. Commands from m_position on were undone and can be redone.
+		std::deque<Scope<UndoCommand>> m_commands;
+		size_t m_position = 0;
+
+		size_t m_memoryLimit;
+		size_t m_memoryUsage = 0;
+
+		// The last command while edits are still merged into it, its memory is counted once it is closed
+		UndoCommand* m_openCommand = nullptr;
+	};
+}
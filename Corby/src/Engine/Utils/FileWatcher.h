@@ -0,0 +1,34 @@
+#pragma once
+
+#include "Engine/Core/Base.h"
+
+#include <filesystem>
+#include <vector>
+
+namespace Engine
+{
+	// Listens for changes below a directory on a background thread, so nobody has to poll the filesystem
+	class FileWatcher
+	{
+	public:
+		enum class ChangeType
+		{
+			Added, Removed, Modified
+		};
+
+		struct Change
+		{
+			ChangeType Type;
+			std::filesystem::path Path; // Relative to the watched directory, empty when changes were lost and everything has to be reloaded
+		};
+
+		virtual ~FileWatcher() = default;
+
+		// Changes collected since the last call
+		virtual std::vector<Change> PollChanges() = 0;
+
+		virtual const std::filesystem::path& GetDirectory() const = 0;
+
+		static Scope<FileWatcher> Create(const std::filesystem::path& directory, bool recursive = true);
+	};
+}
@@ -1,6 +1,8 @@
 #include "engpch.h"
 #include "OpenGLBuffer.h"
 
+#include "Engine/Renderer/RenderThread.h"
+
 #include <glad/glad.h>
 
 namespace Engine
@@ -9,45 +11,57 @@ namespace Engine
 	{
 		ENG_PROFILE_FUNCTION();
 
-		glCreateBuffers(1, &m_rendererID);
-		glBindBuffer(GL_ARRAY_BUFFER, m_rendererID);
-		glBufferData(GL_ARRAY_BUFFER, size, nullptr, GL_DYNAMIC_DRAW);
+		RenderThread::ExecuteAndWait([&] () {
+			glCreateBuffers(1, &m_rendererID);
+			glBindBuffer(GL_ARRAY_BUFFER, m_rendererID);
+			glBufferData(GL_ARRAY_BUFFER, size, nullptr, GL_DYNAMIC_DRAW);
+			});
 	}
 
 	OpenGLVertexBuffer::OpenGLVertexBuffer(float* vertices, unsigned int size)
 	{
 		ENG_PROFILE_FUNCTION();
 
-		glCreateBuffers(1, &m_rendererID);
-		glBindBuffer(GL_ARRAY_BUFFER, m_rendererID);
-		glBufferData(GL_ARRAY_BUFFER, size, vertices, GL_STATIC_DRAW);
+		RenderThread::ExecuteAndWait([&] () {
+			glCreateBuffers(1, &m_rendererID);
+			glBindBuffer(GL_ARRAY_BUFFER, m_rendererID);
+			glBufferData(GL_ARRAY_BUFFER, size, vertices, GL_STATIC_DRAW);
+			});
 	}
 
 	OpenGLVertexBuffer::~OpenGLVertexBuffer()
 	{
 		ENG_PROFILE_FUNCTION();
 
-		glDeleteBuffers(1, &m_rendererID);
+		RenderThread::Submit([id = m_rendererID] () {
+			glDeleteBuffers(1, &id);
+			});
 	}
 
 	void OpenGLVertexBuffer::Bind() const
 	{
 		ENG_PROFILE_FUNCTION();
 
-		glBindBuffer(GL_ARRAY_BUFFER, m_rendererID);
+		RenderThread::Submit([id = m_rendererID] () {
+			glBindBuffer(GL_ARRAY_BUFFER, id);
+			});
 	}
 
 	void OpenGLVertexBuffer::Unbind() const
 	{
 		ENG_PROFILE_FUNCTION();
 
-		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		RenderThread::Submit([] () {
+			glBindBuffer(GL_ARRAY_BUFFER, 0);
+			});
 	}
 
 	void OpenGLVertexBuffer::SetData(const void* data, uint32_t size)
 	{
-		glBindBuffer(GL_ARRAY_BUFFER, m_rendererID);
-		glBufferSubData(GL_ARRAY_BUFFER, 0, size, data);
+		RenderThread::Submit([id = m_rendererID, data = RenderThread::CopyCommandData(data, size), size] () {
+			glBindBuffer(GL_ARRAY_BUFFER, id);
+			glBufferSubData(GL_ARRAY_BUFFER, 0, size, data);
+			});
 	}
 
 	OpenGLIndexBuffer::OpenGLIndexBuffer(unsigned int* indices, unsigned int count)
@@ -55,29 +69,37 @@ namespace Engine
 	{
 		ENG_PROFILE_FUNCTION();
 
-		glCreateBuffers(1, &m_rendererID);
-		glBindBuffer(GL_ARRAY_BUFFER, m_rendererID);
-		glBufferData(GL_ARRAY_BUFFER, count * sizeof(unsigned int), indices, GL_STATIC_DRAW);
+		RenderThread::ExecuteAndWait([&] () {
+			glCreateBuffers(1, &m_rendererID);
+			glBindBuffer(GL_ARRAY_BUFFER, m_rendererID);
+			glBufferData(GL_ARRAY_BUFFER, count * sizeof(unsigned int), indices, GL_STATIC_DRAW);
+			});
 	}
 
 	OpenGLIndexBuffer::~OpenGLIndexBuffer()
 	{
 		ENG_PROFILE_FUNCTION();
 
-		glDeleteBuffers(1, &m_rendererID);
+		RenderThread::Submit([id = m_rendererID] () {
+			glDeleteBuffers(1, &id);
+			});
 	}
 
 	void OpenGLIndexBuffer::Bind() const
 	{
 		ENG_PROFILE_FUNCTION();
 
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_rendererID);
+		RenderThread::Submit([id = m_rendererID] () {
+			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, id);
+			});
 	}
 
 	void OpenGLIndexBuffer::Unbind() const
 	{
 		ENG_PROFILE_FUNCTION();
 
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+		RenderThread::Submit([] () {
+			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+			});
 	}
 }
@@ -1,6 +1,8 @@
 #include "engpch.h"
 #include "OpenGLFramebuffer.h"
 
+#include "Engine/Renderer/RenderThread.h"
+
 #include <glad/glad.h>
 
 namespace Engine
@@ -103,28 +105,29 @@ namespace Engine
 				m_depthAttachmentSpecification = specification;
 		}
 
-		invalidate();
+		// The attachment ids are needed right away, ImGui draws with them
+		RenderThread::ExecuteAndWait([this] () {
+			invalidate();
+			});
 	}
 
 	OpenGLFramebuffer::~OpenGLFramebuffer()
 	{
-		glDeleteFramebuffers(1, &m_rendererID);
-		glDeleteTextures(m_colorAttachments.size(), m_colorAttachments.data());
-		glDeleteTextures(1, &m_depthAttachment);
+		release();
 	}
 
-	void OpenGLFramebuffer::invalidate()
+	void OpenGLFramebuffer::release()
 	{
-		if (m_rendererID)
-		{
-			glDeleteFramebuffers(1, &m_rendererID);
-			glDeleteTextures(m_colorAttachments.size(), m_colorAttachments.data());
-			glDeleteTextures(1, &m_depthAttachment);
-
-			m_colorAttachments.clear();
-			m_depthAttachment = 0;
-		}
+		// Commands recorded before still draw into the attachments, they go once those ran
+		RenderThread::Submit([id = m_rendererID, colorAttachments = m_colorAttachments, depthAttachment = m_depthAttachment] () {
+			glDeleteFramebuffers(1, &id);
+			glDeleteTextures(colorAttachments.size(), colorAttachments.data());
+			glDeleteTextures(1, &depthAttachment);
+			});
+	}
 
+	void OpenGLFramebuffer::invalidate()
+	{
 		glCreateFramebuffers(1, &m_rendererID);
 		glBindFramebuffer(GL_FRAMEBUFFER, m_rendererID);
 
@@ -185,13 +188,17 @@ namespace Engine
 
 	void OpenGLFramebuffer::Bind()
 	{
-		glBindFramebuffer(GL_FRAMEBUFFER, m_rendererID);
-		glViewport(0, 0, m_specification.Width, m_specification.Height);
+		RenderThread::Submit([id = m_rendererID, width = m_specification.Width, height = m_specification.Height] () {
+			glBindFramebuffer(GL_FRAMEBUFFER, id);
+			glViewport(0, 0, width, height);
+			});
 	}
 
 	void OpenGLFramebuffer::Unbind()
 	{
-		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		RenderThread::Submit([] () {
+			glBindFramebuffer(GL_FRAMEBUFFER, 0);
+			});
 	}
 
 	void OpenGLFramebuffer::Resize(uint32_t width, uint32_t height)
@@ -205,16 +212,28 @@ namespace Engine
 		m_specification.Width = width;
 		m_specification.Height = height;
 
-		invalidate();
+		release();
+		m_rendererID = 0;
+		m_colorAttachments.clear();
+		m_depthAttachment = 0;
+
+		RenderThread::ExecuteAndWait([this] () {
+			invalidate();
+			});
 	}
 
 	int OpenGLFramebuffer::ReadPixel(uint32_t attachmentIndex, int x, int y)
 	{
 		ENG_CORE_ASSERT(attachmentIndex < m_colorAttachments.size());
 
-		glReadBuffer(GL_COLOR_ATTACHMENT0 + attachmentIndex);
+		// Runs between frames, so this reads what an earlier frame drew
 		int pixelData;
-		glReadPixels(x, y, 1, 1, GL_RED_INTEGER, GL_INT, &pixelData);
+		RenderThread::ExecuteAndWait([&] () {
+			glBindFramebuffer(GL_READ_FRAMEBUFFER, m_rendererID);
+			glReadBuffer(GL_COLOR_ATTACHMENT0 + attachmentIndex);
+			glReadPixels(x, y, 1, 1, GL_RED_INTEGER, GL_INT, &pixelData);
+			glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+			});
 
 		return pixelData;
 	}
@@ -224,7 +243,9 @@ namespace Engine
 		ENG_CORE_ASSERT(attachmentIndex < m_colorAttachments.size());
 
 		auto& spec = m_colorAttachmentSpecifications[attachmentIndex];
-		glClearTexImage(m_colorAttachments[attachmentIndex], 0, Utils::EngineFBTextureFormatToGL(spec.TextureFormat), GL_INT, &value);
+		RenderThread::Submit([id = m_colorAttachments[attachmentIndex], format = Utils::EngineFBTextureFormatToGL(spec.TextureFormat), value] () {
+			glClearTexImage(id, 0, format, GL_INT, &value);
+			});
 	}
 
 	uint32_t OpenGLFramebuffer::GetColorAttachmentRendererID(uint32_t index) const
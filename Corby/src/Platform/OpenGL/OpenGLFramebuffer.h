@@ -23,6 +23,9 @@ namespace Engine
 
 		virtual const FramebufferSpecification& GetSpecification() const override { return m_specification; }
 
+	private:
+		void release();
+
 	private:
 		uint32_t m_rendererID = 0;
 
@@ -86,6 +86,31 @@ namespace Engine
 		glDrawArrays(GL_LINES, 0, vertexCount);
 	}
 
+	void OpenGLRendererAPI::DrawIndexedIndirect(const Ref<VertexArray>& vertexArray, const Ref<StorageBuffer>& argumentBuffer, uint32_t offset)
+	{
+		vertexArray->Bind();
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, argumentBuffer->GetRendererID());
+		glDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, (const void*) (uintptr_t) offset);
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+	}
+
+	void OpenGLRendererAPI::DispatchCompute(uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ)
+	{
+		glDispatchCompute(groupCountX, groupCountY, groupCountZ);
+	}
+
+	void OpenGLRendererAPI::DispatchComputeIndirect(const Ref<StorageBuffer>& argumentBuffer, uint32_t offset)
+	{
+		glBindBuffer(GL_DISPATCH_INDIRECT_BUFFER, argumentBuffer->GetRendererID());
+		glDispatchComputeIndirect((GLintptr) offset);
+		glBindBuffer(GL_DISPATCH_INDIRECT_BUFFER, 0);
+	}
+
+	void OpenGLRendererAPI::StorageBufferBarrier()
+	{
+		glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_COMMAND_BARRIER_BIT);
+	}
+
 	void OpenGLRendererAPI::SetLineWidth(float width)
 	{
 		glLineWidth(width);
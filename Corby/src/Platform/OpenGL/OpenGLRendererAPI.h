@@ -13,6 +13,11 @@ namespace Engine
 		virtual void Clear() override;
 		virtual void DrawIndexed(const Ref<VertexArray>& vertexArray, uint32_t indexCount = 0) override;
 		virtual void DrawLines(const Ref<VertexArray>& vertexArray, uint32_t vertexCount) override;
+		virtual void DrawIndexedIndirect(const Ref<VertexArray>& vertexArray, const Ref<StorageBuffer>& argumentBuffer, uint32_t offset) override;
+
+		virtual void DispatchCompute(uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ) override;
+		virtual void DispatchComputeIndirect(const Ref<StorageBuffer>& argumentBuffer, uint32_t offset) override;
+		virtual void StorageBufferBarrier() override;
 
 		virtual void SetLineWidth(float width) override;
 	};
@@ -2,6 +2,7 @@
 #include "OpenGLShader.h"
 
 #include "Engine/Core/Timer.h"
+#include "Engine/Renderer/RenderThread.h"
 
 #include <fstream>
 
@@ -50,6 +51,8 @@ namespace Engine
 				return GL_VERTEX_SHADER;
 			if (type == "fragment" || type == "pixel")
 				return GL_FRAGMENT_SHADER;
+			if (type == "compute")
+				return GL_COMPUTE_SHADER;
 
 			ENG_CORE_ASSERT(false, "Unknown shader type!");
 			return 0;
@@ -63,6 +66,8 @@ namespace Engine
 					return shaderc_glsl_vertex_shader;
 				case GL_FRAGMENT_SHADER:
 					return shaderc_glsl_fragment_shader;
+				case GL_COMPUTE_SHADER:
+					return shaderc_glsl_compute_shader;
 			}
 
 			ENG_CORE_ASSERT(false);
@@ -77,6 +82,8 @@ namespace Engine
 					return "GL_VERTEX_SHADER";
 				case GL_FRAGMENT_SHADER:
 					return "GL_FRAGMENT_SHADER";
+				case GL_COMPUTE_SHADER:
+					return "GL_COMPUTE_SHADER";
 			}
 
 			ENG_CORE_ASSERT(false);
@@ -104,6 +111,8 @@ namespace Engine
 					return ".cached_opengl.vert";
 				case GL_FRAGMENT_SHADER:
 					return ".cached_opengl.frag";
+				case GL_COMPUTE_SHADER:
+					return ".cached_opengl.comp";
 			}
 
 			ENG_CORE_ASSERT(false);
@@ -118,6 +127,8 @@ namespace Engine
 					return ".cached_vulkan.vert";
 				case GL_FRAGMENT_SHADER:
 					return ".cached_vulkan.frag";
+				case GL_COMPUTE_SHADER:
+					return ".cached_vulkan.comp";
 			}
 
 			ENG_CORE_ASSERT(false);
@@ -137,15 +148,17 @@ namespace Engine
 
 		{
 			Timer timer;
-			CompileOrGetVulkanBinaries(shaderSources);
-			if (Utils::IsAmdGpu())
-			{
-				CreateProgramForAmdGpu();
-			} else
-			{
-				CompileOrGetOpenGLBinaries();
-				CreateProgram();
-			}
+			RenderThread::ExecuteAndWait([&] () {
+				CompileOrGetVulkanBinaries(shaderSources);
+				if (Utils::IsAmdGpu())
+				{
+					CreateProgramForAmdGpu();
+				} else
+				{
+					CompileOrGetOpenGLBinaries();
+					CreateProgram();
+				}
+				});
 
 			ENG_CORE_WARN("Shader creation took {0} ms", timer.ElapsedMillis());
 		}
@@ -167,35 +180,43 @@ namespace Engine
 		sources[GL_VERTEX_SHADER] = vertexSrc;
 		sources[GL_FRAGMENT_SHADER] = fragmentSrc;
 
-		if (Utils::IsAmdGpu())
-		{
-			CreateProgramForAmdGpu();
-		} else
-		{
-			CompileOrGetOpenGLBinaries();
-			CreateProgram();
-		}
+		RenderThread::ExecuteAndWait([this] () {
+			if (Utils::IsAmdGpu())
+			{
+				CreateProgramForAmdGpu();
+			} else
+			{
+				CompileOrGetOpenGLBinaries();
+				CreateProgram();
+			}
+			});
 	}
 
 	OpenGLShader::~OpenGLShader()
 	{
 		ENG_PROFILE_FUNCTION();
 
-		glDeleteProgram(m_rendererID);
+		RenderThread::Submit([id = m_rendererID] () {
+			glDeleteProgram(id);
+			});
 	}
 
 	void OpenGLShader::Bind() const
 	{
 		ENG_PROFILE_FUNCTION();
 
-		glUseProgram(m_rendererID);
+		RenderThread::Submit([id = m_rendererID] () {
+			glUseProgram(id);
+			});
 	}
 
 	void OpenGLShader::Unbind() const
 	{
 		ENG_PROFILE_FUNCTION();
 
-		glUseProgram(0);
+		RenderThread::Submit([] () {
+			glUseProgram(0);
+			});
 	}
 
 	std::string OpenGLShader::ReadFile(const std::string& filepath)
@@ -522,6 +543,7 @@ namespace Engine
 
 		ENG_CORE_TRACE("OpenGLShader::Reflect - {0} {1}", Utils::GLShaderStageToString(stage), m_filePath);
 		ENG_CORE_TRACE("    {0} uniform buffers", resources.uniform_buffers.size());
+		ENG_CORE_TRACE("    {0} storage buffers", resources.storage_buffers.size());
 		ENG_CORE_TRACE("    {0} resources", resources.sampled_images.size());
 
 		ENG_CORE_TRACE("Uniform buffers:");
@@ -590,49 +612,65 @@ namespace Engine
 
 	void OpenGLShader::UploadUniformInt(const std::string& name, int value)
 	{
-		GLint location = glGetUniformLocation(m_rendererID, name.c_str());
-		glUniform1i(location, value);
+		RenderThread::Submit([id = m_rendererID, name, value] () {
+			GLint location = glGetUniformLocation(id, name.c_str());
+			glUniform1i(location, value);
+			});
 	}
 
 	void OpenGLShader::UploadUniformIntArray(const std::string& name, int* values, uint32_t count)
 	{
-		GLint location = glGetUniformLocation(m_rendererID, name.c_str());
-		glUniform1iv(location, count, values);
+		RenderThread::Submit([id = m_rendererID, name, values = (const int*) RenderThread::CopyCommandData(values, count * sizeof(int)), count] () {
+			GLint location = glGetUniformLocation(id, name.c_str());
+			glUniform1iv(location, count, values);
+			});
 	}
 
 	void OpenGLShader::UploadUniformFloat(const std::string& name, float value)
 	{
-		GLint location = glGetUniformLocation(m_rendererID, name.c_str());
-		glUniform1f(location, value);
+		RenderThread::Submit([id = m_rendererID, name, value] () {
+			GLint location = glGetUniformLocation(id, name.c_str());
+			glUniform1f(location, value);
+			});
 	}
 
 	void OpenGLShader::UploadUniformFloat2(const std::string& name, const glm::vec2& value)
 	{
-		GLint location = glGetUniformLocation(m_rendererID, name.c_str());
-		glUniform2f(location, value.x, value.y);
+		RenderThread::Submit([id = m_rendererID, name, value] () {
+			GLint location = glGetUniformLocation(id, name.c_str());
+			glUniform2f(location, value.x, value.y);
+			});
 	}
 
 	void OpenGLShader::UploadUniformFloat3(const std::string& name, const glm::vec3& value)
 	{
-		GLint location = glGetUniformLocation(m_rendererID, name.c_str());
-		glUniform3f(location, value.x, value.y, value.z);
+		RenderThread::Submit([id = m_rendererID, name, value] () {
+			GLint location = glGetUniformLocation(id, name.c_str());
+			glUniform3f(location, value.x, value.y, value.z);
+			});
 	}
 
 	void OpenGLShader::UploadUniformFloat4(const std::string& name, const glm::vec4& value)
 	{
-		GLint location = glGetUniformLocation(m_rendererID, name.c_str());
-		glUniform4f(location, value.x, value.y, value.z, value.w);
+		RenderThread::Submit([id = m_rendererID, name, value] () {
+			GLint location = glGetUniformLocation(id, name.c_str());
+			glUniform4f(location, value.x, value.y, value.z, value.w);
+			});
 	}
 
 	void OpenGLShader::UploadUniformMat3(const std::string& name, const glm::mat3& matrix)
 	{
-		GLint location = glGetUniformLocation(m_rendererID, name.c_str());
-		glUniformMatrix3fv(location, 1, GL_FALSE, glm::value_ptr(matrix));
+		RenderThread::Submit([id = m_rendererID, name, matrix] () {
+			GLint location = glGetUniformLocation(id, name.c_str());
+			glUniformMatrix3fv(location, 1, GL_FALSE, glm::value_ptr(matrix));
+			});
 	}
 
 	void OpenGLShader::UploadUniformMat4(const std::string& name, const glm::mat4& matrix)
 	{
-		GLint location = glGetUniformLocation(m_rendererID, name.c_str());
-		glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(matrix));
+		RenderThread::Submit([id = m_rendererID, name, matrix] () {
+			GLint location = glGetUniformLocation(id, name.c_str());
+			glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(matrix));
+			});
 	}
 }
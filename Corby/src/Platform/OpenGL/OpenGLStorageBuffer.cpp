@@ -0,0 +1,39 @@
+#include "engpch.h"
+#include "OpenGLStorageBuffer.h"
+
+#include "Engine/Renderer/RenderThread.h"
+
+#include <glad/glad.h>
+
+namespace Engine
+{
+	OpenGLStorageBuffer::OpenGLStorageBuffer(uint32_t size, const void* data)
+		: m_size(size)
+	{
+		RenderThread::ExecuteAndWait([&] () {
+			glCreateBuffers(1, &m_rendererID);
+			glNamedBufferData(m_rendererID, size, data, GL_DYNAMIC_DRAW);
+			});
+	}
+
+	OpenGLStorageBuffer::~OpenGLStorageBuffer()
+	{
+		RenderThread::Submit([id = m_rendererID] () {
+			glDeleteBuffers(1, &id);
+			});
+	}
+
+	void OpenGLStorageBuffer::SetData(const void* data, uint32_t size, uint32_t offset)
+	{
+		RenderThread::Submit([id = m_rendererID, data = RenderThread::CopyCommandData(data, size), size, offset] () {
+			glNamedBufferSubData(id, offset, size, data);
+			});
+	}
+
+	void OpenGLStorageBuffer::Bind(uint32_t binding) const
+	{
+		RenderThread::Submit([id = m_rendererID, binding] () {
+			glBindBufferBase(GL_SHADER_STORAGE_BUFFER, binding, id);
+			});
+	}
+}
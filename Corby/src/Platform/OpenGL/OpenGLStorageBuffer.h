@@ -0,0 +1,23 @@
+#pragma once
+
+#include "Engine/Renderer/StorageBuffer.h"
+
+namespace Engine
+{
+	class OpenGLStorageBuffer : public StorageBuffer
+	{
+	public:
+		OpenGLStorageBuffer(uint32_t size, const void* data);
+		virtual ~OpenGLStorageBuffer();
+
+		virtual void SetData(const void* data, uint32_t size, uint32_t offset = 0) override;
+		virtual void Bind(uint32_t binding) const override;
+
+		virtual uint32_t GetSize() const override { return m_size; }
+		virtual uint32_t GetRendererID() const override { return m_rendererID; }
+
+	private:
+		uint32_t m_rendererID = 0;
+		uint32_t m_size = 0;
+	};
+}
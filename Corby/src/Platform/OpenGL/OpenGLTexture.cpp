@@ -1,6 +1,8 @@
 #include "engpch.h"
 #include "OpenGLTexture.h"
 
+#include "Engine/Renderer/RenderThread.h"
+
 #include <stb_image.h>
 
 namespace Engine
@@ -13,14 +15,17 @@ namespace Engine
 		m_internalFormat = GL_RGBA8;
 		m_dataFormat = GL_RGBA;
 
-		glCreateTextures(GL_TEXTURE_2D, 1, &m_rendererID);
-		glTextureStorage2D(m_rendererID, 1, m_internalFormat, m_width, m_height);
+		// The id is needed right away, ImGui draws with it
+		RenderThread::ExecuteAndWait([&] () {
+			glCreateTextures(GL_TEXTURE_2D, 1, &m_rendererID);
+			glTextureStorage2D(m_rendererID, 1, m_internalFormat, m_width, m_height);
 
-		glTextureParameteri(m_rendererID, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-		glTextureParameteri(m_rendererID, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+			glTextureParameteri(m_rendererID, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+			glTextureParameteri(m_rendererID, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
-		glTextureParameteri(m_rendererID, GL_TEXTURE_WRAP_S, GL_REPEAT);
-		glTextureParameteri(m_rendererID, GL_TEXTURE_WRAP_T, GL_REPEAT);
+			glTextureParameteri(m_rendererID, GL_TEXTURE_WRAP_S, GL_REPEAT);
+			glTextureParameteri(m_rendererID, GL_TEXTURE_WRAP_T, GL_REPEAT);
+			});
 	}
 
 	OpenGLTexture2D::OpenGLTexture2D(const std::string& filepath)
@@ -61,16 +66,19 @@ namespace Engine
 
 			ENG_CORE_ASSERT(internalFormat & dataFormat, "Texture format not supported!");
 
-			glCreateTextures(GL_TEXTURE_2D, 1, &m_rendererID);
-			glTextureStorage2D(m_rendererID, 1, internalFormat, m_width, m_height);
+			// Decoding stays on this thread, only the upload runs on the render thread
+			RenderThread::ExecuteAndWait([&] () {
+				glCreateTextures(GL_TEXTURE_2D, 1, &m_rendererID);
+				glTextureStorage2D(m_rendererID, 1, internalFormat, m_width, m_height);
 
-			glTextureParameteri(m_rendererID, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-			glTextureParameteri(m_rendererID, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+				glTextureParameteri(m_rendererID, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+				glTextureParameteri(m_rendererID, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
-			glTextureParameteri(m_rendererID, GL_TEXTURE_WRAP_S, GL_REPEAT);
-			glTextureParameteri(m_rendererID, GL_TEXTURE_WRAP_T, GL_REPEAT);
+				glTextureParameteri(m_rendererID, GL_TEXTURE_WRAP_S, GL_REPEAT);
+				glTextureParameteri(m_rendererID, GL_TEXTURE_WRAP_T, GL_REPEAT);
 
-			glTextureSubImage2D(m_rendererID, 0, 0, 0, m_width, m_height, dataFormat, GL_UNSIGNED_BYTE, data);
+				glTextureSubImage2D(m_rendererID, 0, 0, 0, m_width, m_height, dataFormat, GL_UNSIGNED_BYTE, data);
+				});
 
 			stbi_image_free(data);
 		}
@@ -80,7 +88,9 @@ namespace Engine
 	{
 		ENG_PROFILE_FUNCTION();
 
-		glDeleteTextures(1, &m_rendererID);
+		RenderThread::Submit([id = m_rendererID] () {
+			glDeleteTextures(1, &id);
+			});
 	}
 
 	void OpenGLTexture2D::SetData(void* data, uint32_t size)
@@ -89,13 +99,28 @@ namespace Engine
 
 		uint32_t bpp = m_dataFormat == GL_RGBA ? 4 : 3;
 		ENG_CORE_ASSERT(size == m_width * m_height * bpp, "Data must be entire texture!");
-		glTextureSubImage2D(m_rendererID, 0, 0, 0, m_width, m_height, m_dataFormat, GL_UNSIGNED_BYTE, data);
+		RenderThread::Submit([id = m_rendererID, width = m_width, height = m_height, format = m_dataFormat, data = RenderThread::CopyCommandData(data, size)] () {
+			glTextureSubImage2D(id, 0, 0, 0, width, height, format, GL_UNSIGNED_BYTE, data);
+			});
+	}
+
+	void OpenGLTexture2D::SetData(void* data, uint32_t x, uint32_t y, uint32_t width, uint32_t height)
+	{
+		ENG_PROFILE_FUNCTION();
+
+		ENG_CORE_ASSERT(x + width <= m_width && y + height <= m_height, "Region must be inside the texture!");
+		uint32_t bpp = m_dataFormat == GL_RGBA ? 4 : 3;
+		RenderThread::Submit([id = m_rendererID, x, y, width, height, format = m_dataFormat, data = RenderThread::CopyCommandData(data, width * height * bpp)] () {
+			glTextureSubImage2D(id, 0, x, y, width, height, format, GL_UNSIGNED_BYTE, data);
+			});
 	}
 
 	void OpenGLTexture2D::Bind(uint32_t slot) const
 	{
 		ENG_PROFILE_FUNCTION();
 
-		glBindTextureUnit(slot, m_rendererID);
+		RenderThread::Submit([id = m_rendererID, slot] () {
+			glBindTextureUnit(slot, id);
+			});
 	}
 }
@@ -16,8 +16,10 @@ namespace Engine
 		virtual uint32_t GetWidth() const override { return m_width; }
 		virtual uint32_t GetHeight() const override { return m_height; }
 		virtual uint32_t GetRendererID() const override { return m_rendererID; }
+		virtual const std::string& GetPath() const override { return m_path; }
 
 		virtual void SetData(void* data, uint32_t size) override;
+		virtual void SetData(void* data, uint32_t x, uint32_t y, uint32_t width, uint32_t height) override;
 
 		virtual void Bind(uint32_t slot = 0) const override;
 
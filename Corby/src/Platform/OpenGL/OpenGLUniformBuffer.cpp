@@ -1,24 +1,32 @@
 #include "engpch.h"
 #include "OpenGLUniformBuffer.h"
 
+#include "Engine/Renderer/RenderThread.h"
+
 #include <glad/glad.h>
 
 namespace Engine
 {
 	OpenGLUniformBuffer::OpenGLUniformBuffer(uint32_t size, uint32_t binding)
 	{
-		glCreateBuffers(1, &m_rendererID);
-		glNamedBufferData(m_rendererID, size, nullptr, GL_DYNAMIC_DRAW);
-		glBindBufferBase(GL_UNIFORM_BUFFER, binding, m_rendererID);
+		RenderThread::ExecuteAndWait([&] () {
+			glCreateBuffers(1, &m_rendererID);
+			glNamedBufferData(m_rendererID, size, nullptr, GL_DYNAMIC_DRAW);
+			glBindBufferBase(GL_UNIFORM_BUFFER, binding, m_rendererID);
+			});
 	}
 
 	OpenGLUniformBuffer::~OpenGLUniformBuffer()
 	{
-		glDeleteBuffers(1, &m_rendererID);
+		RenderThread::Submit([id = m_rendererID] () {
+			glDeleteBuffers(1, &id);
+			});
 	}
 
 	void OpenGLUniformBuffer::SetData(const void* data, uint32_t size, uint32_t offset)
 	{
-		glNamedBufferSubData(m_rendererID, offset, size, data);
+		RenderThread::Submit([id = m_rendererID, data = RenderThread::CopyCommandData(data, size), size, offset] () {
+			glNamedBufferSubData(id, offset, size, data);
+			});
 	}
 }
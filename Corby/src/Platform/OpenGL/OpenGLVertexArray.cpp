@@ -1,6 +1,8 @@
 #include "engpch.h"
 #include "OpenGLVertexArray.h"
 
+#include "Engine/Renderer/RenderThread.h"
+
 #include <glad/glad.h>
 
 namespace Engine
@@ -20,51 +22,17 @@ namespace Engine
 			case ShaderDataType::Int3:		return GL_INT;
 			case ShaderDataType::Int4:		return GL_INT;
 			case ShaderDataType::Bool:		return GL_BOOL;
+			case ShaderDataType::UInt:		return GL_UNSIGNED_INT;
+			case ShaderDataType::Half2:		return GL_HALF_FLOAT;
+			case ShaderDataType::UByte4:	return GL_UNSIGNED_BYTE;
 		}
 
 		ENG_CORE_ASSERT(false, "Unknown ShaderDataType!");
 		return 0;
 	}
 
-	OpenGLVertexArray::OpenGLVertexArray()
-	{
-		ENG_PROFILE_FUNCTION();
-
-		glCreateVertexArrays(1, &m_rendererID);
-	}
-
-	OpenGLVertexArray::~OpenGLVertexArray()
-	{
-		ENG_PROFILE_FUNCTION();
-
-		glDeleteVertexArrays(1, &m_rendererID);
-	}
-
-	void OpenGLVertexArray::Bind() const
-	{
-		ENG_PROFILE_FUNCTION();
-
-		glBindVertexArray(m_rendererID);
-	}
-
-	void OpenGLVertexArray::Unbind() const
-	{
-		ENG_PROFILE_FUNCTION();
-
-		glBindVertexArray(0);
-	}
-
-	void OpenGLVertexArray::AddVertexBuffer(const Ref<VertexBuffer>& vertexBuffer)
+	static void SetVertexAttributes(const BufferLayout& layout, uint32_t index)
 	{
-		ENG_PROFILE_FUNCTION();
-
-		ENG_CORE_ASSERT(vertexBuffer->GetLayout().GetElements().size(), "VertexBuffer has no layout!");
-
-		glBindVertexArray(m_rendererID);
-		vertexBuffer->Bind();
-
-		const auto& layout = vertexBuffer->GetLayout();
-
 		for (const auto& element : layout)
 		{
 			switch (element.Type)
@@ -73,16 +41,18 @@ namespace Engine
 				case ShaderDataType::Float2:
 				case ShaderDataType::Float3:
 				case ShaderDataType::Float4:
+				case ShaderDataType::Half2:
+				case ShaderDataType::UByte4:
 				{
-					glEnableVertexAttribArray(m_vertexBufferIndex);
-					glVertexAttribPointer(m_vertexBufferIndex,
+					glEnableVertexAttribArray(index);
+					glVertexAttribPointer(index,
 						element.GetComponentCount(),
 						ShaderDataTypeToOpenGLBaseType(element.Type),
 						element.Normalized ? GL_TRUE : GL_FALSE,
 						layout.GetStride(),
 						(const void*) element.Offset
 					);
-					m_vertexBufferIndex++;
+					index++;
 					break;
 				}
 				case ShaderDataType::Int:
@@ -90,15 +60,16 @@ namespace Engine
 				case ShaderDataType::Int3:
 				case ShaderDataType::Int4:
 				case ShaderDataType::Bool:
+				case ShaderDataType::UInt:
 				{
-					glEnableVertexAttribArray(m_vertexBufferIndex);
-					glVertexAttribIPointer(m_vertexBufferIndex,
+					glEnableVertexAttribArray(index);
+					glVertexAttribIPointer(index,
 						element.GetComponentCount(),
 						ShaderDataTypeToOpenGLBaseType(element.Type),
 						layout.GetStride(),
 						(const void*) element.Offset
 					);
-					m_vertexBufferIndex++;
+					index++;
 					break;
 				}
 
@@ -109,15 +80,15 @@ namespace Engine
 
 					for (uint8_t i = 0; i < count; i++)
 					{
-						glEnableVertexAttribArray(m_vertexBufferIndex);
-						glVertexAttribPointer(m_vertexBufferIndex,
+						glEnableVertexAttribArray(index);
+						glVertexAttribPointer(index,
 							count,
 							ShaderDataTypeToOpenGLBaseType(element.Type),
 							element.Normalized ? GL_TRUE : GL_FALSE,
 							layout.GetStride(),
 							(const void*) (element.Offset + (sizeof(float) * count * i))
 						);
-						m_vertexBufferIndex++;
+						index++;
 					}
 					break;
 				}
@@ -126,6 +97,63 @@ namespace Engine
 					ENG_CORE_ASSERT(false, "Unknown ShaderDataType!");
 			}
 		}
+	}
+
+	OpenGLVertexArray::OpenGLVertexArray()
+	{
+		ENG_PROFILE_FUNCTION();
+
+		RenderThread::ExecuteAndWait([&] () {
+			glCreateVertexArrays(1, &m_rendererID);
+			});
+	}
+
+	OpenGLVertexArray::~OpenGLVertexArray()
+	{
+		ENG_PROFILE_FUNCTION();
+
+		RenderThread::Submit([id = m_rendererID] () {
+			glDeleteVertexArrays(1, &id);
+			});
+	}
+
+	void OpenGLVertexArray::Bind() const
+	{
+		ENG_PROFILE_FUNCTION();
+
+		RenderThread::Submit([id = m_rendererID] () {
+			glBindVertexArray(id);
+			});
+	}
+
+	void OpenGLVertexArray::Unbind() const
+	{
+		ENG_PROFILE_FUNCTION();
+
+		RenderThread::Submit([] () {
+			glBindVertexArray(0);
+			});
+	}
+
+	void OpenGLVertexArray::AddVertexBuffer(const Ref<VertexBuffer>& vertexBuffer)
+	{
+		ENG_PROFILE_FUNCTION();
+
+		ENG_CORE_ASSERT(vertexBuffer->GetLayout().GetElements().size(), "VertexBuffer has no layout!");
+
+		// The attribute indices are counted here, so the recorded command doesn't depend on this object
+		uint32_t firstIndex = m_vertexBufferIndex;
+		for (const auto& element : vertexBuffer->GetLayout())
+		{
+			bool isMatrix = element.Type == ShaderDataType::Mat3 || element.Type == ShaderDataType::Mat4;
+			m_vertexBufferIndex += isMatrix ? element.GetComponentCount() : 1;
+		}
+
+		RenderThread::Submit([id = m_rendererID, vertexBuffer, layout = vertexBuffer->GetLayout(), firstIndex] () {
+			glBindVertexArray(id);
+			vertexBuffer->Bind();
+			SetVertexAttributes(layout, firstIndex);
+			});
 
 		m_vertexBuffers.push_back(vertexBuffer);
 	}
@@ -134,8 +162,10 @@ namespace Engine
 	{
 		ENG_PROFILE_FUNCTION();
 
-		glBindVertexArray(m_rendererID);
-		indexBuffer->Bind();
+		RenderThread::Submit([id = m_rendererID, indexBuffer] () {
+			glBindVertexArray(id);
+			indexBuffer->Bind();
+			});
 
 		m_indexBuffer = indexBuffer;
 	}
@@ -0,0 +1,128 @@
+#include "engpch.h"
+#include "WindowsFileWatcher.h"
+
+namespace Engine
+{
+	Scope<FileWatcher> FileWatcher::Create(const std::filesystem::path& directory, bool recursive)
+	{
+		return CreateScope<WindowsFileWatcher>(directory, recursive);
+	}
+
+	WindowsFileWatcher::WindowsFileWatcher(const std::filesystem::path& directory, bool recursive)
+		: m_directory(directory), m_recursive(recursive)
+	{
+		ENG_PROFILE_FUNCTION();
+
+		m_directoryHandle = CreateFileW(directory.c_str(), FILE_LIST_DIRECTORY, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+			nullptr, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+
+		if (m_directoryHandle == INVALID_HANDLE_VALUE)
+		{
+			ENG_CORE_ERROR("Could not watch directory '{0}'", directory.string());
+			return;
+		}
+
+		m_stopEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+		m_thread = std::thread([this] () { Watch(); });
+	}
+
+	WindowsFileWatcher::~WindowsFileWatcher()
+	{
+		if (m_thread.joinable())
+		{
+			SetEvent(m_stopEvent);
+			m_thread.join();
+		}
+
+		if (m_stopEvent)
+			CloseHandle(m_stopEvent);
+
+		if (m_directoryHandle != INVALID_HANDLE_VALUE)
+			CloseHandle(m_directoryHandle);
+	}
+
+	std::vector<FileWatcher::Change> WindowsFileWatcher::PollChanges()
+	{
+		std::vector<Change> changes;
+
+		std::lock_guard<std::mutex> lock(m_changeMutex);
+		std::swap(changes, m_changes);
+		return changes;
+	}
+
+	void WindowsFileWatcher::Watch()
+	{
+		const DWORD filter = FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_SIZE;
+
+		// Notifications are DWORD aligned
+		alignas(DWORD) uint8_t buffer[64 * 1024];
+
+		OVERLAPPED overlapped = {};
+		overlapped.hEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+		HANDLE events[] = { overlapped.hEvent, m_stopEvent };
+
+		while (true)
+		{
+			ResetEvent(overlapped.hEvent);
+			if (!ReadDirectoryChangesW(m_directoryHandle, buffer, sizeof(buffer), m_recursive, filter, nullptr, &overlapped, nullptr))
+			{
+				ENG_CORE_ERROR("Stopped watching directory '{0}'", m_directory.string());
+				break;
+			}
+
+			DWORD result = WaitForMultipleObjects(2, events, FALSE, INFINITE);
+			if (result != WAIT_OBJECT_0)
+			{
+				CancelIoEx(m_directoryHandle, &overlapped);
+
+				DWORD bytes;
+				GetOverlappedResult(m_directoryHandle, &overlapped, &bytes, TRUE);
+				break;
+			}
+
+			DWORD bytes = 0;
+			if (!GetOverlappedResult(m_directoryHandle, &overlapped, &bytes, FALSE))
+				continue;
+
+			std::lock_guard<std::mutex> lock(m_changeMutex);
+
+			// The buffer overflowed, the changes are lost
+			if (bytes == 0)
+			{
+				m_changes.push_back({ ChangeType::Modified, std::filesystem::path() });
+				continue;
+			}
+
+			uint8_t* entry = buffer;
+			while (true)
+			{
+				FILE_NOTIFY_INFORMATION* info = (FILE_NOTIFY_INFORMATION*) entry;
+				std::filesystem::path path(std::wstring(info->FileName, info->FileNameLength / sizeof(WCHAR)));
+
+				switch (info->Action)
+				{
+					case FILE_ACTION_ADDED:
+					case FILE_ACTION_RENAMED_NEW_NAME:
+						m_changes.push_back({ ChangeType::Added, path });
+						break;
+
+					case FILE_ACTION_REMOVED:
+					case FILE_ACTION_RENAMED_OLD_NAME:
+						m_changes.push_back({ ChangeType::Removed, path });
+						break;
+
+					case FILE_ACTION_MODIFIED:
+						m_changes.push_back({ ChangeType::Modified, path });
+						break;
+				}
+
+				if (info->NextEntryOffset == 0)
+					break;
+
+				entry += info->NextEntryOffset;
+			}
+		}
+
+		CloseHandle(overlapped.hEvent);
+	}
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "Engine/Utils/FileWatcher.h"
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+namespace Engine
+{
+	class WindowsFileWatcher : public FileWatcher
+	{
+	public:
+		WindowsFileWatcher(const std::filesystem::path& directory, bool recursive);
+		virtual ~WindowsFileWatcher();
+
+		virtual std::vector<Change> PollChanges() override;
+
+		virtual const std::filesystem::path& GetDirectory() const override { return m_directory; }
+
+	private:
+		void Watch();
+
+	private:
+		std::filesystem::path m_directory;
+		bool m_recursive;
+
+		HANDLE m_directoryHandle = INVALID_HANDLE_VALUE;
+		HANDLE m_stopEvent = nullptr;
+		std::thread m_thread;
+
+		std::mutex m_changeMutex;
+		std::vector<Change> m_changes;
+	};
+}
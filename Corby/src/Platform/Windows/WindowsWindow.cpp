@@ -6,6 +6,7 @@
 #include "Engine/Events/KeyEvent.h"
 #include "Engine/Events/MouseEvent.h"
 #include "Engine/Renderer/Renderer.h"
+#include "Engine/Renderer/RenderThread.h"
 #include "Platform/OpenGL/OpenGLContext.h"
 
 namespace Engine
@@ -180,20 +181,25 @@ namespace Engine
 
 		glfwPollEvents();
 
-		m_context->SwapBuffers();
+		RenderThread::Submit([context = m_context.get()] () {
+			context->SwapBuffers();
+			});
 	}
 
 	void WindowsWindow::SetVSync(bool enabled)
 	{
 		ENG_PROFILE_FUNCTION();
 
-		if (enabled)
-		{
-			glfwSwapInterval(1);
-		} else
-		{
-			glfwSwapInterval(0);
-		}
+		// The interval belongs to the context, which is current on the render thread
+		RenderThread::Submit([enabled] () {
+			if (enabled)
+			{
+				glfwSwapInterval(1);
+			} else
+			{
+				glfwSwapInterval(0);
+			}
+			});
 
 		m_data.VSync = enabled;
 	}
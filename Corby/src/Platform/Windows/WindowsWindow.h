@@ -23,6 +23,7 @@ namespace Engine
 		bool IsVSync() const override;
 
 		virtual void* GetNativeWindow() const { return m_window; }
+		virtual GraphicsContext& GetContext() override { return *m_context; }
 
 	private:
 		virtual void Init(const WindowProps& props);
@@ -0,0 +1,78 @@
+// 2D Text Shader (multi-channel signed distance field)
+
+#type vertex
+#version 450 core
+
+layout(location = 0) in vec3 a_Position;
+layout(location = 1) in vec4 a_Color;
+layout(location = 2) in vec2 a_TexCoord;
+layout(location = 3) in int a_EntityID;
+
+layout(std140, binding = 0) uniform Camera
+{
+	mat4 u_ViewProjection;
+};
+
+struct VertexOutput
+{
+	vec4 Color;
+	vec2 TexCoord;
+};
+
+layout (location = 0) out VertexOutput Output;
+layout (location = 2) out flat int v_EntityID;
+
+void main()
+{
+	Output.Color = a_Color;
+	Output.TexCoord = a_TexCoord;
+	v_EntityID = a_EntityID;
+
+	gl_Position = u_ViewProjection * vec4(a_Position, 1.0);
+}
+
+#type fragment
+#version 450 core
+
+layout(location = 0) out vec4 o_Color;
+layout(location = 1) out int o_EntityID;
+
+struct VertexOutput
+{
+	vec4 Color;
+	vec2 TexCoord;
+};
+
+layout (location = 0) in VertexOutput Input;
+layout (location = 2) in flat int v_EntityID;
+
+layout (binding = 0) uniform sampler2D u_FontAtlas;
+
+// Must match the -pxrange used by scripts/BakeFont.py
+const float c_PxRange = 2.0;
+
+float median(float r, float g, float b)
+{
+	return max(min(r, g), min(max(r, g), b));
+}
+
+float screenPxRange()
+{
+	vec2 unitRange = vec2(c_PxRange) / vec2(textureSize(u_FontAtlas, 0));
+	vec2 screenTexSize = vec2(1.0) / fwidth(Input.TexCoord);
+	return max(0.5 * dot(unitRange, screenTexSize), 1.0);
+}
+
+void main()
+{
+	vec3 msd = texture(u_FontAtlas, Input.TexCoord).rgb;
+	float sd = median(msd.r, msd.g, msd.b);
+	float screenPxDistance = screenPxRange() * (sd - 0.5);
+	float opacity = clamp(screenPxDistance + 0.5, 0.0, 1.0);
+
+	if (opacity == 0.0)
+		discard;
+
+	o_Color = vec4(Input.Color.rgb, Input.Color.a * opacity);
+	o_EntityID = v_EntityID;
+}
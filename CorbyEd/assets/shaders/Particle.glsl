@@ -0,0 +1,101 @@
+// Particle Shader
+
+#type vertex
+#version 450 core
+
+layout(std140, binding = 0) uniform Camera
+{
+	mat4 u_ViewProjection;
+};
+
+layout(std140, binding = 1) uniform Emitter
+{
+	vec4 Position;
+	vec4 ColorBegin;
+	vec4 ColorEnd;
+	vec2 Velocity;
+	vec2 VelocityVariation;
+	vec2 Gravity;
+	float SizeBegin;
+	float SizeEnd;
+	float LifeTime;
+	float DeltaTime;
+	uint EmitRequest;
+	uint MaxParticles;
+	uint RandomSeed;
+	int EntityID;
+} u_Emitter;
+
+struct Particle
+{
+	vec2 Position;
+	vec2 Velocity;
+	float Age;
+	float LifeTime;
+	vec2 Padding;
+};
+
+layout(std430, binding = 0) readonly buffer Particles
+{
+	Particle b_Particles[];
+};
+
+layout(std430, binding = 1) readonly buffer AliveList
+{
+	uint b_AliveList[];
+};
+
+struct VertexOutput
+{
+	vec2 LocalPosition;
+	vec4 Color;
+};
+
+layout (location = 0) out VertexOutput Output;
+layout (location = 2) out flat int v_EntityID;
+
+const vec2 c_Corners[4] = vec2[](vec2(-0.5, -0.5), vec2(0.5, -0.5), vec2(0.5, 0.5), vec2(-0.5, 0.5));
+
+void main()
+{
+	Particle particle = b_Particles[b_AliveList[gl_InstanceIndex]];
+	float life = particle.Age / particle.LifeTime;
+	float size = mix(u_Emitter.SizeBegin, u_Emitter.SizeEnd, life);
+	vec2 corner = c_Corners[gl_VertexIndex];
+
+	Output.LocalPosition = corner * 2.0;
+	Output.Color = mix(u_Emitter.ColorBegin, u_Emitter.ColorEnd, life);
+
+	v_EntityID = u_Emitter.EntityID;
+
+	gl_Position = u_ViewProjection * vec4(particle.Position + corner * size, u_Emitter.Position.z, 1.0);
+}
+
+#type fragment
+#version 450 core
+
+layout(location = 0) out vec4 o_Color;
+layout(location = 1) out int o_EntityID;
+
+struct VertexOutput
+{
+	vec2 LocalPosition;
+	vec4 Color;
+};
+
+layout (location = 0) in VertexOutput Input;
+layout (location = 2) in flat int v_EntityID;
+
+void main()
+{
+	// Soft disc, same falloff as a circle drawn with a fade of 0.5
+	float distance = 1.0 - length(Input.LocalPosition);
+	float circle = smoothstep(0.0, 0.5, distance);
+
+	if (circle == 0.0)
+		discard;
+
+	o_Color = Input.Color;
+	o_Color.a *= circle;
+	o_EntityID = v_EntityID;
+}
@@ -0,0 +1,104 @@
+// Particle emit shader, takes particles from the dead list and appends them to the alive list
+
+#type compute
+#version 450 core
+
+layout(local_size_x = 256) in;
+
+layout(std140, binding = 1) uniform Emitter
+{
+	vec4 Position;
+	vec4 ColorBegin;
+	vec4 ColorEnd;
+	vec2 Velocity;
+	vec2 VelocityVariation;
+	vec2 Gravity;
+	float SizeBegin;
+	float SizeEnd;
+	float LifeTime;
+	float DeltaTime;
+	uint EmitRequest;
+	uint MaxParticles;
+	uint RandomSeed;
+	int EntityID;
+} u_Emitter;
+
+struct Particle
+{
+	vec2 Position;
+	vec2 Velocity;
+	float Age;
+	float LifeTime;
+	vec2 Padding;
+};
+
+layout(std430, binding = 0) buffer Particles
+{
+	Particle b_Particles[];
+};
+
+layout(std430, binding = 1) buffer AliveList
+{
+	uint b_AliveList[];
+};
+
+layout(std430, binding = 3) buffer DeadList
+{
+	uint b_DeadList[];
+};
+
+layout(std430, binding = 4) buffer Arguments
+{
+	uint EmitGroups[3];
+	uint SimulateGroups[3];
+
+	uint DrawIndexCount;
+	uint DrawInstanceCount;
+	uint DrawFirstIndex;
+	int DrawBaseVertex;
+	uint DrawBaseInstance;
+
+	uint AliveCount;
+	uint DeadCount;
+	uint EmitCount;
+} b_Arguments;
+
+uint Hash(uint x)
+{
+	x ^= x >> 16;
+	x *= 0x7feb352du;
+	x ^= x >> 15;
+	x *= 0x846ca68bu;
+	x ^= x >> 16;
+	return x;
+}
+
+float Random(inout uint state)
+{
+	state = Hash(state);
+	return float(state) / 4294967295.0;
+}
+
+void main()
+{
+	uint id = gl_GlobalInvocationID.x;
+	if (id >= b_Arguments.EmitCount)
+		return;
+
+	uint deadSlot = atomicAdd(b_Arguments.DeadCount, 0xffffffffu) - 1;
+	uint index = b_DeadList[deadSlot];
+
+	uint seed = u_Emitter.RandomSeed ^ Hash(id);
+
+	Particle particle;
+	particle.Position = u_Emitter.Position.xy;
+	particle.Velocity.x = u_Emitter.Velocity.x + u_Emitter.VelocityVariation.x * (Random(seed) - 0.5);
+	particle.Velocity.y = u_Emitter.Velocity.y + u_Emitter.VelocityVariation.y * (Random(seed) - 0.5);
+	particle.Age = 0.0;
+	particle.LifeTime = u_Emitter.LifeTime;
+	particle.Padding = vec2(0.0);
+	b_Particles[index] = particle;
+
+	uint aliveSlot = atomicAdd(b_Arguments.AliveCount, 1);
+	b_AliveList[aliveSlot] = index;
+}
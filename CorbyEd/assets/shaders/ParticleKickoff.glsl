@@ -0,0 +1,56 @@
+// Particle kickoff shader, clamps the emit request and writes the dispatch arguments for this frame
+
+#type compute
+#version 450 core
+
+layout(local_size_x = 1) in;
+
+layout(std140, binding = 1) uniform Emitter
+{
+	vec4 Position;
+	vec4 ColorBegin;
+	vec4 ColorEnd;
+	vec2 Velocity;
+	vec2 VelocityVariation;
+	vec2 Gravity;
+	float SizeBegin;
+	float SizeEnd;
+	float LifeTime;
+	float DeltaTime;
+	uint EmitRequest;
+	uint MaxParticles;
+	uint RandomSeed;
+	int EntityID;
+} u_Emitter;
+
+layout(std430, binding = 4) buffer Arguments
+{
+	uint EmitGroups[3];
+	uint SimulateGroups[3];
+
+	uint DrawIndexCount;
+	uint DrawInstanceCount;
+	uint DrawFirstIndex;
+	int DrawBaseVertex;
+	uint DrawBaseInstance;
+
+	uint AliveCount;
+	uint DeadCount;
+	uint EmitCount;
+} b_Arguments;
+
+const uint c_GroupSize = 256;
+
+void main()
+{
+	// Particles that survived the last simulate pass are the alive ones for this frame
+	uint aliveCount = b_Arguments.DrawInstanceCount;
+	uint emitCount = min(u_Emitter.EmitRequest, b_Arguments.DeadCount);
+
+	b_Arguments.AliveCount = aliveCount;
+	b_Arguments.EmitCount = emitCount;
+	b_Arguments.DrawInstanceCount = 0;
+
+	b_Arguments.EmitGroups[0] = (emitCount + c_GroupSize - 1) / c_GroupSize;
+	b_Arguments.SimulateGroups[0] = (aliveCount + emitCount + c_GroupSize - 1) / c_GroupSize;
+}
@@ -0,0 +1,97 @@
+// Particle simulate shader, integrates alive particles and compacts the survivors into the next alive list
+
+#type compute
+#version 450 core
+
+layout(local_size_x = 256) in;
+
+layout(std140, binding = 1) uniform Emitter
+{
+	vec4 Position;
+	vec4 ColorBegin;
+	vec4 ColorEnd;
+	vec2 Velocity;
+	vec2 VelocityVariation;
+	vec2 Gravity;
+	float SizeBegin;
+	float SizeEnd;
+	float LifeTime;
+	float DeltaTime;
+	uint EmitRequest;
+	uint MaxParticles;
+	uint RandomSeed;
+	int EntityID;
+} u_Emitter;
+
+struct Particle
+{
+	vec2 Position;
+	vec2 Velocity;
+	float Age;
+	float LifeTime;
+	vec2 Padding;
+};
+
+layout(std430, binding = 0) buffer Particles
+{
+	Particle b_Particles[];
+};
+
+layout(std430, binding = 1) readonly buffer AliveList
+{
+	uint b_AliveList[];
+};
+
+layout(std430, binding = 2) writeonly buffer NextAliveList
+{
+	uint b_NextAliveList[];
+};
+
+layout(std430, binding = 3) buffer DeadList
+{
+	uint b_DeadList[];
+};
+
+layout(std430, binding = 4) buffer Arguments
+{
+	uint EmitGroups[3];
+	uint SimulateGroups[3];
+
+	uint DrawIndexCount;
+	uint DrawInstanceCount;
+	uint DrawFirstIndex;
+	int DrawBaseVertex;
+	uint DrawBaseInstance;
+
+	uint AliveCount;
+	uint DeadCount;
+	uint EmitCount;
+} b_Arguments;
+
+void main()
+{
+	uint id = gl_GlobalInvocationID.x;
+	if (id >= b_Arguments.AliveCount)
+		return;
+
+	uint index = b_AliveList[id];
+	Particle particle = b_Particles[index];
+
+	float dt = u_Emitter.DeltaTime;
+	particle.Age += dt;
+
+	if (particle.Age < particle.LifeTime)
+	{
+		particle.Velocity += u_Emitter.Gravity * dt;
+		particle.Position += particle.Velocity * dt;
+		b_Particles[index] = particle;
+
+		// The instance count of the indirect draw doubles as the survivor counter
+		uint aliveSlot = atomicAdd(b_Arguments.DrawInstanceCount, 1);
+		b_NextAliveList[aliveSlot] = index;
+	} else
+	{
+		uint deadSlot = atomicAdd(b_Arguments.DeadCount, 1);
+		b_DeadList[deadSlot] = index;
+	}
+}
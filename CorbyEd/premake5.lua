@@ -20,6 +20,7 @@ project "CorbyEd"
 		"%{wks.location}/Corby/vendor",
 		"%{IncludeDir.glm}",
 		"%{IncludeDir.entt}",
+		"%{IncludeDir.yaml_cpp}",
 		"%{IncludeDir.ImGuizmo}"
 	}
 
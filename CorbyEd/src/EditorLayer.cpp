@@ -15,7 +15,13 @@ namespace Engine
 
 	EditorLayer::EditorLayer()
 		: Layer("EditorLayer"), m_cameraController(1280.0f / 720.0f)
-	{}
+	{
+		m_cameraController.Subscribe(*this);
+		m_editorCamera.Subscribe(*this);
+
+		Subscribe<KeyPressedEvent>(ENG_BIND_EVENT_FN(EditorLayer::OnKeyPressed));
+		Subscribe<MouseButtonPressedEvent>(ENG_BIND_EVENT_FN(EditorLayer::OnMouseButtonPressed));
+	}
 
 	void EditorLayer::OnAttach()
 	{
@@ -31,6 +37,7 @@ namespace Engine
 		m_framebuffer = Framebuffer::Create(fbSpec);
 
 		m_activeScene = CreateRef<Scene>();
+		m_editorScene = m_activeScene;
 
 		auto commandLineArgs = Application::Get().GetCommandLineArgs();
 		if (commandLineArgs.Count > 1)
@@ -43,6 +50,8 @@ namespace Engine
 		m_editorCamera = EditorCamera(30.0f, 1.778f, 0.1f, 1000.0f);
 
 		m_sceneHierarchyPanel.SetContext(m_activeScene);
+		m_sceneHierarchyPanel.SetUndoHistory(&m_undoHistory);
+		m_undoHistory.SetContext(m_activeScene);
 	}
 
 	void EditorLayer::OnDetach()
@@ -212,6 +221,19 @@ namespace Engine
 				ImGui::EndMenu();
 			}
 
+			if (ImGui::BeginMenu("Edit"))
+			{
+				bool editing = m_sceneState == SceneState::Edit;
+
+				if (ImGui::MenuItem("Undo", "Ctrl+Z", false, editing && m_undoHistory.CanUndo()))
+					OnUndo();
+
+				if (ImGui::MenuItem("Redo", "Ctrl+Y", false, editing && m_undoHistory.CanRedo()))
+					OnRedo();
+
+				ImGui::EndMenu();
+			}
+
 			ImGui::EndMenuBar();
 		}
 
@@ -247,6 +269,25 @@ namespace Engine
 		// -----------------------------------------
 		ImGui::Begin("Settings");
 		ImGui::Checkbox("Show physics colliders", &m_showPhysicsColliders);
+
+		if (ImGui::CollapsingHeader("Physics", ImGuiTreeNodeFlags_DefaultOpen))
+		{
+			auto& physicsSettings = m_activeScene->GetPhysicsSettings();
+
+			int stepRate = (int) std::round(1.0f / physicsSettings.FixedTimestep);
+			if (ImGui::DragInt("Step Rate (Hz)", &stepRate, 1.0f, 10, 1000))
+				physicsSettings.FixedTimestep = 1.0f / (float) std::max(stepRate, 1);
+
+			int maxSubsteps = (int) physicsSettings.MaxSubsteps;
+			if (ImGui::DragInt("Max Substeps", &maxSubsteps, 1.0f, 1, 64))
+				physicsSettings.MaxSubsteps = (uint32_t) std::max(maxSubsteps, 1);
+
+			ImGui::DragInt("Velocity Iterations", &physicsSettings.VelocityIterations, 1.0f, 1, 100);
+			ImGui::DragInt("Position Iterations", &physicsSettings.PositionIterations, 1.0f, 1, 100);
+			ImGui::Checkbox("Interpolate", &physicsSettings.Interpolate);
+			ImGui::Checkbox("Run On Worker Thread", &physicsSettings.RunOnWorkerThread);
+		}
+
 		ImGui::End();
 
 		// -----------------------------------------
@@ -277,7 +318,11 @@ namespace Engine
 			if (const ImGuiPayload* payload = ImGui::AcceptDragDropPayload("CONTENT_BROWSER_ITEM"))
 			{
 				const wchar_t* path = (const wchar_t*) payload->Data;
-				OpenScene(std::filesystem::path(g_assetPath) / path);
+				std::filesystem::path assetPath = std::filesystem::path(g_assetPath) / path;
+				if (assetPath.extension().string() == ".prefab")
+					InstantiatePrefab(assetPath);
+				else
+					OpenScene(assetPath);
 			}
 			ImGui::EndDragDropTarget();
 		}
@@ -305,6 +350,7 @@ namespace Engine
 
 			// Entity transform
 			auto& tc = selectedEntity.GetComponent<TransformComponent>();
+			TransformComponent before = tc;
 			glm::mat4 transform = tc.GetTransform();
 
 			// Snapping
@@ -329,6 +375,12 @@ namespace Engine
 				tc.Translation = translation;
 				tc.Rotation += deltaRotation;
 				tc.Scale = scale;
+
+				selectedEntity.PatchComponent<TransformComponent>();
+
+				// The whole drag becomes one step, see EndMerge below
+				if (m_sceneState == SceneState::Edit)
+					m_undoHistory.RecordEdit<TransformComponent>(selectedEntity, before);
 			}
 		}
 
@@ -338,16 +390,10 @@ namespace Engine
 		UI_Toolbar();
 
 		ImGui::End();
-	}
-
-	void EditorLayer::OnEvent(Event& e)
-	{
-		m_cameraController.OnEvent(e);
-		m_editorCamera.OnEvent(e);
 
-		EventDispatcher dispatcher(e);
-		dispatcher.Dispatch<KeyPressedEvent>(ENG_BIND_EVENT_FN(EditorLayer::OnKeyPressed));
-		dispatcher.Dispatch<MouseButtonPressedEvent>(ENG_BIND_EVENT_FN(EditorLayer::OnMouseButtonPressed));
+		// Drags and text input keep adding to the last step until they are released
+		if (!ImGui::IsAnyItemActive() && !ImGuizmo::IsUsing())
+			m_undoHistory.EndMerge();
 	}
 
 	bool EditorLayer::OnKeyPressed(KeyPressedEvent& e)
@@ -391,6 +437,26 @@ namespace Engine
 			{
 				if (control)
 					OnDuplicateEntity();
+				break;
+			}
+
+			case Key::Y:
+			{
+				if (control)
+					OnRedo();
+				break;
+			}
+
+			case Key::Z:
+			{
+				if (control)
+				{
+					if (shift)
+						OnRedo();
+					else
+						OnUndo();
+				}
+				break;
 			}
 
 			//Gizmos
@@ -422,6 +488,8 @@ namespace Engine
 				break;
 			}
 		}
+
+		return false;
 	}
 
 	bool EditorLayer::OnMouseButtonPressed(MouseButtonPressedEvent& e)
@@ -482,6 +550,71 @@ namespace Engine
 					Renderer2D::DrawCircle(transform, glm::vec4(0, 1, 0, 1), 0.01f);
 				}
 			}
+
+			// Polygons and chains are drawn in body space, the way the fixtures are built
+			auto bodyTransform = [] (const TransformComponent& tc) {
+				return glm::translate(glm::mat4(1.0f), tc.Translation + glm::vec3(0.0f, 0.0f, 0.001f))
+					* glm::rotate(glm::mat4(1.0f), tc.Rotation.z, glm::vec3(0.0f, 0.0f, 1.0f));
+			};
+
+			auto drawOutline = [] (const glm::mat4& transform, const glm::vec3& scale, const std::vector<glm::vec2>& vertices, bool loop) {
+				for (size_t i = 0; i + 1 < vertices.size() + (loop ? 1 : 0); i++)
+				{
+					const glm::vec2& v0 = vertices[i];
+					const glm::vec2& v1 = vertices[(i + 1) % vertices.size()];
+					glm::vec3 p0 = transform * glm::vec4(v0.x * scale.x, v0.y * scale.y, 0.0f, 1.0f);
+					glm::vec3 p1 = transform * glm::vec4(v1.x * scale.x, v1.y * scale.y, 0.0f, 1.0f);
+					Renderer2D::DrawLine(p0, p1, glm::vec4(0, 1, 0, 1));
+				}
+			};
+
+			// Polygon colliders
+			{
+				auto view = m_activeScene->GetAllEntitiesWith<TransformComponent, PolygonCollider2DComponent>();
+				for (auto entity : view)
+				{
+					auto [tc, polygonCollider] = view.get<TransformComponent, PolygonCollider2DComponent>(entity);
+					drawOutline(bodyTransform(tc), tc.Scale, polygonCollider.Vertices, true);
+				}
+			}
+
+			// Capsule colliders
+			{
+				auto view = m_activeScene->GetAllEntitiesWith<TransformComponent, CapsuleCollider2DComponent>();
+				for (auto entity : view)
+				{
+					auto [tc, capsuleCollider] = view.get<TransformComponent, CapsuleCollider2DComponent>(entity);
+
+					glm::vec2 center = capsuleCollider.Offset * glm::vec2(tc.Scale);
+					float radius = capsuleCollider.Radius * tc.Scale.x;
+					float halfHeight = capsuleCollider.Height * 0.5f * tc.Scale.y;
+					glm::mat4 transform = bodyTransform(tc);
+
+					for (float side : { -1.0f, 1.0f })
+					{
+						glm::mat4 capTransform = glm::translate(transform, glm::vec3(center.x, center.y + side * halfHeight, 0.0f))
+							* glm::scale(glm::mat4(1.0f), glm::vec3(radius * 2.0f));
+						Renderer2D::DrawCircle(capTransform, glm::vec4(0, 1, 0, 1), 0.01f);
+					}
+
+					glm::mat4 boxTransform = glm::translate(transform, glm::vec3(center, 0.0f))
+						* glm::scale(glm::mat4(1.0f), glm::vec3(radius * 2.0f, halfHeight * 2.0f, 1.0f));
+					Renderer2D::DrawRect(boxTransform, glm::vec4(0, 1, 0, 1));
+				}
+			}
+
+			// Chain colliders
+			{
+				auto view = m_activeScene->GetAllEntitiesWith<TransformComponent, ChainCollider2DComponent>();
+				for (auto entity : view)
+				{
+					auto [tc, chainCollider] = view.get<TransformComponent, ChainCollider2DComponent>(entity);
+
+					glm::mat4 transform = bodyTransform(tc);
+					for (const auto& chain : chainCollider.Chains)
+						drawOutline(transform, tc.Scale, chain.Vertices, chain.Loop);
+				}
+			}
 		}
 
 		Renderer2D::EndScene();
@@ -489,9 +622,14 @@ namespace Engine
 
 	void EditorLayer::NewScene()
 	{
+		if (m_sceneState != SceneState::Edit)
+			OnSceneStop();
+
 		m_activeScene = CreateRef<Scene>();
 		m_activeScene->OnViewportResize((uint32_t) m_viewportSize.x, (uint32_t) m_viewportSize.y);
+		m_editorScene = m_activeScene;
 		m_sceneHierarchyPanel.SetContext(m_activeScene);
+		m_undoHistory.SetContext(m_activeScene);
 
 		m_editorScenePath = std::filesystem::path();
 	}
@@ -524,6 +662,7 @@ namespace Engine
 			m_editorScene = newScene;
 			m_editorScene->OnViewportResize((uint32_t) m_viewportSize.x, (uint32_t) m_viewportSize.y);
 			m_sceneHierarchyPanel.SetContext(m_editorScene);
+			m_undoHistory.SetContext(m_editorScene);
 
 			m_activeScene = m_editorScene;
 			m_editorScenePath = path;
@@ -563,6 +702,7 @@ namespace Engine
 		m_activeScene->OnRuntimeStart();
 
 		m_sceneHierarchyPanel.SetContext(m_activeScene);
+		m_sceneHierarchyPanel.SetUndoHistory(nullptr);
 	}
 
 	void EditorLayer::OnSceneStop()
@@ -573,6 +713,7 @@ namespace Engine
 		m_activeScene = m_editorScene;
 
 		m_sceneHierarchyPanel.SetContext(m_activeScene);
+		m_sceneHierarchyPanel.SetUndoHistory(&m_undoHistory);
 	}
 
 	void EditorLayer::OnDuplicateEntity()
@@ -582,7 +723,44 @@ namespace Engine
 
 		Entity selectedEntity = m_sceneHierarchyPanel.GetSelectedEntity();
 		if (selectedEntity)
-			m_editorScene->DuplicateEntity(selectedEntity);
+		{
+			Entity newEntity = m_editorScene->DuplicateEntity(selectedEntity);
+			m_undoHistory.RecordCreate(newEntity);
+		}
+	}
+
+	void EditorLayer::InstantiatePrefab(const std::filesystem::path& path)
+	{
+		if (m_sceneState != SceneState::Edit)
+			return;
+
+		Ref<Prefab> prefab = Prefab::Load(path);
+		if (!prefab)
+			return;
+
+		Entity newEntity = m_editorScene->InstantiatePrefab(prefab);
+		m_undoHistory.RecordCreate(newEntity);
+		m_sceneHierarchyPanel.SetSelectedEntity(newEntity);
+	}
+
+	void EditorLayer::OnUndo()
+	{
+		if (m_sceneState != SceneState::Edit || ImGuizmo::IsUsing())
+			return;
+
+		m_undoHistory.Undo();
+
+		// Picked again from the next frame, the entity under the mouse might be gone
+		m_hoveredEntity = {};
+	}
+
+	void EditorLayer::OnRedo()
+	{
+		if (m_sceneState != SceneState::Edit || ImGuizmo::IsUsing())
+			return;
+
+		m_undoHistory.Redo();
+		m_hoveredEntity = {};
 	}
 
 	void EditorLayer::UI_Toolbar()
@@ -17,7 +17,6 @@ namespace Engine
 
 		void OnUpdate(Timestep ts) override;
 		virtual void OnImGuiRender() override;
-		void OnEvent(Event& e) override;
 
 	private:
 		bool OnKeyPressed(KeyPressedEvent& e);
@@ -35,6 +34,10 @@ namespace Engine
 		void OnScenePlay();
 		void OnSceneStop();
 		void OnDuplicateEntity();
+		void InstantiatePrefab(const std::filesystem::path& path);
+
+		void OnUndo();
+		void OnRedo();
 
 		// UI Panels
 		void UI_Toolbar();
@@ -69,6 +72,9 @@ namespace Engine
 
 		SceneState m_sceneState = SceneState::Edit;
 
+		// Edits of the scene being edited, play mode runs on a copy and is not recorded
+		UndoHistory m_undoHistory;
+
 		// Panels
 		SceneHierarchyPanel m_sceneHierarchyPanel;
 		ContentBrowserPanel m_contentBrowserPanel;
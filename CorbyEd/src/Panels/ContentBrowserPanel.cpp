@@ -7,21 +7,31 @@ namespace Engine
 {
 	extern const std::filesystem::path g_assetPath = "assets";
 
+	static const std::filesystem::path s_thumbnailCachePath = "Cache/Thumbnails";
+
 	ContentBrowserPanel::ContentBrowserPanel()
-		: m_currentDirectory(g_assetPath)
+		: m_currentDirectory(g_assetPath), m_thumbnailCache(s_thumbnailCachePath)
 	{
 		m_directoryIcon = Texture2D::Create("Resources/Icons/ContentBrowser/DirectoryIcon.png");
 		m_fileIcon = Texture2D::Create("Resources/Icons/ContentBrowser/FileIcon.png");
+
+		m_fileWatcher = FileWatcher::Create(g_assetPath);
 	}
 
 	void ContentBrowserPanel::OnImGuiRender()
 	{
+		ProcessFileChanges();
+		if (m_directoryDirty)
+			RefreshDirectory();
+
+		m_thumbnailCache.OnUpdate();
+
 		ImGui::Begin("Content Browser");
 
 		if (m_currentDirectory != std::filesystem::path(g_assetPath))
 		{
 			if (ImGui::Button("<-"))
-				m_currentDirectory = m_currentDirectory.parent_path();
+				SetCurrentDirectory(m_currentDirectory.parent_path());
 		}
 
 		static float padding = 16.0f;
@@ -33,42 +43,137 @@ namespace Engine
 		if (columnCount < 1)
 			columnCount = 1;
 
-		ImGui::Columns(columnCount, 0, false);
+		// Navigating changes the listing, so double clicks are applied after it has been drawn
+		std::filesystem::path openedDirectory;
 
-		for (auto& directoryEntry : std::filesystem::directory_iterator(m_currentDirectory))
+		float footerHeight = ImGui::GetFrameHeightWithSpacing() * 2.0f;
+		if (ImGui::BeginTable("ContentBrowserTable", columnCount, ImGuiTableFlags_ScrollY, { 0.0f, -footerHeight }))
 		{
-			const auto& path = directoryEntry.path();
-			auto relativePath = std::filesystem::relative(path, g_assetPath);
-			std::string filenameString = relativePath.filename().string();
+			// Rows are the same height, so only the rows in view are drawn
+			int rowCount = ((int) m_entries.size() + columnCount - 1) / columnCount;
+			ImGuiListClipper clipper;
+			clipper.Begin(rowCount);
+			while (clipper.Step())
+			{
+				for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; row++)
+				{
+					ImGui::TableNextRow();
 
-			ImGui::PushID(filenameString.c_str());
-			Ref<Texture2D> icon = directoryEntry.is_directory() ? m_directoryIcon : m_fileIcon;
-			ImGui::PushStyleColor(ImGuiCol_Button, ImVec4(0, 0, 0, 0));
-			ImGui::ImageButton((ImTextureID) icon->GetRendererID(), { thumbnailSize, thumbnailSize }, { 0, 1 }, { 1, 0 });
+					for (int column = 0; column < columnCount; column++)
+					{
+						size_t index = (size_t) row * columnCount + column;
+						if (index >= m_entries.size())
+							break;
 
-			if (ImGui::BeginDragDropSource())
-			{
-				const wchar_t* itemPath = relativePath.c_str();
-				ImGui::SetDragDropPayload("CONTENT_BROWSER_ITEM", itemPath, (wcslen(itemPath) + 1) * sizeof(wchar_t));
-				ImGui::EndDragDropSource();
-			}
-			ImGui::PopStyleColor();
+						ImGui::TableNextColumn();
 
-			if (ImGui::IsItemHovered() && ImGui::IsMouseDoubleClicked(ImGuiMouseButton_Left))
-			{
-				if (directoryEntry.is_directory())
-					m_currentDirectory /= path.filename();
+						const DirectoryEntry& entry = m_entries[index];
+
+						ImGui::PushID(entry.Filename.c_str());
+
+						Ref<Texture2D> icon = entry.IsDirectory ? m_directoryIcon : m_fileIcon;
+						glm::vec2 uv0 = { 0.0f, 1.0f };
+						glm::vec2 uv1 = { 1.0f, 0.0f };
+						if (entry.IsImage && m_thumbnailCache.GetThumbnail(entry.Path, uv0, uv1))
+							icon = m_thumbnailCache.GetAtlas();
+
+						ImGui::PushStyleColor(ImGuiCol_Button, ImVec4(0, 0, 0, 0));
+						ImGui::ImageButton((ImTextureID) icon->GetRendererID(), { thumbnailSize, thumbnailSize }, { uv0.x, uv0.y }, { uv1.x, uv1.y });
+
+						if (ImGui::BeginDragDropSource())
+						{
+							const wchar_t* itemPath = entry.RelativePath.c_str();
+							ImGui::SetDragDropPayload("CONTENT_BROWSER_ITEM", itemPath, (wcslen(itemPath) + 1) * sizeof(wchar_t));
+							ImGui::EndDragDropSource();
+						}
+						ImGui::PopStyleColor();
+
+						if (ImGui::IsItemHovered() && ImGui::IsMouseDoubleClicked(ImGuiMouseButton_Left))
+						{
+							if (entry.IsDirectory)
+								openedDirectory = entry.Path;
+						}
+
+						// One line per name keeps the rows the same height, the column clips what doesn't fit
+						ImGui::TextUnformatted(entry.Filename.c_str(), entry.Filename.c_str() + entry.Filename.size());
+						if (ImGui::IsItemHovered() && ImGui::CalcTextSize(entry.Filename.c_str()).x > thumbnailSize)
+							ImGui::SetTooltip("%s", entry.Filename.c_str());
+
+						ImGui::PopID();
+					}
+				}
 			}
-			ImGui::TextWrapped(filenameString.c_str());
+			clipper.End();
 
-			ImGui::NextColumn();
-			ImGui::PopID();
+			ImGui::EndTable();
 		}
 
-		ImGui::Columns(1);
+		if (!openedDirectory.empty())
+			SetCurrentDirectory(openedDirectory);
+
 		ImGui::SliderFloat("Thumbnail size", &thumbnailSize, 16, 512);
 		ImGui::SliderFloat("Padding", &padding, 0, 32);
 
 		ImGui::End();
 	}
+
+	void ContentBrowserPanel::SetCurrentDirectory(const std::filesystem::path& directory)
+	{
+		m_currentDirectory = directory;
+		m_directoryDirty = true;
+	}
+
+	void ContentBrowserPanel::ProcessFileChanges()
+	{
+		if (!m_fileWatcher)
+			return;
+
+		for (const auto& change : m_fileWatcher->PollChanges())
+		{
+			if (change.Path.empty())
+			{
+				m_directoryDirty = true;
+				continue;
+			}
+
+			std::filesystem::path path = m_fileWatcher->GetDirectory() / change.Path;
+			if (path.parent_path() == m_currentDirectory)
+				m_directoryDirty = true;
+
+			if (change.Type == FileWatcher::ChangeType::Modified && ThumbnailCache::IsImage(path))
+				m_thumbnailCache.Invalidate(path);
+		}
+	}
+
+	void ContentBrowserPanel::RefreshDirectory()
+	{
+		ENG_PROFILE_FUNCTION();
+
+		m_entries.clear();
+		m_directoryDirty = false;
+
+		std::error_code error;
+		for (auto& directoryEntry : std::filesystem::directory_iterator(m_currentDirectory, error))
+		{
+			const auto& path = directoryEntry.path();
+
+			DirectoryEntry& entry = m_entries.emplace_back();
+			entry.Path = path;
+			entry.RelativePath = std::filesystem::relative(path, g_assetPath);
+			entry.Filename = entry.RelativePath.filename().string();
+			entry.IsDirectory = directoryEntry.is_directory();
+			entry.IsImage = !entry.IsDirectory && ThumbnailCache::IsImage(path);
+		}
+
+		if (error)
+			ENG_WARN("Could not read directory '{0}': {1}", m_currentDirectory.string(), error.message());
+
+		// Directories first, then by name
+		std::sort(m_entries.begin(), m_entries.end(), [] (const DirectoryEntry& a, const DirectoryEntry& b) {
+			if (a.IsDirectory != b.IsDirectory)
+				return a.IsDirectory;
+
+			return a.Filename < b.Filename;
+			});
+	}
 }
@@ -1,6 +1,9 @@
 #pragma once
 
 #include "Engine/Renderer/Texture.h"
+#include "Engine/Utils/FileWatcher.h"
+
+#include "ThumbnailCache.h"
 
 #include <filesystem>
 
@@ -14,8 +17,29 @@ namespace Engine
 		void OnImGuiRender();
 
 	private:
+		void SetCurrentDirectory(const std::filesystem::path& directory);
+		void ProcessFileChanges();
+		void RefreshDirectory();
+
+	private:
+		struct DirectoryEntry
+		{
+			std::filesystem::path Path;
+			std::filesystem::path RelativePath;
+			std::string Filename;
+			bool IsDirectory;
+			bool IsImage;
+		};
+
 		std::filesystem::path m_currentDirectory;
 
+		// Listing of the current directory, only read again when the watcher reports a change
+		std::vector<DirectoryEntry> m_entries;
+		bool m_directoryDirty = true;
+		Scope<FileWatcher> m_fileWatcher;
+
+		ThumbnailCache m_thumbnailCache;
+
 		Ref<Texture2D> m_directoryIcon;
 		Ref<Texture2D> m_fileIcon;
 	};
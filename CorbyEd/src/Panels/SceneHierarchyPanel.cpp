@@ -1,7 +1,12 @@
 #include "SceneHierarchyPanel.h"
 
+#include "Engine/Physics/ColliderBaker.h"
+#include "Engine/Scene/ComponentReflection.h"
 #include "Engine/Scene/Components.h"
+#include "Engine/Scene/Prefab.h"
 
+#include <algorithm>
+#include <cctype>
 #include <cstring>
 /* The Microsoft C++ compiler is non-compliant with the C++ standard and needs
  * the following definition to disable a security warning on std::strncpy().
@@ -18,15 +23,115 @@ namespace Engine
 {
 	extern const std::filesystem::path g_assetPath;
 
+	static void markDirty(bool& dirty, entt::registry& registry, entt::entity entity)
+	{
+		dirty = true;
+	}
+
+	struct ComponentFilter
+	{
+		const char* Name;
+		bool (*HasComponent)(const entt::registry& registry, entt::entity entity);
+		void (*Watch)(entt::registry& registry, bool& dirty, std::vector<entt::connection>& connections);
+	};
+
+	template<typename T>
+	static ComponentFilter makeComponentFilter(const char* name)
+	{
+		return {
+			name,
+			[] (const entt::registry& registry, entt::entity entity) { return registry.all_of<T>(entity); },
+			[] (entt::registry& registry, bool& dirty, std::vector<entt::connection>& connections) {
+				connections.push_back(registry.on_construct<T>().template connect<&markDirty>(dirty));
+				connections.push_back(registry.on_destroy<T>().template connect<&markDirty>(dirty));
+			}
+		};
+	}
+
+	static std::vector<ComponentFilter> makeComponentFilters()
+	{
+		std::vector<ComponentFilter> filters;
+		AllComponents::Each([&] (auto type) {
+			using T = typename decltype(type)::Type;
+			if constexpr (!(Reflection<T>::Flags & ComponentNotListed))
+				filters.push_back(makeComponentFilter<T>(Reflection<T>::DisplayName));
+			});
+
+		return filters;
+	}
+
+	static const std::vector<ComponentFilter> s_componentFilters = makeComponentFilters();
+
+	static bool containsIgnoreCase(const std::string& text, const std::string& pattern)
+	{
+		if (pattern.empty())
+			return true;
+
+		auto it = std::search(text.begin(), text.end(), pattern.begin(), pattern.end(), [] (char a, char b) {
+			return std::tolower((unsigned char) a) == std::tolower((unsigned char) b);
+			});
+		return it != text.end();
+	}
+
+	// A file in the asset folder named after the tag that does not exist yet. Characters a file name can't hold
+	// are replaced and a number is added when the name is taken.
+	static std::filesystem::path makePrefabPath(const std::string& tag)
+	{
+		std::string name;
+		for (char c : tag)
+			name += (std::isalnum((unsigned char) c) || c == ' ' || c == '-' || c == '_') ? c : '_';
+
+		if (name.find_first_not_of(" _") == std::string::npos)
+			name = "Prefab";
+
+		std::filesystem::path path = std::filesystem::path(g_assetPath) / (name + ".prefab");
+		for (int i = 1; std::filesystem::exists(path); i++)
+			path = std::filesystem::path(g_assetPath) / (name + " " + std::to_string(i) + ".prefab");
+
+		return path;
+	}
+
 	SceneHierarchyPanel::SceneHierarchyPanel(const Ref<Scene>& context)
 	{
 		SetContext(context);
 	}
 
+	SceneHierarchyPanel::~SceneHierarchyPanel()
+	{
+		DisconnectContext();
+	}
+
 	void SceneHierarchyPanel::SetContext(const Ref<Scene>& context)
 	{
+		DisconnectContext();
+
 		m_context = context;
 		m_selectionContext = {};
+
+		m_entityList.clear();
+		m_visibleEntities.clear();
+		m_entityListDirty = true;
+		m_componentsDirty = true;
+
+		if (!m_context)
+			return;
+
+		// Every entity has a tag, so its signals tell us about created and destroyed entities
+		entt::registry& registry = m_context->m_registry;
+		m_connections.push_back(registry.on_construct<TagComponent>().connect<&markDirty>(m_entityListDirty));
+		m_connections.push_back(registry.on_destroy<TagComponent>().connect<&markDirty>(m_entityListDirty));
+		m_connections.push_back(registry.on_update<TagComponent>().connect<&markDirty>(m_entityListDirty));
+
+		for (const auto& filter : s_componentFilters)
+			filter.Watch(registry, m_componentsDirty, m_connections);
+	}
+
+	void SceneHierarchyPanel::DisconnectContext()
+	{
+		for (auto& connection : m_connections)
+			connection.release();
+
+		m_connections.clear();
 	}
 
 	void SceneHierarchyPanel::OnImGuiRender()
@@ -38,10 +143,45 @@ namespace Engine
 		// -----------------------------------------
 		ImGui::Begin("Scene Hierarchy");
 
-		m_context->m_registry.each([&] (auto entityID) {
-			Entity entity{ entityID, m_context.get() };
-			DrawEntityNode(entity);
-			});
+		// Undo and redo can take the selected entity away
+		if (m_selectionContext && !m_context->m_registry.valid(m_selectionContext))
+			m_selectionContext = {};
+
+		ImGui::SetNextItemWidth(ImGui::GetContentRegionAvail().x * 0.6f);
+		ImGui::InputTextWithHint("##Search", "Search", m_searchBuffer, sizeof(m_searchBuffer));
+
+		ImGui::SameLine();
+		ImGui::SetNextItemWidth(-1);
+		if (ImGui::BeginCombo("##ComponentFilter", m_componentFilter < 0 ? "All components" : s_componentFilters[m_componentFilter].Name))
+		{
+			if (ImGui::Selectable("All components", m_componentFilter < 0))
+				m_componentFilter = -1;
+
+			for (int i = 0; i < (int) s_componentFilters.size(); i++)
+			{
+				if (ImGui::Selectable(s_componentFilters[i].Name, m_componentFilter == i))
+					m_componentFilter = i;
+			}
+
+			ImGui::EndCombo();
+		}
+
+		RefreshEntityList();
+
+		if (m_visibleEntities.size() != m_entityList.size())
+			ImGui::TextDisabled("%zu of %zu entities", m_visibleEntities.size(), m_entityList.size());
+
+		ImGui::BeginChild("EntityList");
+
+		// Only the rows in view are submitted, so drawing the list costs the same for any number of entities
+		ImGuiListClipper clipper;
+		clipper.Begin((int) m_visibleEntities.size());
+		while (clipper.Step())
+		{
+			for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; i++)
+				DrawEntityNode({ m_visibleEntities[i], m_context.get() });
+		}
+		clipper.End();
 
 		if (ImGui::IsMouseDown(0) && ImGui::IsWindowHovered())
 			m_selectionContext = {};
@@ -50,11 +190,16 @@ namespace Engine
 		if (ImGui::BeginPopupContextWindow(0, 1, false))
 		{
 			if (ImGui::MenuItem("Create empty entity"))
-				m_context->CreateEntity("Empty entity");
+			{
+				Entity entity = m_context->CreateEntity("Empty entity");
+				if (m_undoHistory)
+					m_undoHistory->RecordCreate(entity);
+			}
 
 			ImGui::EndPopup();
 		}
 
+		ImGui::EndChild();
 		ImGui::End();
 
 		// -----------------------------------------
@@ -80,13 +225,73 @@ namespace Engine
 		m_selectionContext = entity;
 	}
 
+	void SceneHierarchyPanel::RefreshEntityList()
+	{
+		ENG_PROFILE_FUNCTION();
+
+		entt::registry& registry = m_context->m_registry;
+
+		bool listChanged = m_entityListDirty;
+		if (m_entityListDirty)
+		{
+			auto view = registry.view<TagComponent>();
+			m_entityList.assign(view.begin(), view.end());
+
+			std::sort(m_entityList.begin(), m_entityList.end(), [&view] (entt::entity a, entt::entity b) {
+				const std::string& tagA = view.get<TagComponent>(a).Tag;
+				const std::string& tagB = view.get<TagComponent>(b).Tag;
+				if (tagA != tagB)
+					return tagA < tagB;
+
+				return a < b;
+				});
+
+			m_entityListDirty = false;
+		}
+
+		// Added and removed components only matter when they are filtered on
+		bool componentsChanged = m_componentsDirty && m_componentFilter >= 0;
+		m_componentsDirty = false;
+
+		std::string search = m_searchBuffer;
+		bool filterChanged = m_componentFilter != m_appliedComponentFilter;
+		if (!listChanged && !componentsChanged && !filterChanged && search == m_appliedSearch)
+			return;
+
+		auto passes = [&] (entt::entity entity) {
+			if (m_componentFilter >= 0 && !s_componentFilters[m_componentFilter].HasComponent(registry, entity))
+				return false;
+
+			return containsIgnoreCase(registry.get<TagComponent>(entity).Tag, search);
+		};
+
+		// A search that contains the previous one can only match fewer entities, so typing narrows down the last results
+		bool narrowing = !listChanged && !componentsChanged && !filterChanged && search.find(m_appliedSearch) != std::string::npos;
+		if (narrowing)
+		{
+			m_visibleEntities.erase(std::remove_if(m_visibleEntities.begin(), m_visibleEntities.end(), [&] (entt::entity entity) { return !passes(entity); }), m_visibleEntities.end());
+		} else
+		{
+			m_visibleEntities.clear();
+			for (auto entity : m_entityList)
+			{
+				if (passes(entity))
+					m_visibleEntities.push_back(entity);
+			}
+		}
+
+		m_appliedSearch = std::move(search);
+		m_appliedComponentFilter = m_componentFilter;
+	}
+
 	void SceneHierarchyPanel::DrawEntityNode(Entity entity)
 	{
-		std::string& tag = entity.GetComponent<TagComponent>();
+		const std::string& tag = entity.GetName();
 
-		ImGuiTreeNodeFlags flags = ((m_selectionContext == entity) ? ImGuiTreeNodeFlags_Selected : 0) | ImGuiTreeNodeFlags_OpenOnArrow;
+		// Rows are leaves of the same height, which the list clipper relies on
+		ImGuiTreeNodeFlags flags = ((m_selectionContext == entity) ? ImGuiTreeNodeFlags_Selected : 0) | ImGuiTreeNodeFlags_Leaf | ImGuiTreeNodeFlags_NoTreePushOnOpen;
 		flags |= ImGuiTreeNodeFlags_SpanAvailWidth;
-		bool opened = ImGui::TreeNodeEx((void*) (uint64_t) (uint32_t) entity, flags, tag.c_str());
+		ImGui::TreeNodeEx((void*) (uint64_t) (uint32_t) entity, flags, tag.c_str());
 
 		if (ImGui::IsItemClicked())
 		{
@@ -94,27 +299,44 @@ namespace Engine
 		}
 
 		bool entityDeleted = false;
+		bool createPrefab = false;
 		if (ImGui::BeginPopupContextItem())
 		{
+			if (ImGui::MenuItem("Create prefab"))
+				createPrefab = true;
+
 			if (ImGui::MenuItem("Delete entity"))
 				entityDeleted = true;
 
 			ImGui::EndPopup();
 		}
 
-		if (opened)
+		// The entity becomes the first instance of the new prefab
+		Ref<Prefab> prefab = createPrefab ? Prefab::Create(entity, makePrefabPath(tag)) : nullptr;
+		if (prefab)
 		{
-			ImGuiTreeNodeFlags flags = ImGuiTreeNodeFlags_OpenOnArrow | ImGuiTreeNodeFlags_SpanAvailWidth;
-			bool opened = ImGui::TreeNodeEx((void*) 9817239, flags, tag.c_str());
-
-			if (opened)
-				ImGui::TreePop();
-
-			ImGui::TreePop();
+			if (entity.HasComponent<PrefabInstanceComponent>())
+			{
+				PrefabInstanceComponent before = entity.GetComponent<PrefabInstanceComponent>();
+				entity.GetComponent<PrefabInstanceComponent>().Source = prefab;
+				if (m_undoHistory)
+				{
+					m_undoHistory->RecordEdit(entity, before);
+					m_undoHistory->EndMerge();
+				}
+			} else
+			{
+				entity.AddComponent<PrefabInstanceComponent>(prefab);
+				if (m_undoHistory)
+					m_undoHistory->RecordAdd<PrefabInstanceComponent>(entity);
+			}
 		}
 
 		if (entityDeleted)
 		{
+			if (m_undoHistory)
+				m_undoHistory->RecordDestroy(entity);
+
 			m_context->DestroyEntity(entity);
 
 			if (m_selectionContext == entity)
@@ -186,262 +408,483 @@ namespace Engine
 		ImGui::PopID();
 	}
 
-	template<typename T, typename UIFunction>
-	static void DrawComponent(const std::string& name, Entity entity, UIFunction uiFunction)
+	// "RestitutionThreshold" becomes "Restitution Threshold"
+	static std::string makeFieldLabel(const char* name)
 	{
-		const ImGuiTreeNodeFlags treeNodeFlags = ImGuiTreeNodeFlags_DefaultOpen | ImGuiTreeNodeFlags_Framed | ImGuiTreeNodeFlags_SpanAvailWidth | ImGuiTreeNodeFlags_AllowItemOverlap | ImGuiTreeNodeFlags_FramePadding;
-		if (entity.HasComponent<T>())
+		std::string label;
+		for (const char* c = name; *c; c++)
 		{
-			auto& component = entity.GetComponent<T>();
-			ImVec2 contentRegionAvailable = ImGui::GetContentRegionAvail();
+			if (c != name && std::isupper((unsigned char) *c) && !std::isupper((unsigned char) c[-1]))
+				label += ' ';
 
-			ImGui::PushStyleVar(ImGuiStyleVar_FramePadding, ImVec2{ 4, 4 });
-			float lineHeight = GImGui->Font->FontSize + GImGui->Style.FramePadding.y * 2.0f;
-			ImGui::Separator();
-			bool open = ImGui::TreeNodeEx((void*)typeid(T).hash_code(), treeNodeFlags, name.c_str());
-			ImGui::PopStyleVar(
-			);
-			ImGui::SameLine(contentRegionAvailable.x - lineHeight * 0.5f);
-			if (ImGui::Button("+", ImVec2{ lineHeight, lineHeight }))
-			{
-				ImGui::OpenPopup("ComponentSettings");
-			}
+			label += *c;
+		}
 
-			bool removeComponent = false;
-			if (ImGui::BeginPopup("ComponentSettings"))
+		return label;
+	}
+
+	// Draws the widget that fits the type of the field, the value is only written back when it was edited
+	template<typename Object, typename Field>
+	static void drawField(Object& object, const Field& field)
+	{
+		using Value = typename Field::ValueType;
+
+		std::string label = field.Label ? field.Label : makeFieldLabel(field.Name);
+		Value value = field.Get(object);
+		bool changed = false;
+
+		ImGui::PushID(field.Name);
+
+		if constexpr (std::is_same_v<Value, bool>)
+		{
+			changed = ImGui::Checkbox(label.c_str(), &value);
+		} else if constexpr (std::is_same_v<Value, float>)
+		{
+			if (field.Flags & FieldSlider)
+				changed = ImGui::SliderFloat(label.c_str(), &value, field.Min, field.Max);
+			else
+				changed = ImGui::DragFloat(label.c_str(), &value, field.Speed, field.Min, field.Max);
+		} else if constexpr (std::is_same_v<Value, glm::vec2>)
+		{
+			changed = ImGui::DragFloat2(label.c_str(), glm::value_ptr(value), field.Speed, field.Min, field.Max);
+		} else if constexpr (std::is_same_v<Value, glm::vec3>)
+		{
+			changed = ImGui::DragFloat3(label.c_str(), glm::value_ptr(value), field.Speed, field.Min, field.Max);
+		} else if constexpr (std::is_same_v<Value, glm::vec4>)
+		{
+			if (field.Flags & FieldColor)
+				changed = ImGui::ColorEdit4(label.c_str(), glm::value_ptr(value));
+			else
+				changed = ImGui::DragFloat4(label.c_str(), glm::value_ptr(value), field.Speed, field.Min, field.Max);
+		} else if constexpr (std::is_same_v<Value, uint16_t>)
+		{
+			bool hex = field.Flags & FieldHex;
+			changed = ImGui::InputScalar(label.c_str(), ImGuiDataType_U16, &value, nullptr, nullptr, hex ? "%04X" : "%u", hex ? ImGuiInputTextFlags_CharsHexadecimal : 0);
+		} else if constexpr (std::is_integral_v<Value>)
+		{
+			int number = (int) value;
+			if (field.Flags & FieldSlider)
+				changed = ImGui::SliderInt(label.c_str(), &number, (int) field.Min, (int) field.Max);
+			else
+				changed = ImGui::DragInt(label.c_str(), &number, field.Speed, (int) field.Min, (int) field.Max);
+
+			// Typed in values are not clamped by the widget
+			if (field.Min < field.Max)
+				number = std::clamp(number, (int) field.Min, (int) field.Max);
+			if (std::is_unsigned_v<Value>)
+				number = std::max(number, 0);
+
+			value = (Value) number;
+		} else if constexpr (std::is_enum_v<Value>)
+		{
+			if constexpr (EnumInfo<Value>::Named)
 			{
-				if (ImGui::MenuItem("Remove component"))
-					removeComponent = true;
+				const auto& names = EnumInfo<Value>::Names;
+				if (ImGui::BeginCombo(label.c_str(), names[(int) value]))
+				{
+					for (int i = 0; i < (int) std::size(names); i++)
+					{
+						bool isSelected = (int) value == i;
+						if (ImGui::Selectable(names[i], isSelected))
+						{
+							value = (Value) i;
+							changed = true;
+						}
+
+						if (isSelected)
+							ImGui::SetItemDefaultFocus();
+					}
 
-				ImGui::EndPopup();
+					ImGui::EndCombo();
+				}
 			}
+		} else if constexpr (std::is_same_v<Value, std::string>)
+		{
+			char buffer[1024];
+			memset(buffer, 0, sizeof(buffer));
+			std::strncpy(buffer, value.c_str(), sizeof(buffer) - 1);
 
-			if (open)
+			if (field.Flags & FieldMultiline)
+				changed = ImGui::InputTextMultiline(label.c_str(), buffer, sizeof(buffer));
+			else
+				changed = ImGui::InputText(label.c_str(), buffer, sizeof(buffer));
+
+			if (changed)
+				value = std::string(buffer);
+		} else if constexpr (std::is_same_v<Value, Ref<Texture2D>> || std::is_same_v<Value, Ref<Font>>)
+		{
+			std::string assetName = value ? std::filesystem::path(value->GetPath()).filename().string() : "None";
+			ImGui::Button(assetName.c_str(), ImVec2(100.0f, 0.0f));
+			if (ImGui::BeginDragDropTarget())
 			{
-				uiFunction(component);
-				ImGui::TreePop();
-			}
+				if (const ImGuiPayload* payload = ImGui::AcceptDragDropPayload("CONTENT_BROWSER_ITEM"))
+				{
+					const wchar_t* path = (const wchar_t*) payload->Data;
+					std::filesystem::path assetPath = std::filesystem::path(g_assetPath) / path;
 
-			if (removeComponent)
-				entity.RemoveComponent<T>();
+					Value asset;
+					if constexpr (std::is_same_v<Value, Ref<Texture2D>>)
+						asset = Texture2D::Create(assetPath.string());
+					else
+						asset = Font::Load(assetPath);
+
+					if (asset)
+					{
+						value = asset;
+						changed = true;
+					}
+				}
+				ImGui::EndDragDropTarget();
+			}
+			ImGui::SameLine();
+			ImGui::Text(label.c_str());
 		}
+
+		ImGui::PopID();
+
+		if (changed)
+			field.Set(object, value);
 	}
 
-	void SceneHierarchyPanel::DrawComponents(Entity entity)
+	template<typename T>
+	static void drawFields(T& object)
 	{
-		if (entity.HasComponent<TagComponent>())
-		{
-			std::string& tag = entity.GetComponent<TagComponent>();
+		ForEachField<T>([&] (const auto& field) {
+			if (!(field.Flags & FieldNotInspected))
+				drawField(object, field);
+			});
+	}
 
-			char buffer[256];
-			memset(buffer, 0, sizeof(buffer));
-			std::strncpy(buffer, tag.c_str(), sizeof(buffer));
+	// Components get the widgets of their reflected fields, the overloads below are for the ones that need more
+	template<typename T>
+	static void drawComponentProperties(T& component, Entity entity, UndoHistory* history)
+	{
+		drawFields(component);
+	}
 
-			if (ImGui::InputText("##Tag", buffer, sizeof(buffer)))
-				tag = std::string(buffer);
-		}
+	static void drawComponentProperties(TransformComponent& component, Entity entity, UndoHistory* history)
+	{
+		drawVec3Control("Translation", component.Translation);
+		glm::vec3 rotation = glm::degrees(component.Rotation);
+		drawVec3Control("Rotation", rotation);
+		component.Rotation = glm::radians(rotation);
+		drawVec3Control("Scale", component.Scale, 1.0f);
+	}
 
-		ImGui::SameLine();
-		ImGui::PushItemWidth(-1);
+	static void drawComponentProperties(CameraComponent& component, Entity entity, UndoHistory* history)
+	{
+		auto& camera = component.Camera;
 
-		if (ImGui::Button("Add component"))
-			ImGui::OpenPopup("AddComponent");
+		ImGui::Checkbox("Primary", &component.Primary);
 
-		if (ImGui::BeginPopup("AddComponent"))
+		const char* projectionTypeStrings[] = { "Perspective", "Orthographic" };
+		const char* currentProjectionTypeString = projectionTypeStrings[(int) camera.GetProjectionType()];
+
+		if (ImGui::BeginCombo("Projection", currentProjectionTypeString))
 		{
-			if (!m_selectionContext.HasComponent<CameraComponent>())
+			for (int i = 0; i < 2; i++)
 			{
-				if (ImGui::MenuItem("Camera"))
-				{
-					m_selectionContext.AddComponent<CameraComponent>();
-					ImGui::CloseCurrentPopup();
-				}
-			}
+				bool isSelected = currentProjectionTypeString == projectionTypeStrings[i];
 
-			if (!m_selectionContext.HasComponent<SpriteRendererComponent>())
-			{
-				if (ImGui::MenuItem("Sprite renderer"))
+				if (ImGui::Selectable(projectionTypeStrings[i], isSelected))
 				{
-					m_selectionContext.AddComponent<SpriteRendererComponent>();
-					ImGui::CloseCurrentPopup();
+					currentProjectionTypeString = projectionTypeStrings[i];
+					camera.SetProjectionType((SceneCamera::ProjectionType) i);
 				}
-			}
 
-			if (!m_selectionContext.HasComponent<CircleRendererComponent>())
-			{
-				if (ImGui::MenuItem("Circle renderer"))
-				{
-					m_selectionContext.AddComponent<CircleRendererComponent>();
-					ImGui::CloseCurrentPopup();
-				}
+				if (isSelected)
+					ImGui::SetItemDefaultFocus();
 			}
 
-			if (!m_selectionContext.HasComponent<Rigidbody2DComponent>())
+			ImGui::EndCombo();
+		}
+
+		if (camera.GetProjectionType() == SceneCamera::ProjectionType::Perspective)
+		{
+			float perspectiveVerticalFOV = glm::degrees(camera.GetPerspectiveVerticalFOV());
+			if (ImGui::DragFloat("Vertical FOV", &perspectiveVerticalFOV))
+				camera.SetPerspectiveVerticalFOV(glm::radians(perspectiveVerticalFOV));
+
+			float perspectiveNear = camera.GetPerspectiveNearClip();
+			if (ImGui::DragFloat("Near", &perspectiveNear))
+				camera.SetPerspectiveNearClip(perspectiveNear);
+
+			float perspectiveFar = camera.GetPerspectiveFarClip();
+			if (ImGui::DragFloat("Far", &perspectiveFar))
+				camera.SetPerspectiveFarClip(perspectiveFar);
+		}
+
+		if (camera.GetProjectionType() == SceneCamera::ProjectionType::Orthographic)
+		{
+			float orthographicSize = camera.GetOrthographicSize();
+			if (ImGui::DragFloat("Size", &orthographicSize))
+				camera.SetOrthographicSize(orthographicSize);
+
+			float orthographicNear = camera.GetOrthographicNearClip();
+			if (ImGui::DragFloat("Near", &orthographicNear))
+				camera.SetOrthographicNearClip(orthographicNear);
+
+			float orthographicFar = camera.GetOrthographicFarClip();
+			if (ImGui::DragFloat("Far", &orthographicFar))
+				camera.SetOrthographicFarClip(orthographicFar);
+
+			ImGui::Checkbox("Fixed Aspect Ratio", &component.FixedAspectRatio);
+		}
+	}
+
+	static void drawComponentProperties(StaticComponent& component, Entity entity, UndoHistory* history)
+	{
+		ImGui::TextWrapped("Sprites and circles on this entity are baked into a static batch.");
+	}
+
+	static void drawComponentProperties(PrefabInstanceComponent& component, Entity entity, UndoHistory* history)
+	{
+		if (component.Source)
+			ImGui::Text("Prefab: %s", component.Source->GetPath().filename().string().c_str());
+		else
+			ImGui::TextDisabled("Prefab: missing");
+
+		ImGui::TextWrapped("Scene files only keep the fields changed on this entity, remove the component to unlink it.");
+	}
+
+	static void drawComponentProperties(TilemapComponent& component, Entity entity, UndoHistory* history)
+	{
+		ImGui::Button("Spritesheet", ImVec2(100.0f, 0.0f));
+		if (ImGui::BeginDragDropTarget())
+		{
+			if (const ImGuiPayload* payload = ImGui::AcceptDragDropPayload("CONTENT_BROWSER_ITEM"))
 			{
-				if (ImGui::MenuItem("Rigidbody 2D"))
-				{
-					m_selectionContext.AddComponent<Rigidbody2DComponent>();
-					ImGui::CloseCurrentPopup();
-				}
+				const wchar_t* path = (const wchar_t*) payload->Data;
+				std::filesystem::path texturePath = std::filesystem::path(g_assetPath) / path;
+				component.Spritesheet = Texture2D::Create(texturePath.string());
+				component.Invalidate();
 			}
+			ImGui::EndDragDropTarget();
+		}
+
+		if (ImGui::DragFloat2("Cell Size", glm::value_ptr(component.CellSize), 1.0f, 1.0f, 4096.0f))
+			component.Invalidate();
+
+		int size[2] = { (int) component.GetWidth(), (int) component.GetHeight() };
+		if (ImGui::DragInt2("Size", size, 1.0f, 0, 4096))
+			component.Resize((uint32_t) std::max(size[0], 0), (uint32_t) std::max(size[1], 0));
 
-			if (!m_selectionContext.HasComponent<BoxCollider2DComponent>())
+		static int s_fillTile = 0;
+		ImGui::DragInt("Tile", &s_fillTile, 1.0f, 0, INT_MAX);
+		if (ImGui::Button("Fill"))
+			component.Fill(s_fillTile);
+		ImGui::SameLine();
+		if (ImGui::Button("Clear"))
+			component.Fill(TilemapComponent::EmptyTile);
+
+		// Replaces the chain collider of the tilemap with the outlines of its current tiles
+		if (ImGui::Button("Bake Collider"))
+		{
+			if (!entity.HasComponent<Rigidbody2DComponent>())
 			{
-				if (ImGui::MenuItem("Box Collider 2D"))
-				{
-					m_selectionContext.AddComponent<BoxCollider2DComponent>();
-					ImGui::CloseCurrentPopup();
-				}
+				entity.AddComponent<Rigidbody2DComponent>();
+				if (history)
+					history->RecordAdd<Rigidbody2DComponent>(entity);
 			}
 
-			if (!m_selectionContext.HasComponent<CircleCollider2DComponent>())
+			ChainCollider2DComponent chainCollider;
+			bool hadChainCollider = entity.HasComponent<ChainCollider2DComponent>();
+			if (hadChainCollider)
+				chainCollider = entity.GetComponent<ChainCollider2DComponent>();
+
+			ChainCollider2DComponent before = chainCollider;
+			chainCollider.Chains = ColliderBaker::BakeTilemap(component);
+			entity.AddOrReplaceComponent<ChainCollider2DComponent>(chainCollider);
+
+			if (history)
 			{
-				if (ImGui::MenuItem("Circle Collider 2D"))
+				if (hadChainCollider)
 				{
-					m_selectionContext.AddComponent<CircleCollider2DComponent>();
-					ImGui::CloseCurrentPopup();
+					history->RecordEdit<ChainCollider2DComponent>(entity, before);
+					history->EndMerge();
+				} else
+				{
+					history->RecordAdd<ChainCollider2DComponent>(entity);
 				}
 			}
+		}
+	}
 
-			ImGui::EndPopup();
+	static void drawComponentProperties(PolygonCollider2DComponent& component, Entity entity, UndoHistory* history)
+	{
+		int removeIndex = -1;
+		for (size_t i = 0; i < component.Vertices.size(); i++)
+		{
+			ImGui::PushID((int) i);
+			ImGui::DragFloat2("##Vertex", glm::value_ptr(component.Vertices[i]), 0.01f);
+			ImGui::SameLine();
+			if (ImGui::Button("-") && component.Vertices.size() > 3)
+				removeIndex = (int) i;
+			ImGui::PopID();
 		}
 
-		ImGui::PopItemWidth();
+		if (removeIndex >= 0)
+			component.Vertices.erase(component.Vertices.begin() + removeIndex);
 
-		DrawComponent<TransformComponent>("Transform", entity, [] (auto& component) {
-			drawVec3Control("Translation", component.Translation);
-			glm::vec3 rotation = glm::degrees(component.Rotation);
-			drawVec3Control("Rotation", rotation);
-			component.Rotation = glm::radians(rotation);
-			drawVec3Control("Scale", component.Scale, 1.0f);
-			});
+		if (component.Vertices.size() < PolygonCollider2DComponent::MaxVertices && ImGui::Button("Add Vertex"))
+			component.Vertices.push_back(component.Vertices.back());
 
-		DrawComponent<CameraComponent>("Camera", entity, [] (auto& component) {
-			auto& camera = component.Camera;
+		drawFields(component);
+	}
 
-			ImGui::Checkbox("Primary", &component.Primary);
+	static void drawComponentProperties(ChainCollider2DComponent& component, Entity entity, UndoHistory* history)
+	{
+		size_t vertexCount = 0;
+		for (const auto& chain : component.Chains)
+			vertexCount += chain.Vertices.size();
+		ImGui::Text("Chains: %d, Vertices: %d", (int) component.Chains.size(), (int) vertexCount);
 
-			const char* projectionTypeStrings[] = { "Perspective", "Orthographic" };
-			const char* currentProjectionTypeString = projectionTypeStrings[(int) camera.GetProjectionType()];
+		drawFields(component);
+	}
 
-			if (ImGui::BeginCombo("Projection", currentProjectionTypeString))
-			{
-				for (int i = 0; i < 2; i++)
-				{
-					bool isSelected = currentProjectionTypeString == projectionTypeStrings[i];
+	template<typename T, typename UIFunction>
+	static void DrawComponent(const std::string& name, Entity entity, UndoHistory* history, UIFunction uiFunction)
+	{
+		const ImGuiTreeNodeFlags treeNodeFlags = ImGuiTreeNodeFlags_DefaultOpen | ImGuiTreeNodeFlags_Framed | ImGuiTreeNodeFlags_SpanAvailWidth | ImGuiTreeNodeFlags_AllowItemOverlap | ImGuiTreeNodeFlags_FramePadding;
+		if (entity.HasComponent<T>())
+		{
+			auto& component = entity.GetComponent<T>();
+			ImVec2 contentRegionAvailable = ImGui::GetContentRegionAvail();
 
-					if (ImGui::Selectable(projectionTypeStrings[i], isSelected))
-					{
-						currentProjectionTypeString = projectionTypeStrings[i];
-						camera.SetProjectionType((SceneCamera::ProjectionType) i);
-					}
+			ImGui::PushStyleVar(ImGuiStyleVar_FramePadding, ImVec2{ 4, 4 });
+			float lineHeight = GImGui->Font->FontSize + GImGui->Style.FramePadding.y * 2.0f;
+			ImGui::Separator();
+			bool open = ImGui::TreeNodeEx((void*)typeid(T).hash_code(), treeNodeFlags, name.c_str());
+			ImGui::PopStyleVar(
+			);
+			ImGui::SameLine(contentRegionAvailable.x - lineHeight * 0.5f);
+			if (ImGui::Button("+", ImVec2{ lineHeight, lineHeight }))
+			{
+				ImGui::OpenPopup("ComponentSettings");
+			}
 
-					if (isSelected)
-						ImGui::SetItemDefaultFocus();
-				}
+			bool removeComponent = false;
+			if (ImGui::BeginPopup("ComponentSettings"))
+			{
+				if (ImGui::MenuItem("Remove component"))
+					removeComponent = true;
 
-				ImGui::EndCombo();
+				ImGui::EndPopup();
 			}
 
-			if (camera.GetProjectionType() == SceneCamera::ProjectionType::Perspective)
+			if (open)
 			{
-				float perspectiveVerticalFOV = glm::degrees(camera.GetPerspectiveVerticalFOV());
-				if (ImGui::DragFloat("Vertical FOV", &perspectiveVerticalFOV))
-					camera.SetPerspectiveVerticalFOV(glm::radians(perspectiveVerticalFOV));
+				// The copy undo goes back to. Widgets write into the component on the frame they are clicked, so it is
+				// taken before them on frames with a click, a release or a key press, and kept while the edit goes on.
+				static std::optional<T> s_before;
+				bool inUse = ImGui::IsWindowHovered(ImGuiHoveredFlags_ChildWindows) || ImGui::IsWindowFocused(ImGuiFocusedFlags_ChildWindows);
+				bool input = ImGui::IsMouseClicked(ImGuiMouseButton_Left) || ImGui::IsMouseReleased(ImGuiMouseButton_Left) ||
+					ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_Space)) || ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_Enter));
+				if (history && inUse && input && !s_before)
+					s_before = component;
+
+				ImGui::BeginGroup();
+				uiFunction(component);
+				ImGui::EndGroup();
 
-				float perspectiveNear = camera.GetPerspectiveNearClip();
-				if (ImGui::DragFloat("Near", &perspectiveNear))
-					camera.SetPerspectiveNearClip(perspectiveNear);
+				// Widgets write straight into the component, let the scene know so baked data gets rebuilt.
+				// Releasing the mouse over the group also catches buttons and drag and drop targets.
+				bool released = ImGui::IsItemHovered(ImGuiHoveredFlags_AllowWhenBlockedByActiveItem) && ImGui::IsMouseReleased(ImGuiMouseButton_Left);
+				if (ImGui::IsItemEdited() || ImGui::IsItemDeactivated() || released)
+				{
+					entity.PatchComponent<T>();
+
+					if (s_before)
+						history->RecordEdit<T>(entity, *s_before);
+				}
 
-				float perspectiveFar = camera.GetPerspectiveFarClip();
-				if (ImGui::DragFloat("Far", &perspectiveFar))
-					camera.SetPerspectiveFarClip(perspectiveFar);
+				if (!ImGui::IsItemActive())
+					s_before.reset();
+
+				ImGui::TreePop();
 			}
 
-			if (camera.GetProjectionType() == SceneCamera::ProjectionType::Orthographic)
+			if (removeComponent)
 			{
-				float orthographicSize = camera.GetOrthographicSize();
-				if (ImGui::DragFloat("Size", &orthographicSize))
-					camera.SetOrthographicSize(orthographicSize);
+				if (history)
+					history->RecordRemove<T>(entity);
 
-				float orthographicNear = camera.GetOrthographicNearClip();
-				if (ImGui::DragFloat("Near", &orthographicNear))
-					camera.SetOrthographicNearClip(orthographicNear);
+				entity.RemoveComponent<T>();
+			}
+		}
+	}
 
-				float orthographicFar = camera.GetOrthographicFarClip();
-				if (ImGui::DragFloat("Far", &orthographicFar))
-					camera.SetOrthographicFarClip(orthographicFar);
+	template<typename T>
+	void SceneHierarchyPanel::DisplayAddComponentEntry(const char* entryName)
+	{
+		if (m_selectionContext.HasComponent<T>())
+			return;
 
-				ImGui::Checkbox("Fixed Aspect Ratio", &component.FixedAspectRatio);
-			}
-			});
+		if (ImGui::MenuItem(entryName))
+		{
+			m_selectionContext.AddComponent<T>();
+			if (m_undoHistory)
+				m_undoHistory->RecordAdd<T>(m_selectionContext);
 
-		DrawComponent<SpriteRendererComponent>("Sprite renderer", entity, [] (auto& component) {
-			ImGui::ColorEdit4("Color", glm::value_ptr(component.Color));
+			ImGui::CloseCurrentPopup();
+		}
+	}
 
-			ImGui::Button("Texture", ImVec2(100.0f, 0.0f));
-			if (ImGui::BeginDragDropTarget())
+	void SceneHierarchyPanel::DrawComponents(Entity entity)
+	{
+		if (entity.HasComponent<TagComponent>())
+		{
+			if (!m_editingTag)
 			{
-				if (const ImGuiPayload* payload = ImGui::AcceptDragDropPayload("CONTENT_BROWSER_ITEM"))
-				{
-					const wchar_t* path = (const wchar_t*) payload->Data;
-					std::filesystem::path texturePath = std::filesystem::path(g_assetPath) / path;
-					component.Texture = Texture2D::Create(texturePath.string());
-				}
-				ImGui::EndDragDropTarget();
+				std::strncpy(m_tagBuffer, entity.GetName().c_str(), sizeof(m_tagBuffer) - 1);
+				m_tagEntity = entity.GetUUID();
 			}
 
-			ImGui::DragFloat("Tiling Factor", &component.TilingFactor, 0.1f, 0.0f, 100.0f);
-			});
+			ImGui::InputText("##Tag", m_tagBuffer, sizeof(m_tagBuffer));
+			m_editingTag = ImGui::IsItemActive();
 
-		DrawComponent<CircleRendererComponent>("Circle renderer", entity, [] (auto& component) {
-			ImGui::ColorEdit4("Color", glm::value_ptr(component.Color));
-			ImGui::DragFloat("Thickness", &component.Thickness, 0.025f, 0.0f, 1.0f);
-			ImGui::DragFloat("Fade", &component.Fade, 0.00025f, 0.0f, 1.0f);
-			});
-
-		DrawComponent<Rigidbody2DComponent>("Rigidbody 2D", entity, [] (auto& component) {
-			const char* bodyTypeTypeStrings[] = { "Static", "Dynamic", "Kinematic" };
-			const char* currentbodyTypeTypeString = bodyTypeTypeStrings[(int) component.Type];
-
-			if (ImGui::BeginCombo("Body Type", currentbodyTypeTypeString))
+			Entity edited = ImGui::IsItemDeactivatedAfterEdit() ? m_context->FindEntityByUUID(m_tagEntity) : Entity{};
+			if (edited)
 			{
-				for (int i = 0; i < 2; i++)
-				{
-					bool isSelected = currentbodyTypeTypeString == bodyTypeTypeStrings[i];
+				// Patched so the scene updates its name index
+				TagComponent& tag = edited.GetComponent<TagComponent>();
+				TagComponent before(tag);
+				tag.Tag = std::string(m_tagBuffer);
+				edited.PatchComponent<TagComponent>();
+				m_entityListDirty = true;
+
+				if (m_undoHistory)
+					m_undoHistory->RecordEdit<TagComponent>(edited, before);
+			}
+		}
 
-					if (ImGui::Selectable(bodyTypeTypeStrings[i], isSelected))
-					{
-						currentbodyTypeTypeString = bodyTypeTypeStrings[i];
-						component.Type = (Rigidbody2DComponent::BodyType) i;
-					}
+		ImGui::SameLine();
+		ImGui::PushItemWidth(-1);
 
-					if (isSelected)
-						ImGui::SetItemDefaultFocus();
-				}
+		if (ImGui::Button("Add component"))
+			ImGui::OpenPopup("AddComponent");
 
-				ImGui::EndCombo();
-			}
+		if (ImGui::BeginPopup("AddComponent"))
+		{
+			AllComponents::Each([this] (auto type) {
+				using T = typename decltype(type)::Type;
+				if constexpr (!(Reflection<T>::Flags & ComponentNotAddable))
+					DisplayAddComponentEntry<T>(Reflection<T>::DisplayName);
+				});
 
-			ImGui::Checkbox("Fixed Rotation", &component.FixedRotation);
-			});
+			ImGui::EndPopup();
+		}
 
-		DrawComponent<BoxCollider2DComponent>("Box Collider 2D", entity, [] (auto& component) {
-			ImGui::DragFloat2("Offset", glm::value_ptr(component.Offset));
-			ImGui::DragFloat2("Size", glm::value_ptr(component.Size));
-			ImGui::DragFloat("Density", &component.Density, 0.01f, 0.0f, 1.0f);
-			ImGui::DragFloat("Friction", &component.Friction, 0.01f, 0.0f, 1.0f);
-			ImGui::DragFloat("Restitution", &component.Restitution, 0.01f, 0.0f, 1.0f);
-			ImGui::DragFloat("Restitution Threshold", &component.RestitutionThreshold, 0.01f, 0.0f);
-			});
+		ImGui::PopItemWidth();
 
-		DrawComponent<CircleCollider2DComponent>("Circle Collider 2D", entity, [] (auto& component) {
-			ImGui::DragFloat2("Offset", glm::value_ptr(component.Offset));
-			ImGui::DragFloat("Radius", &component.Radius);
-			ImGui::DragFloat("Density", &component.Density, 0.01f, 0.0f, 1.0f);
-			ImGui::DragFloat("Friction", &component.Friction, 0.01f, 0.0f, 1.0f);
-			ImGui::DragFloat("Restitution", &component.Restitution, 0.01f, 0.0f, 1.0f);
-			ImGui::DragFloat("Restitution Threshold", &component.RestitutionThreshold, 0.01f, 0.0f);
+		AllComponents::Each([&] (auto type) {
+			using T = typename decltype(type)::Type;
+			if constexpr (!(Reflection<T>::Flags & ComponentNotInspected))
+			{
+				DrawComponent<T>(Reflection<T>::DisplayName, entity, m_undoHistory, [entity, history = m_undoHistory] (T& component) {
+					drawComponentProperties(component, entity, history);
+					});
+			}
 			});
 	}
 }
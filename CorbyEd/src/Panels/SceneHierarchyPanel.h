@@ -3,6 +3,7 @@
 #include "Engine/Core/Base.h"
 #include "Engine/Scene/Entity.h"
 #include "Engine/Scene/Scene.h"
+#include "Engine/Scene/UndoHistory.h"
 
 namespace Engine
 {
@@ -11,20 +12,49 @@ namespace Engine
 	public:
 		SceneHierarchyPanel() = default;
 		SceneHierarchyPanel(const Ref<Scene>& context);
+		~SceneHierarchyPanel();
 
 		void SetContext(const Ref<Scene>& context);
 
+		// Edits are recorded into the history, pass nullptr while they should not be undoable
+		void SetUndoHistory(UndoHistory* history) { m_undoHistory = history; }
+
 		void OnImGuiRender();
 
 		Entity GetSelectedEntity() const;
 		void SetSelectedEntity(Entity entity);
 
 	private:
+		void DisconnectContext();
+		void RefreshEntityList();
+
 		void DrawEntityNode(Entity entity);
 		void DrawComponents(Entity entity);
 
+		template<typename T>
+		void DisplayAddComponentEntry(const char* entryName);
+
 	private:
 		Ref<Scene> m_context;
 		Entity m_selectionContext;
+		UndoHistory* m_undoHistory = nullptr;
+
+		// Only rebuilt when the registry tells us something changed, the list itself is drawn clipped to the visible rows
+		std::vector<entt::entity> m_entityList; // Every entity, sorted by name
+		std::vector<entt::entity> m_visibleEntities; // The ones that pass the search and component filter
+		std::vector<entt::connection> m_connections;
+		bool m_entityListDirty = true;
+		bool m_componentsDirty = true;
+
+		// The tag is typed into a buffer of the panel and only interned once the edit is done. The entity is kept
+		// by UUID, selecting another one ends the edit on the frame it is already shown.
+		char m_tagBuffer[256] = {};
+		bool m_editingTag = false;
+		UUID m_tagEntity = 0;
+
+		char m_searchBuffer[128] = {};
+		std::string m_appliedSearch;
+		int m_componentFilter = -1;
+		int m_appliedComponentFilter = -1;
 	};
 }
@@ -0,0 +1,331 @@
+#include "engpch.h"
+#include "ThumbnailCache.h"
+
+#include <stb_image/stb_image.h>
+
+namespace Engine
+{
+	static uint64_t hashContent(const std::vector<uint8_t>& content)
+	{
+		// FNV-1a
+		uint64_t hash = 14695981039346656037ull;
+		for (uint8_t byte : content)
+		{
+			hash ^= byte;
+			hash *= 1099511628211ull;
+		}
+
+		return hash;
+	}
+
+	static bool readFile(const std::filesystem::path& path, std::vector<uint8_t>& content)
+	{
+		std::ifstream stream(path, std::ios::binary | std::ios::ate);
+		if (!stream)
+			return false;
+
+		std::streamsize size = stream.tellg();
+		if (size <= 0)
+			return false;
+
+		content.resize((size_t) size);
+		stream.seekg(0, std::ios::beg);
+		return (bool) stream.read((char*) content.data(), size);
+	}
+
+	ThumbnailCache::ThumbnailCache(const std::filesystem::path& cacheDirectory)
+		: m_cacheDirectory(cacheDirectory)
+	{
+		m_atlas = Texture2D::Create(AtlasSize, AtlasSize);
+		m_slotOwners.resize(SlotCount);
+
+		for (uint32_t i = 0; i < SlotCount; i++)
+			m_freeSlots.push_back(SlotCount - 1 - i);
+	}
+
+	ThumbnailCache::~ThumbnailCache()
+	{
+		// The jobs write into this cache
+		JobSystem::Wait(m_jobs);
+	}
+
+	bool ThumbnailCache::GetThumbnail(const std::filesystem::path& path, glm::vec2& uv0, glm::vec2& uv1)
+	{
+		std::string key = path.generic_string();
+
+		auto it = m_entries.find(key);
+		if (it == m_entries.end())
+		{
+			Entry& entry = m_entries[key];
+			ScheduleGeneration(key, path, entry);
+			return false;
+		}
+
+		// Thumbnails waiting for a slot are only uploaded while they are asked for
+		Entry& entry = it->second;
+		entry.LastUsedFrame = m_frame;
+		if (entry.Status != State::Ready)
+			return false;
+
+		// Inset by half a texel, so filtering doesn't pick up the neighbouring thumbnails
+		float texel = 1.0f / (float) AtlasSize;
+		glm::vec2 min = { (entry.Slot % SlotsPerRow) * Resolution * texel, (entry.Slot / SlotsPerRow) * Resolution * texel };
+		glm::vec2 max = min + glm::vec2(Resolution * texel);
+
+		// Flipped like every other image the editor shows
+		uv0 = { min.x + texel * 0.5f, max.y - texel * 0.5f };
+		uv1 = { max.x - texel * 0.5f, min.y + texel * 0.5f };
+		return true;
+	}
+
+	void ThumbnailCache::Invalidate(const std::filesystem::path& path)
+	{
+		std::string key = path.generic_string();
+
+		auto it = m_entries.find(key);
+		if (it == m_entries.end())
+			return;
+
+		// The old thumbnail stays up until the new one is done
+		ScheduleGeneration(key, path, it->second);
+	}
+
+	void ThumbnailCache::OnUpdate()
+	{
+		ENG_PROFILE_FUNCTION();
+
+		m_frame++;
+		UploadWaiting();
+
+		std::vector<Result> results;
+		{
+			std::lock_guard<std::mutex> lock(m_resultMutex);
+			if (m_results.empty())
+				return;
+
+			// Spread the uploads over several frames when a big folder opens
+			uint32_t count = std::min((uint32_t) m_results.size(), MaxUploadsPerFrame);
+			results.assign(std::make_move_iterator(m_results.begin()), std::make_move_iterator(m_results.begin() + count));
+			m_results.erase(m_results.begin(), m_results.begin() + count);
+		}
+
+		for (auto& result : results)
+		{
+			auto it = m_entries.find(result.Key);
+			if (it == m_entries.end() || it->second.Request != result.Request)
+				continue;
+
+			Entry& entry = it->second;
+			if (result.Pixels.empty())
+			{
+				if (entry.Status == State::Ready)
+				{
+					m_slotOwners[entry.Slot].clear();
+					m_freeSlots.push_back(entry.Slot);
+				}
+
+				entry.Status = State::Failed;
+				continue;
+			}
+
+			if (entry.Status != State::Ready)
+			{
+				if (!AcquireSlot(entry.Slot))
+				{
+					// Every slot is on screen, the pixels wait until something scrolls out of view
+					if (entry.Status != State::WaitingForSlot)
+						m_waitingForSlot.push_back(result.Key);
+
+					entry.Status = State::WaitingForSlot;
+					entry.Pixels = std::move(result.Pixels);
+					continue;
+				}
+
+				m_slotOwners[entry.Slot] = result.Key;
+			}
+
+			Upload(entry, result.Pixels);
+		}
+	}
+
+	void ThumbnailCache::Upload(Entry& entry, const std::vector<uint8_t>& pixels)
+	{
+		uint32_t x = (entry.Slot % SlotsPerRow) * Resolution;
+		uint32_t y = (entry.Slot / SlotsPerRow) * Resolution;
+		m_atlas->SetData((void*) pixels.data(), x, y, Resolution, Resolution);
+
+		// The pixels may be the ones the entry kept while it waited
+		entry.Pixels = std::vector<uint8_t>();
+		entry.Status = State::Ready;
+		entry.LastUsedFrame = m_frame;
+	}
+
+	void ThumbnailCache::UploadWaiting()
+	{
+		uint32_t uploads = 0;
+		bool slotsLeft = true;
+		for (size_t i = 0; i < m_waitingForSlot.size();)
+		{
+			auto it = m_entries.find(m_waitingForSlot[i]);
+			bool waiting = it != m_entries.end() && it->second.Status == State::WaitingForSlot;
+
+			// Not asked for in the last frame, it is generated again when it comes back into view
+			if (waiting && it->second.LastUsedFrame + 1 < m_frame)
+			{
+				m_entries.erase(it);
+				waiting = false;
+			}
+
+			if (waiting && slotsLeft && uploads < MaxUploadsPerFrame)
+			{
+				Entry& entry = it->second;
+				slotsLeft = AcquireSlot(entry.Slot);
+				if (slotsLeft)
+				{
+					m_slotOwners[entry.Slot] = it->first;
+					Upload(entry, entry.Pixels);
+					uploads++;
+					waiting = false;
+				}
+			}
+
+			if (waiting)
+			{
+				i++;
+			} else
+			{
+				m_waitingForSlot[i] = std::move(m_waitingForSlot.back());
+				m_waitingForSlot.pop_back();
+			}
+		}
+	}
+
+	bool ThumbnailCache::IsImage(const std::filesystem::path& path)
+	{
+		std::string extension = path.extension().string();
+		std::transform(extension.begin(), extension.end(), extension.begin(), [] (char c) { return (char) std::tolower((unsigned char) c); });
+
+		return extension == ".png" || extension == ".jpg" || extension == ".jpeg" || extension == ".bmp" || extension == ".tga";
+	}
+
+	void ThumbnailCache::ScheduleGeneration(const std::string& key, const std::filesystem::path& path, Entry& entry)
+	{
+		uint64_t request = m_nextRequest++;
+		entry.Request = request;
+
+		JobSystem::Schedule([this, key, path, request] () {
+			std::vector<uint8_t> pixels = Generate(path, m_cacheDirectory);
+
+			std::lock_guard<std::mutex> lock(m_resultMutex);
+			m_results.push_back({ key, request, std::move(pixels) });
+			}, &m_jobs, nullptr, "ThumbnailCache::Generate");
+	}
+
+	bool ThumbnailCache::AcquireSlot(uint32_t& slot)
+	{
+		if (!m_freeSlots.empty())
+		{
+			slot = m_freeSlots.back();
+			m_freeSlots.pop_back();
+			return true;
+		}
+
+		// Evict the thumbnail that was drawn the longest time ago. Uploads run before the panel draws, so what was
+		// drawn in the previous frame is still on screen and stays along with anything drawn in this one.
+		uint32_t oldest = SlotCount;
+		uint64_t oldestFrame = m_frame - 1;
+		for (uint32_t i = 0; i < SlotCount; i++)
+		{
+			uint64_t lastUsed = m_entries[m_slotOwners[i]].LastUsedFrame;
+			if (lastUsed < oldestFrame)
+			{
+				oldest = i;
+				oldestFrame = lastUsed;
+			}
+		}
+
+		if (oldest == SlotCount)
+			return false;
+
+		m_entries.erase(m_slotOwners[oldest]);
+		m_slotOwners[oldest].clear();
+
+		slot = oldest;
+		return true;
+	}
+
+	std::vector<uint8_t> ThumbnailCache::Generate(const std::filesystem::path& path, const std::filesystem::path& cacheDirectory)
+	{
+		ENG_PROFILE_FUNCTION();
+
+		const size_t thumbnailSize = Resolution * Resolution * 4;
+
+		std::vector<uint8_t> content;
+		if (!readFile(path, content))
+			return {};
+
+		char filename[32];
+		snprintf(filename, sizeof(filename), "%016llx.thumb", (unsigned long long) hashContent(content));
+		std::filesystem::path cachePath = cacheDirectory / filename;
+
+		std::vector<uint8_t> pixels;
+		if (readFile(cachePath, pixels) && pixels.size() == thumbnailSize)
+			return pixels;
+
+		int width, height, channels;
+		stbi_set_flip_vertically_on_load_thread(1);
+		stbi_uc* data = stbi_load_from_memory(content.data(), (int) content.size(), &width, &height, &channels, 4);
+		if (!data)
+			return {};
+
+		// Fit the image into the thumbnail and center it, every destination pixel averages the source pixels it covers.
+		// Images smaller than the thumbnail are scaled up, which picks the nearest pixel.
+		float scale = std::min((float) Resolution / (float) width, (float) Resolution / (float) height);
+		uint32_t scaledWidth = std::max(1u, (uint32_t) (width * scale));
+		uint32_t scaledHeight = std::max(1u, (uint32_t) (height * scale));
+		uint32_t offsetX = (Resolution - scaledWidth) / 2;
+		uint32_t offsetY = (Resolution - scaledHeight) / 2;
+
+		pixels.assign(thumbnailSize, 0);
+		for (uint32_t y = 0; y < scaledHeight; y++)
+		{
+			uint32_t y0 = std::min((uint32_t) (y / scale), (uint32_t) height - 1);
+			uint32_t y1 = std::max(y0 + 1, std::min((uint32_t) ((y + 1) / scale), (uint32_t) height));
+
+			for (uint32_t x = 0; x < scaledWidth; x++)
+			{
+				uint32_t x0 = std::min((uint32_t) (x / scale), (uint32_t) width - 1);
+				uint32_t x1 = std::max(x0 + 1, std::min((uint32_t) ((x + 1) / scale), (uint32_t) width));
+
+				uint32_t sum[4] = {};
+				for (uint32_t sy = y0; sy < y1; sy++)
+				{
+					for (uint32_t sx = x0; sx < x1; sx++)
+					{
+						const stbi_uc* source = data + ((size_t) sy * width + sx) * 4;
+						for (uint32_t c = 0; c < 4; c++)
+							sum[c] += source[c];
+					}
+				}
+
+				uint32_t count = (x1 - x0) * (y1 - y0);
+				uint8_t* destination = pixels.data() + ((size_t) (offsetY + y) * Resolution + offsetX + x) * 4;
+				for (uint32_t c = 0; c < 4; c++)
+					destination[c] = (uint8_t) (sum[c] / count);
+			}
+		}
+
+		stbi_image_free(data);
+
+		std::error_code error;
+		std::filesystem::create_directories(cacheDirectory, error);
+
+		std::ofstream stream(cachePath, std::ios::binary);
+		if (stream)
+			stream.write((const char*) pixels.data(), pixels.size());
+		else
+			ENG_WARN("Could not write thumbnail cache file '{0}'", cachePath.string());
+
+		return pixels;
+	}
+}
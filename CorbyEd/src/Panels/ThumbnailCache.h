@@ -0,0 +1,83 @@
+#pragma once
+
+#include "Engine/Core/JobSystem.h"
+#include "Engine/Renderer/Texture.h"
+
+#include <filesystem>
+#include <glm/glm.hpp>
+
+namespace Engine
+{
+	// Image previews for the content browser. Thumbnails are decoded and downscaled on the job system, stored on disk
+	// by the hash of the file content and packed into one atlas texture, where the least recently drawn ones make room.
+	class ThumbnailCache
+	{
+	public:
+		ThumbnailCache(const std::filesystem::path& cacheDirectory);
+		~ThumbnailCache();
+
+		// Starts generating the thumbnail the first time it is asked for, until it is ready the call returns false
+		bool GetThumbnail(const std::filesystem::path& path, glm::vec2& uv0, glm::vec2& uv1);
+
+		// Regenerates the thumbnail of a file that changed on disk
+		void Invalidate(const std::filesystem::path& path);
+
+		// Uploads finished thumbnails to the atlas, call once per frame
+		void OnUpdate();
+
+		const Ref<Texture2D>& GetAtlas() const { return m_atlas; }
+
+		static bool IsImage(const std::filesystem::path& path);
+
+	public:
+		static constexpr uint32_t Resolution = 128;
+		static constexpr uint32_t AtlasSize = 2048;
+		static constexpr uint32_t SlotsPerRow = AtlasSize / Resolution;
+		static constexpr uint32_t SlotCount = SlotsPerRow * SlotsPerRow;
+		static constexpr uint32_t MaxUploadsPerFrame = 8;
+
+	private:
+		enum class State
+		{
+			Loading, WaitingForSlot, Ready, Failed
+		};
+
+		struct Entry
+		{
+			State Status = State::Loading;
+			uint32_t Slot = 0;
+			uint64_t Request = 0;
+			uint64_t LastUsedFrame = 0;
+			std::vector<uint8_t> Pixels; // Kept while waiting for a slot
+		};
+
+		struct Result
+		{
+			std::string Key;
+			uint64_t Request;
+			std::vector<uint8_t> Pixels; // Empty when the file could not be read
+		};
+
+		void ScheduleGeneration(const std::string& key, const std::filesystem::path& path, Entry& entry);
+		bool AcquireSlot(uint32_t& slot);
+		void Upload(Entry& entry, const std::vector<uint8_t>& pixels);
+		void UploadWaiting();
+
+		static std::vector<uint8_t> Generate(const std::filesystem::path& path, const std::filesystem::path& cacheDirectory);
+
+	private:
+		std::filesystem::path m_cacheDirectory;
+		Ref<Texture2D> m_atlas;
+
+		std::unordered_map<std::string, Entry> m_entries;
+		std::vector<std::string> m_slotOwners;
+		std::vector<uint32_t> m_freeSlots;
+		std::vector<std::string> m_waitingForSlot;
+		uint64_t m_frame = 0;
+		uint64_t m_nextRequest = 1;
+
+		std::mutex m_resultMutex;
+		std::vector<Result> m_results;
+		JobCounter m_jobs;
+	};
+}
@@ -19,7 +19,8 @@ project "Sandbox"
 		"%{wks.location}/Corby/src",
 		"%{wks.location}/Corby/vendor",
 		"%{IncludeDir.glm}",
-		"%{IncludeDir.entt}"
+		"%{IncludeDir.entt}",
+		"%{IncludeDir.yaml_cpp}"
 	}
 
 	links
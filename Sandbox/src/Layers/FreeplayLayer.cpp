@@ -5,7 +5,9 @@
 #include <imgui/imgui.h>
 
 Freeplay::Freeplay() : Layer("Freeplay"), m_cameraController(1280.0f / 720.0f)
-{}
+{
+	m_cameraController.Subscribe(*this);
+}
 
 void Freeplay::OnAttach()
 {
@@ -63,8 +65,3 @@ void Freeplay::OnImGuiRender()
 
 	ImGui::End();
 }
-
-void Freeplay::OnEvent(Engine::Event& e)
-{
-	m_cameraController.OnEvent(e);
-}
@@ -13,7 +13,6 @@ public:
 
 	void OnUpdate(Engine::Timestep ts) override;
 	virtual void OnImGuiRender() override;
-	void OnEvent(Engine::Event& e) override;
 
 private:
 	Engine::CameraController m_cameraController;
@@ -6,7 +6,9 @@
 
 Sandbox2D::Sandbox2D()
 	: Layer("Sandbox2D"), m_cameraController(1280.0f / 720.0f)
-{}
+{
+	m_cameraController.Subscribe(*this);
+}
 
 void Sandbox2D::OnAttach()
 {
@@ -73,8 +75,3 @@ void Sandbox2D::OnImGuiRender()
 	ImGui::End();
 
 }
-
-void Sandbox2D::OnEvent(Engine::Event& e)
-{
-	m_cameraController.OnEvent(e);
-}
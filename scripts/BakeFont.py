@@ -0,0 +1,41 @@
+import os
+import subprocess
+import sys
+
+# Bakes an MSDF atlas (.png) and glyph layout (.json) next to a .ttf file, ready to be loaded by Engine::Font.
+# Requires msdf-atlas-gen (https://github.com/Chlumsky/msdf-atlas-gen) to be available on the PATH.
+#
+# Usage: python BakeFont.py <font.ttf> [glyph size in pixels]
+
+PX_RANGE = 2 # Must match c_PxRange in 2DText.glsl
+
+def BakeFont(fontPath, glyphSize):
+    fontPath = os.path.abspath(fontPath)
+    stem = os.path.splitext(fontPath)[0]
+
+    print(f"Baking {fontPath}...")
+    result = subprocess.call([
+        "msdf-atlas-gen",
+        "-font", fontPath,
+        "-type", "msdf",
+        "-format", "png",
+        "-imageout", f"{stem}.png",
+        "-json", f"{stem}.json",
+        "-size", str(glyphSize),
+        "-pxrange", str(PX_RANGE),
+        "-yorigin", "bottom"
+    ])
+
+    if result != 0:
+        print("msdf-atlas-gen failed, is it installed and on the PATH?")
+        return False
+
+    return True
+
+if __name__ == "__main__":
+    if len(sys.argv) < 2:
+        print("Usage: python BakeFont.py <font.ttf> [glyph size in pixels]")
+        sys.exit(1)
+
+    size = int(sys.argv[2]) if len(sys.argv) > 2 else 40
+    sys.exit(0 if BakeFont(sys.argv[1], size) else 1)